@@ -43,14 +43,14 @@ public:
 class CloseDoor : public ChangeEvent<bool>
 {
 public:
-  CloseDoor() : ChangeEvent<bool>()
+  CloseDoor(const Variable<bool> &in_door_opened) : ChangeEvent<bool>()
   {
-    add("close door", false);
+    bind("door opened", in_door_opened);
   }
 
   bool happened() const
   {
-    return value("close door");
+    return !value("door opened");
   }
 };
 
@@ -58,14 +58,14 @@ public:
 class OpenDoor : public ChangeEvent<bool>
 {
 public:
-  OpenDoor() : ChangeEvent<bool>()
+  OpenDoor(const Variable<bool> &in_door_opened) : ChangeEvent<bool>()
   {
-    add("open door", false);
+    bind("door opened", in_door_opened);
   }
 
   bool happened() const
   {
-    return value("open door");
+    return value("door opened");
   }
 };
 
@@ -79,6 +79,9 @@ public:
   // Building of the machine.
   bool build()
   {
+    // Declaring the variable "Door opened" of the machine, which triggers the door and the interior lamp.
+    this->_doorOpened = this->declare("Door opened", false);
+    
     // Adding a new region named "Car" in the machine.
     this->newRegion("Car");
 
@@ -107,21 +110,17 @@ public:
 
     // Adding a triggered transition from the state "Door closed" to the state "Door opened".
     auto k2 = std::make_shared<Transition>("k2", "Door closed", "Door opened");
-    this->_openDoor = std::make_shared<OpenDoor>();
-    k2->setTrigger(this->_openDoor);
+    k2->setTrigger(std::make_shared<OpenDoor>(this->_doorOpened));
     this->addTransition(k2);
 
     // Adding a triggered transition from the state "Door opened" to the state "Door closed".
     auto k3 = std::make_shared<Transition>("k3", "Door opened", "Door closed");
-    this->_closeDoor = std::make_shared<CloseDoor>();
-    k3->setTrigger(this->_closeDoor);
+    k3->setTrigger(std::make_shared<CloseDoor>(this->_doorOpened));
     this->addTransition(k3);
 
-    // Building the car's interior lamp machine
-    LampMachine lamp_machine;
+    // Building the car's interior lamp machine, switched ON when the door is opened.
+    LampMachine lamp_machine(this->_doorOpened);
     lamp_machine.build();
-    this->_switchLampOff = lamp_machine.switchOff;
-    this->_switchLampOn = lamp_machine.switchOn;
 
     // Adding the lamp machine as a submachine in the region "Interior lamp" of the state "Car parked".
     this->addSubmachine("Interior lamp", lamp_machine);
@@ -135,30 +134,21 @@ public:
     return true;
   }
 
-  // Method that trigger the events to open the car's door.
+  // Method that opens the car's door.
   void openDoor()
   {
-    this->_closeDoor->switching("close door", false);
-    this->_openDoor->switching("open door", true);    
-    this->_switchLampOff->switching("switch OFF", false);
-    this->_switchLampOn->switching("switch ON", true);
+    this->_doorOpened.set(true);
   }
 
-  // Method that trigger the events to close the car's door.
+  // Method that closes the car's door.
   void closeDoor()
   {
-    this->_closeDoor->switching("close door", true);
-    this->_openDoor->switching("open door", false);    
-    this->_switchLampOff->switching("switch OFF", true);
-    this->_switchLampOn->switching("switch ON", false);
+    this->_doorOpened.set(false);
   }
   
 
-  // Triggers.
-  std::shared_ptr<SwitchOFF> _switchLampOff;
-  std::shared_ptr<SwitchON> _switchLampOn;
-  std::shared_ptr<CloseDoor> _closeDoor;
-  std::shared_ptr<OpenDoor> _openDoor;
+  // Variable that triggers the events of the door and of the interior lamp.
+  Variable<bool> _doorOpened;
 };
 
 
@@ -20,8 +20,7 @@ int main(void)
   for (int i = 0; i < 5; i++)
     {
       // switching ON
-      lamp_machine.switchOn->switching("switch ON", true);
-      lamp_machine.switchOff->switching("switch OFF", false);
+      lamp_machine.switchedOn.set(true);
       if (!lamp_machine.run())
 	{
 	  std::cout << "example_lamp1: run failed." << std::endl;
@@ -30,8 +29,7 @@ int main(void)
       std::cout << std::endl;
 
       // switching OFF
-      lamp_machine.switchOn->switching("switch ON", false);
-      lamp_machine.switchOff->switching("switch OFF", true);
+      lamp_machine.switchedOn.set(false);
       if (!lamp_machine.run())
 	{
 	  std::cout << "example_lamp1: run failed." << std::endl;
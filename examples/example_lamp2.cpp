@@ -1,4 +1,5 @@
 #include <machine.hpp>
+#include <eventloop.hpp>
 
 #include <string>
 #include <memory>
@@ -89,8 +90,9 @@ public:
     auto trigger1 = std::make_shared<TimeEvent>();
 
     // Setting the duration before triggering at 2s with a margin of 200ms.
-    // If the machine won't change of state, you must increase the margin.
+    // If the machine is run after the margin, the transition is fired late.
     trigger1->after(std::make_shared<DateTime>(0, 0, 0, 0, 2, 0), std::make_shared<DateTime>(0, 0, 0, 0, 0, 200000));
+    trigger1->setMissPolicy(MissPolicy::FireLate);
 
     // Adding a transition from state "Lamp OFF" to state "Lamp ON" with the trigger defined.
     auto t1 = std::make_shared<Transition>("t1", "Lamp OFF", "Lamp ON");
@@ -107,8 +109,9 @@ public:
     auto trigger2 = std::make_shared<TimeEvent>();
 
     // Setting the duration before triggering at 1s with a margin of 200ms.
-    // If the machine won't change of state, you must increase the margin.
+    // If the machine is run after the margin, the transition is fired late.
     trigger2->after(std::make_shared<DateTime>(0, 0, 0, 0, 1, 0), std::make_shared<DateTime>(0, 0, 0, 0, 1, 200000));
+    trigger2->setMissPolicy(MissPolicy::FireLate);
 
     // Adding a transition from state "Lamp ON" to state "Lamp OFF" with the trigger defined.
     auto t3 = std::make_shared<Transition>("t3", "Lamp ON", "Lamp OFF");
@@ -147,10 +150,20 @@ int main(void)
   std::cout << "Automaton that automatically switches a lamp (2s OFF and 1s ON) during 10s." << std::endl << std::endl;
 
   // Run the machine until the state "Final" is reached.
+#ifdef EPOLL_EVENT_LOOP
+  // The loop sleeps until the next TimeEvent of the machine instead of running it continuously.
+  EventLoop loop;
+  loop.add(machine);
+  while (machine.activeState("lamp") != std::string("Final"))
+    {
+      loop.poll(-1);
+    }
+#else
   while (machine.activeState("lamp") != std::string("Final"))
     {
       machine.run();
     }
+#endif
 #else
   std::cout << "example_lamp2: time not supported." << std::endl;
 #endif
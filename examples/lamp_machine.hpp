@@ -47,17 +47,18 @@ public:
 };
 
 // Definition of the event that trigger the Lamp from ON to OFF.
+// The attribute "switched ON" is bound to a variable of the machine.
 class SwitchOFF : public ChangeEvent<bool>
 {
 public:
-  SwitchOFF() : ChangeEvent<bool>()
+  SwitchOFF(const Variable<bool> &in_switched_on) : ChangeEvent<bool>()
   {
-    add("switch OFF", false);
+    bind("switched ON", in_switched_on);
   }
 
   bool happened() const
   {
-    return value("switch OFF");
+    return !value("switched ON");
   }
 };
 
@@ -65,14 +66,14 @@ public:
 class SwitchON : public ChangeEvent<bool>
 {
 public:
-  SwitchON() : ChangeEvent<bool>()
+  SwitchON(const Variable<bool> &in_switched_on) : ChangeEvent<bool>()
   {
-    add("switch ON", false);
+    bind("switched ON", in_switched_on);
   }
 
   bool happened() const
   {
-    return value("switch ON");
+    return value("switched ON");
   }
 };
 
@@ -81,11 +82,16 @@ class LampMachine : public Machine
 {
 public:
   LampMachine() : Machine("Lamp machine") {}  
+  // Constructor of a lamp switched by the variable of another machine.
+  LampMachine(const Variable<bool> &in_switched_on) : Machine("Lamp machine"), switchedOn(in_switched_on) {}  
   virtual ~LampMachine() {}
 
   // Building of the machine.
   bool build()
   {
+    // Declaring the variable "Lamp switched ON" of the machine, if the lamp isn't switched by another machine.
+    if (!switchedOn.isValid()) switchedOn = this->declare("Lamp switched ON", false);
+
     // Adding a new region named "lamp" in the machine.
     this->newRegion("Lamp");
 
@@ -103,21 +109,18 @@ public:
 
     // Adding a triggered transition named "t1" from state "Lamp OFF" to the state "Lamp ON".
     auto t1 = std::make_shared<Transition>("t1", "Lamp OFF", "Lamp ON");
-    switchOn = std::make_shared<SwitchON>();
-    t1->setTrigger(switchOn);
+    t1->setTrigger(std::make_shared<SwitchON>(switchedOn));
     this->addTransition(t1);
 
     // Adding a triggered transition named "t2" from state "Lamp ON" to the state "Lamp OFF".
     auto t2 = std::make_shared<Transition>("t2", "Lamp ON", "Lamp OFF");
-    switchOff = std::make_shared<SwitchOFF>();
-    t2->setTrigger(switchOff);
+    t2->setTrigger(std::make_shared<SwitchOFF>(switchedOn));
     this->addTransition(t2);
   
     return true;
   }
 
-  // Triggers.
-  std::shared_ptr<SwitchOFF> switchOff;
-  std::shared_ptr<SwitchON> switchOn;
+  // Variable switching the lamp.
+  Variable<bool> switchedOn;
   
 }; // That's all!
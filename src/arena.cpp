@@ -0,0 +1,91 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "arena.hpp"
+
+#include <new> // operator new
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  Arena
+*/
+
+// -----------------------------------------------------------------------------------
+Arena::Arena(std::size_t in_chunk_size) : _chunkSize(in_chunk_size), _current(nullptr), _remaining(0), _used(0)
+{
+}
+
+// -----------------------------------------------------------------------------------
+Arena::~Arena()
+{
+  for (auto it = this->_chunks.begin(); it != this->_chunks.end(); it++)
+    ::operator delete(*it);
+}
+
+// -----------------------------------------------------------------------------------
+void *Arena::allocate(std::size_t in_size, std::size_t in_alignment)
+{
+  std::size_t padding = reinterpret_cast<std::size_t>(this->_current) % in_alignment;
+  if (padding != 0) padding = in_alignment - padding;
+  
+  if (!this->_current || padding + in_size > this->_remaining)
+    {
+      // Chunks returned by operator new are suitably aligned for any type.
+      this->newChunk(in_size > this->_chunkSize ? in_size : this->_chunkSize);
+      padding = 0;
+    }
+  
+  void *block = this->_current + padding;
+  this->_current += padding + in_size;
+  this->_remaining -= padding + in_size;
+  this->_used += in_size;
+  return block;
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t Arena::chunks() const
+{
+  return this->_chunks.size();
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t Arena::used() const
+{
+  return this->_used;
+}
+
+// -----------------------------------------------------------------------------------
+void Arena::newChunk(std::size_t in_size)
+{
+  char *chunk = static_cast<char *>(::operator new(in_size));
+  this->_chunks.push_back(chunk);
+  this->_current = chunk;
+  this->_remaining = in_size;
+}
@@ -0,0 +1,133 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef> // size_t
+#include <vector>
+#include <memory>
+
+namespace fisa
+{
+  //#########################################################################################################
+  /*
+    Arena
+  */
+  //! Monotonic memory resource in which the object graph of a machine can be allocated.
+  /**
+   * Memory is taken from large contiguous chunks and is never given back individually: 
+   * all chunks are released at once when the arena is destroyed.
+   * An arena is not thread-safe, it is meant to be filled while the machine is built.
+   **/
+
+  class Arena
+  {
+  public:
+    //! Construct an arena that reserves chunks of the size, in bytes, specified in argument.
+    Arena(std::size_t in_chunk_size = 65536);
+
+    //! Destructor. Releases all chunks.
+    ~Arena();
+
+    //! Returns a memory block of the size and alignment specified in arguments.
+    void *allocate(std::size_t in_size, std::size_t in_alignment);
+
+    //! Returns the number of chunks reserved by the arena.
+    std::size_t chunks() const;
+
+    //! Returns the number of bytes handed out by the arena.
+    std::size_t used() const;
+
+  private:
+    Arena(const Arena &in_arena);
+    Arena& operator = (const Arena &in_arena);
+
+    void newChunk(std::size_t in_size);
+
+    std::vector<char *> _chunks;
+    std::size_t _chunkSize;
+    char *_current;
+    std::size_t _remaining;
+    std::size_t _used;
+  };
+
+  //#########################################################################################################
+  /*
+    ArenaAllocator
+  */
+  //! Standard allocator that takes its memory from an Arena.
+  /**
+   * Each copy of the allocator shares the ownership of the arena, so that the arena lives 
+   * as long as an object allocated in it (eg: with "std::allocate_shared") is alive.
+   * Deallocation does nothing, the memory is released with the arena.
+   **/
+
+  template<typename T>
+  class ArenaAllocator
+  {
+  public:
+    typedef T value_type;
+
+    //! Construct an allocator on the arena specified in argument.
+    ArenaAllocator(std::shared_ptr<Arena> in_arena) : _arena(in_arena) {}
+
+    //! Converting constructor.
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &in_allocator) : _arena(in_allocator.arena()) {}
+
+    //! Allocates memory for "in_number" objects of type T.
+    T *allocate(std::size_t in_number)
+    {
+      return static_cast<T *>(this->_arena->allocate(in_number * sizeof(T), alignof(T)));
+    }
+
+    //! Nothing to do, the memory is released with the arena.
+    void deallocate(T *in_pointer, std::size_t in_number) {}
+
+    //! Returns the arena.
+    std::shared_ptr<Arena> arena() const {return this->_arena;}
+
+  private:
+    std::shared_ptr<Arena> _arena;
+  };
+
+  template<typename T, typename U>
+  bool operator == (const ArenaAllocator<T> &in_left, const ArenaAllocator<U> &in_right)
+  {
+    return in_left.arena() == in_right.arena();
+  }
+
+  template<typename T, typename U>
+  bool operator != (const ArenaAllocator<T> &in_left, const ArenaAllocator<U> &in_right)
+  {
+    return !(in_left == in_right);
+  }
+}
+
+#endif
@@ -0,0 +1,402 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef CALLBACKS_HPP
+#define CALLBACKS_HPP
+
+#include "symbols.hpp"
+#include "frames.hpp"
+
+#include <atomic>
+#include <cstddef> // size_t, max_align_t
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new> // placement new
+#include <type_traits>
+#include <unordered_map>
+#include <utility> // move, forward
+#include <vector>
+
+namespace fisa
+{
+  //#########################################################################################################
+  /*
+    Callback
+  */
+  //! Function object without argument, stored in a small buffer.
+  /**
+   * Any callable object can be stored (eg: a lambda, a function pointer). Objects not larger 
+   * than three pointers, and that can be moved without exception, are stored inside the 
+   * callback without allocation; the others are allocated on the heap. Calling the callback 
+   * is a direct call through a function pointer, without virtual dispatch. Callable objects 
+   * must be copyable; moving a callback never throws nor reallocates.
+   **/
+
+  class Callback
+  {
+  public:
+    //! Construct an empty callback.
+    Callback() : _invoke(nullptr), _manage(nullptr) {}
+
+    //! Construct a callback that stores the callable object specified in argument.
+    template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Callback>::value>::type>
+    Callback(F &&in_function)
+    {
+      typedef typename std::decay<F>::type Function;
+      static_assert(std::is_copy_constructible<Function>::value, "Callbacks must be copyable, wrap a move-only object in a std::shared_ptr.");
+      typedef typename std::conditional<Callback::isInline<Function>(), Inline<Function>, Heap<Function> >::type Storage;
+      Storage::create(this->_buffer, std::forward<F>(in_function));
+      this->_invoke = &Storage::invoke;
+      this->_manage = &Storage::manage;
+    }
+
+    //! Copy constructor.
+    Callback(const Callback &in_callback) : _invoke(in_callback._invoke), _manage(in_callback._manage)
+    {
+      if (this->_manage) this->_manage(Operation::Copy, this->_buffer, const_cast<Buffer&>(in_callback._buffer));
+    }
+
+    //! Move constructor.
+    Callback(Callback &&in_callback) noexcept : _invoke(in_callback._invoke), _manage(in_callback._manage)
+    {
+      if (this->_manage) this->_manage(Operation::Move, this->_buffer, in_callback._buffer);
+      in_callback._invoke = nullptr;
+      in_callback._manage = nullptr;
+    }
+
+    //! Assignment operator.
+    Callback& operator = (const Callback &in_callback)
+    {
+      if (this != &in_callback) *this = Callback(in_callback);
+      return *this;
+    }
+
+    //! Move assignment operator.
+    Callback& operator = (Callback &&in_callback) noexcept
+    {
+      if (this == &in_callback) return *this;
+      this->reset();
+      this->_invoke = in_callback._invoke;
+      this->_manage = in_callback._manage;
+      if (this->_manage) this->_manage(Operation::Move, this->_buffer, in_callback._buffer);
+      in_callback._invoke = nullptr;
+      in_callback._manage = nullptr;
+      return *this;
+    }
+
+    //! Destructor.
+    ~Callback() {this->reset();}
+
+    //! Returns true if a callable object is stored.
+    explicit operator bool() const {return this->_invoke != nullptr;}
+
+    //! Calls the stored callable object, which must exist.
+    void operator () () const {this->_invoke(this->_buffer);}
+
+    //! Returns true if the callable object of type F is stored without allocation.
+    template<typename F>
+    static constexpr bool isInline()
+    {
+      return sizeof(F) <= BufferSize && alignof(F) <= alignof(std::max_align_t) &&
+	std::is_nothrow_move_constructible<F>::value;
+    }
+
+  private:
+    static const std::size_t BufferSize = 3 * sizeof(void*);
+    typedef typename std::aligned_storage<BufferSize, alignof(std::max_align_t)>::type Buffer;
+    enum class Operation {Copy, Move, Destroy};
+    
+    //! Storage of a callable object inside the buffer.
+    template<typename F>
+    struct Inline
+    {
+      template<typename G>
+      static void create(Buffer &out_buffer, G &&in_function) {new (&out_buffer) F(std::forward<G>(in_function));}
+      static void invoke(Buffer &io_buffer) {(*reinterpret_cast<F*>(&io_buffer))();}
+      static void manage(Operation in_operation, Buffer &io_buffer, Buffer &io_other)
+      {
+	switch (in_operation)
+	  {
+	  case Operation::Copy: Callback::copy(&io_buffer, *reinterpret_cast<const F*>(&io_other), std::is_copy_constructible<F>()); break;
+	  case Operation::Move:
+	    new (&io_buffer) F(std::move(*reinterpret_cast<F*>(&io_other)));
+	    reinterpret_cast<F*>(&io_other)->~F();
+	    break;
+	  case Operation::Destroy: reinterpret_cast<F*>(&io_buffer)->~F(); break;
+	  }
+      }
+    };
+
+    //! Storage of a callable object on the heap, the buffer holds its address.
+    template<typename F>
+    struct Heap
+    {
+      template<typename G>
+      static void create(Buffer &out_buffer, G &&in_function) {*reinterpret_cast<F**>(&out_buffer) = new F(std::forward<G>(in_function));}
+      static void invoke(Buffer &io_buffer) {(**reinterpret_cast<F**>(&io_buffer))();}
+      static void manage(Operation in_operation, Buffer &io_buffer, Buffer &io_other)
+      {
+	switch (in_operation)
+	  {
+	  case Operation::Copy:
+	    *reinterpret_cast<F**>(&io_buffer) = Callback::clone(**reinterpret_cast<F**>(&io_other), std::is_copy_constructible<F>());
+	    break;
+	  case Operation::Move: *reinterpret_cast<F**>(&io_buffer) = *reinterpret_cast<F**>(&io_other); break;
+	  case Operation::Destroy: delete *reinterpret_cast<F**>(&io_buffer); break;
+	  }
+      }
+    };
+
+    //! Copies the callable object, in place or on the heap. Only instantiated for copyable objects, the others are rejected at construction.
+    template<typename F>
+    static void copy(void *out_address, const F &in_function, std::true_type) {new (out_address) F(in_function);}
+    template<typename F>
+    static void copy(void *out_address, const F &in_function, std::false_type) {}
+    template<typename F>
+    static F* clone(const F &in_function, std::true_type) {return new F(in_function);}
+    template<typename F>
+    static F* clone(const F &in_function, std::false_type) {return nullptr;}
+
+    //! Destroys the stored callable object.
+    void reset()
+    {
+      if (this->_manage) this->_manage(Operation::Destroy, this->_buffer, this->_buffer);
+      this->_invoke = nullptr;
+      this->_manage = nullptr;
+    }
+
+    mutable Buffer _buffer;
+    void (*_invoke)(Buffer&);
+    void (*_manage)(Operation, Buffer&, Buffer&);
+  };
+
+  //#########################################################################################################
+  /*
+    Activity
+  */
+  //! Handle of a do-activity running on an executor while its state is active.
+  /**
+   * The do-activity should check regularly the "cancelled" method and return as soon as it 
+   * is true: the activity is cancelled when its state is left, without waiting for it.
+   **/
+
+  class Activity
+  {
+  public:
+    //! Constructor.
+    Activity() : _cancelled(false), _finished(false) {}
+
+    //! Returns true if the state of the activity has been left.
+    bool cancelled() const {return this->_cancelled.load();}
+
+    //! Returns true if the activity has returned.
+    bool finished() const {return this->_finished.load();}
+
+    //! Asks the activity to stop.
+    void cancel() {this->_cancelled.store(true);}
+
+    //! Marks the activity as returned.
+    void finish() {this->_finished.store(true);}
+
+  private:
+    std::atomic<bool> _cancelled;
+    std::atomic<bool> _finished;
+  };
+
+  //! Function run as the do-activity of a state.
+  typedef std::function<void(const Activity&)> DoActivity;
+
+  //#########################################################################################################
+  /*
+    WakeUp
+  */
+  //! Notification, from any thread, that a machine has something to do without having been sent a signal.
+  /**
+   * Called when a do-activity returns and when an asynchronous effect resumes. The driver of the machine (eg: an EventLoop, a Scheduler) 
+   * sets the function, so that the machine is run without waiting for one of its deadlines. 
+   * See Machine's "setWakeUp" method.
+   **/
+
+  class WakeUp
+  {
+  public:
+    //! Sets the function called by "notify", an empty function for none.
+    void set(std::function<void()> in_function)
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      this->_function = std::move(in_function);
+    }
+
+    //! Calls the function, if any. May be called from any thread.
+    void notify() const
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      if (this->_function) this->_function();
+    }
+
+  private:
+    mutable std::mutex _mutex; // The function isn't replaced while it is called.
+    std::function<void()> _function;
+  };
+
+  class Executor;
+
+  //#########################################################################################################
+  /*
+    Callbacks
+  */
+  //! Tables of the entry, exit and effect callbacks, and of the do-activities and asynchronous effects, of a machine.
+  /**
+   * Each state and transition added to the machine is given a dense index, and callbacks are 
+   * stored in contiguous arrays indexed by it, so that calling the callback of a state is an 
+   * indexed load and a direct call, and the tables only grow with the size of the machine. 
+   * See Machine's "onEntry", "onExit", "onEffect", "onDo" and "onAsyncEffect" methods.
+   **/
+
+  class Callbacks
+  {
+  public:
+    //! Constructor.
+    Callbacks() : _frames(std::make_shared<FramePool>()), _wakeUp(std::make_shared<WakeUp>()) {}
+
+    //! Returns the index of the state with the interned name specified in argument, which is given one if it has none.
+    std::size_t indexState(Symbol in_state_symbol) {return Callbacks::index(this->_stateIndexes, in_state_symbol);}
+
+    //! Returns the index of the transition with the interned name specified in argument, which is given one if it has none.
+    std::size_t indexTransition(Symbol in_transition_symbol) {return Callbacks::index(this->_transitionIndexes, in_transition_symbol);}
+
+    //! Retrieves the index of the state with the interned name specified in argument. Returns false if it has none.
+    bool findState(Symbol in_state_symbol, std::size_t &out_index) const {return Callbacks::find(this->_stateIndexes, in_state_symbol, out_index);}
+
+    //! Retrieves the index of the transition with the interned name specified in argument. Returns false if it has none.
+    bool findTransition(Symbol in_transition_symbol, std::size_t &out_index) const {return Callbacks::find(this->_transitionIndexes, in_transition_symbol, out_index);}
+
+    //! Sets the callback called when the state with the index specified in argument is reached.
+    void setEntry(std::size_t in_state_index, Callback in_callback) {Callbacks::set(this->_entries, in_state_index, std::move(in_callback));}
+
+    //! Sets the callback called when the state with the index specified in argument is left.
+    void setExit(std::size_t in_state_index, Callback in_callback) {Callbacks::set(this->_exits, in_state_index, std::move(in_callback));}
+
+    //! Sets the callback called when the transition with the index specified in argument is fired.
+    void setEffect(std::size_t in_transition_index, Callback in_callback) {Callbacks::set(this->_effects, in_transition_index, std::move(in_callback));}
+
+    //! Sets the do-activity launched when the state with the index specified in argument is reached.
+    void setActivity(std::size_t in_state_index, DoActivity in_activity)
+    {
+      if (this->_activities.size() <= in_state_index) this->_activities.resize(in_state_index + 1);
+      this->_activities[in_state_index] = std::move(in_activity);
+    }
+
+    //! Sets the asynchronous effect launched when the transition with the index specified in argument is fired.
+    void setAsyncEffect(std::size_t in_transition_index, AsyncEffect in_effect)
+    {
+      if (this->_asyncEffects.size() <= in_transition_index) this->_asyncEffects.resize(in_transition_index + 1);
+      this->_asyncEffects[in_transition_index] = std::move(in_effect);
+    }
+
+    //! Sets the executor on which do-activities are launched.
+    void setExecutor(std::shared_ptr<Executor> in_executor) {this->_executor = in_executor;}
+
+    //! Returns the do-activity of the state, a null pointer if there is none.
+    const DoActivity* activity(std::size_t in_state_index) const
+    {
+      if (in_state_index < this->_activities.size() && this->_activities[in_state_index]) return &this->_activities[in_state_index];
+      return nullptr;
+    }
+
+    //! Returns true if the transition has an asynchronous effect.
+    bool hasAsyncEffect(std::size_t in_transition_index) const
+    {
+      return in_transition_index < this->_asyncEffects.size() && this->_asyncEffects[in_transition_index];
+    }
+
+    //! Returns the executor on which do-activities are launched, a null pointer for the shared ThreadPool.
+    std::shared_ptr<Executor> executor() const {return this->_executor;}
+
+    //! Returns the notification of the driver of the machine.
+    std::shared_ptr<WakeUp> wakeUp() const {return this->_wakeUp;}
+
+    //! Calls the entry callback of the state, if any.
+    void entry(std::size_t in_state_index) const {Callbacks::call(this->_entries, in_state_index);}
+
+    //! Calls the exit callback of the state, if any.
+    void exit(std::size_t in_state_index) const {Callbacks::call(this->_exits, in_state_index);}
+
+    //! Calls the effect callback of the transition, if any.
+    void effect(std::size_t in_transition_index) const {Callbacks::call(this->_effects, in_transition_index);}
+
+    //! Launches the asynchronous effect of the transition, if any, and returns the frame on which it resumes.
+    /** Returns a null pointer if the transition doesn't have an asynchronous effect. **/
+    Frame *launch(std::size_t in_transition_index) const
+    {
+      if (!this->hasAsyncEffect(in_transition_index)) return nullptr;
+      Frame *frame = this->_frames->acquire();
+      this->_asyncEffects[in_transition_index](Resume(this->_frames, frame, this->_wakeUp));
+      return frame;
+    }
+
+  private:
+    static std::size_t index(std::unordered_map<Symbol, std::size_t> &io_indexes, Symbol in_symbol)
+    {
+      return io_indexes.insert(std::make_pair(in_symbol, io_indexes.size())).first->second;
+    }
+
+    static bool find(const std::unordered_map<Symbol, std::size_t> &in_indexes, Symbol in_symbol, std::size_t &out_index)
+    {
+      auto found = in_indexes.find(in_symbol);
+      if (found == in_indexes.end()) return false;
+      out_index = found->second;
+      return true;
+    }
+
+    static void set(std::vector<Callback> &io_table, std::size_t in_index, Callback &&in_callback)
+    {
+      if (io_table.size() <= in_index) io_table.resize(in_index + 1);
+      io_table[in_index] = std::move(in_callback);
+    }
+    
+    static void call(const std::vector<Callback> &in_table, std::size_t in_index)
+    {
+      if (in_index < in_table.size() && in_table[in_index]) in_table[in_index]();
+    }
+    
+    std::unordered_map<Symbol, std::size_t> _stateIndexes; // {state, index in the tables of states}
+    std::unordered_map<Symbol, std::size_t> _transitionIndexes; // {transition, index in the tables of transitions}
+    std::vector<Callback> _entries;
+    std::vector<Callback> _exits;
+    std::vector<Callback> _effects;
+    std::vector<DoActivity> _activities;
+    std::vector<AsyncEffect> _asyncEffects;
+    std::shared_ptr<FramePool> _frames;
+    std::shared_ptr<Executor> _executor;
+    std::shared_ptr<WakeUp> _wakeUp;
+  };
+}
+
+#endif
@@ -43,6 +43,14 @@ DateTime OpenSourceTime::now()
   gettimeofday(&now, NULL);
   return DateTime(now);
 }
+
+// ---------------------------------------------------------------------------------------------------------------
+long long int OpenSourceTime::microseconds()
+{
+  timeval now;
+  gettimeofday(&now, NULL);
+  return static_cast<long long int>(now.tv_sec) * 1000000 + now.tv_usec;
+}
 #endif
 
 //#########################################################################################################
@@ -58,6 +66,12 @@ DateTime WindowsTime::now()
 	GetSystemTime(&now);
 	return DateTime(now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond, now.wMilliseconds * 1000);
 }
+
+// ---------------------------------------------------------------------------------------------------------------
+long long int WindowsTime::microseconds()
+{
+  return WindowsTime::now().toMicroseconds();
+}
 #endif
 
 //#########################################################################################################
@@ -444,6 +458,18 @@ unsigned long int DateTime::toSeconds()
   return result;
 }
 
+// ---------------------------------------------------------------------------------------------------------------
+long long int DateTime::toMicroseconds() 
+{
+  // Days from 1970-01-01 to the beginning of the year, counting leap years.
+  long long int year = this->_year;
+  long long int days = 365 * (year - 1970) + ((year - 1) / 4 - 1969 / 4) - ((year - 1) / 100 - 1969 / 100) +
+    ((year - 1) / 400 - 1969 / 400);
+  days += this->_dayOfYear - 1;
+  long long int seconds = days * 24 * 60 * 60 + this->_hour * 60 * 60 + this->_minute * 60 + this->_second;
+  return seconds * 1000000 + this->_usecond;
+}
+
 // ---------------------------------------------------------------------------------------------------------------
 void DateTime::computeDayOfMonth() 
 {
@@ -58,6 +58,9 @@ namespace fisa
   public:
     //! Returns system date and time at the moment of the call.
     static DateTime now();
+
+    //! Returns the number of microseconds since 1970 at the moment of the call, as DateTime's "toMicroseconds" method.
+    static long long int microseconds();
     
   private:
     OpenSourceTime();
@@ -81,6 +84,9 @@ namespace fisa
     //! Returns system date and time at the moment of the call.
     static DateTime now();
 
+    //! Returns the number of microseconds since 1970 at the moment of the call, as DateTime's "toMicroseconds" method.
+    static long long int microseconds();
+
   private:
     WindowsTime();
     ~WindowsTime();
@@ -176,6 +182,9 @@ namespace fisa
 
     std::string toIso8601();
     unsigned long int toSeconds();
+
+    //! Returns the number of microseconds since 1970-01-01T00:00:00, for dates after it.
+    long long int toMicroseconds();
   
   private:
     void computeDayOfMonth();
@@ -0,0 +1,320 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "eventloop.hpp"
+
+#ifdef EPOLL_EVENT_LOOP
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime> // timespec
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  EventLoop
+*/
+
+// -----------------------------------------------------------------------------------
+EventLoop::EventLoop(int in_max_steps) : _maxSteps(in_max_steps), _isStopped(false)
+{
+  this->_epollFd = epoll_create1(EPOLL_CLOEXEC);
+  this->_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  this->_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (!this->isValid())
+    {
+      std::cout << "ERROR: EventLoop::EventLoop, creation of the file descriptors failed." << std::endl;
+      return;
+    }
+  epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = this->_timerFd;
+  epoll_ctl(this->_epollFd, EPOLL_CTL_ADD, this->_timerFd, &event);
+  event.data.fd = this->_eventFd;
+  epoll_ctl(this->_epollFd, EPOLL_CTL_ADD, this->_eventFd, &event);
+}
+
+// -----------------------------------------------------------------------------------
+EventLoop::~EventLoop()
+{
+  for (auto it = this->_machines.begin(); it != this->_machines.end(); it++)
+    it->first->setWakeUp(nullptr);
+  if (this->_epollFd >= 0) close(this->_epollFd);
+  if (this->_timerFd >= 0) close(this->_timerFd);
+  if (this->_eventFd >= 0) close(this->_eventFd);
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::isValid() const
+{
+  return this->_epollFd >= 0 && this->_timerFd >= 0 && this->_eventFd >= 0;
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::add(Machine &io_machine)
+{
+  if (this->_machines.find(&io_machine) != this->_machines.end())
+    {
+      std::cout << "ERROR: EventLoop::add, machine \"" << *io_machine.name() << "\" already added." << std::endl;
+      return false;
+    }
+  Entry entry;
+  entry._isPending = false;
+  entry._hasDeadline = false;
+  entry._deadline = 0;
+  this->_machines[&io_machine] = entry;
+  this->schedule(&io_machine);
+  Machine *machine = &io_machine;
+  io_machine.setWakeUp([this, machine]() {this->inject(machine, nullptr);});
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::remove(Machine &io_machine)
+{
+  auto found = this->_machines.find(&io_machine);
+  if (found == this->_machines.end())
+    {
+      std::cout << "ERROR: EventLoop::remove, machine \"" << *io_machine.name() << "\" not found." << std::endl;
+      return false;
+    }
+  if (found->second._hasDeadline) this->_deadlines.erase(std::make_pair(found->second._deadline, &io_machine));
+  this->_machines.erase(found);
+  io_machine.setWakeUp(nullptr);
+  for (auto it = this->_pending.begin(); it != this->_pending.end(); it++)
+    if (*it == &io_machine) *it = nullptr;
+
+  std::vector<int> fds;
+  for (auto it = this->_watches.begin(); it != this->_watches.end(); it++)
+    if (it->second == &io_machine) fds.push_back(it->first);
+  for (auto it = fds.begin(); it != fds.end(); it++)
+    this->unwatch(*it);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::watch(int in_fd, std::uint32_t in_events, Machine &io_machine)
+{
+  if (this->_machines.find(&io_machine) == this->_machines.end())
+    {
+      std::cout << "ERROR: EventLoop::watch, machine \"" << *io_machine.name() << "\" not added." << std::endl;
+      return false;
+    }
+  epoll_event event;
+  event.events = in_events;
+  event.data.fd = in_fd;
+  int operation = (this->_watches.find(in_fd) == this->_watches.end()) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+  if (epoll_ctl(this->_epollFd, operation, in_fd, &event) != 0)
+    {
+      std::cout << "ERROR: EventLoop::watch, file descriptor " << in_fd << " can't be watched." << std::endl;
+      return false;
+    }
+  this->_watches[in_fd] = &io_machine;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::unwatch(int in_fd)
+{
+  auto found = this->_watches.find(in_fd);
+  if (found == this->_watches.end())
+    {
+      std::cout << "ERROR: EventLoop::unwatch, file descriptor " << in_fd << " not watched." << std::endl;
+      return false;
+    }
+  this->_watches.erase(found);
+  epoll_ctl(this->_epollFd, EPOLL_CTL_DEL, in_fd, nullptr);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+int EventLoop::poll(int in_timeout)
+{
+  const int max_events = 64;
+  epoll_event events[max_events];
+
+  // Machines that are already pending, or whose deadline is reached, are run without waiting.
+  if (!this->armTimer(EventLoop::now()) || !this->_pending.empty()) in_timeout = 0;
+  int ready = epoll_wait(this->_epollFd, events, max_events, in_timeout);
+  if (ready < 0)
+    {
+      if (errno == EINTR) return 0;
+      std::cout << "ERROR: EventLoop::poll, epoll_wait failed." << std::endl;
+      return -1;
+    }
+
+  for (int i = 0; i < ready; i++)
+    {
+      int fd = events[i].data.fd;
+      if (fd == this->_eventFd)
+	{
+	  eventfd_t count;
+	  eventfd_read(this->_eventFd, &count);
+	  std::vector<std::pair<Machine*, std::shared_ptr<const Signal> > > posted;
+	  {
+	    std::lock_guard<std::mutex> lock(this->_mutex);
+	    posted.swap(this->_posted);
+	  }
+	  for (auto it = posted.begin(); it != posted.end(); it++)
+	    {
+	      if (this->_machines.find(it->first) == this->_machines.end()) continue;
+	      if (it->second) it->first->sendSignal(it->second);
+	      this->schedule(it->first);
+	    }
+	}
+      else if (fd == this->_timerFd)
+	{
+	  std::uint64_t expirations;
+	  if (read(this->_timerFd, &expirations, sizeof(expirations)) < 0) continue;
+	}
+      else
+	{
+	  auto found = this->_watches.find(fd);
+	  if (found == this->_watches.end()) continue;
+	  Readiness readiness;
+	  readiness._fd = fd;
+	  readiness._events = events[i].events;
+	  found->second->send(readiness);
+	  this->schedule(found->second);
+	}
+    }
+
+  // Machines whose deadline is reached.
+  long long int before = EventLoop::now();
+  while (!this->_deadlines.empty() && this->_deadlines.begin()->first <= before)
+    {
+      auto machine = this->_deadlines.begin()->second;
+      this->_deadlines.erase(this->_deadlines.begin());
+      this->_machines[machine]._hasDeadline = false;
+      this->schedule(machine);
+    }
+
+  int stepped = 0;
+  std::vector<Machine*> pending;
+  pending.swap(this->_pending);
+  for (auto it = pending.begin(); it != pending.end(); it++)
+    {
+      if (!*it) continue;
+      if (!this->step(*it, before))
+	{
+	  // The machines not run yet are still pending, they are run on the next iteration.
+	  this->_pending.insert(this->_pending.end(), it + 1, pending.end());
+	  return -1;
+	}
+      stepped++;
+    }
+  return stepped;
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::run()
+{
+  this->_isStopped = false;
+  while (!this->_isStopped)
+    if (this->poll(-1) < 0) return false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void EventLoop::stop()
+{
+  this->_isStopped = true;
+  eventfd_write(this->_eventFd, 1);
+}
+
+// -----------------------------------------------------------------------------------
+void EventLoop::inject(Machine *in_machine, std::shared_ptr<const Signal> in_signal)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_posted.push_back(std::make_pair(in_machine, in_signal));
+  }
+  eventfd_write(this->_eventFd, 1);
+}
+
+// -----------------------------------------------------------------------------------
+void EventLoop::schedule(Machine *in_machine)
+{
+  auto &entry = this->_machines[in_machine];
+  if (entry._isPending) return;
+  entry._isPending = true;
+  this->_pending.push_back(in_machine);
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::step(Machine *in_machine, long long int in_before)
+{
+  auto &entry = this->_machines[in_machine];
+  entry._isPending = false;
+  int steps = in_machine->runUntilStable(this->_maxSteps);
+  if (steps < 0)
+    {
+      std::cout << "ERROR: EventLoop::step, machine \"" << *in_machine->name() << "\" run failed." << std::endl;
+      return false;
+    }
+  // A run stopped by the step cap goes on at the next iteration, without waiting for another event.
+  if (steps >= this->_maxSteps || in_machine->pendingSignals() > 0) this->schedule(in_machine);
+  if (entry._hasDeadline) this->_deadlines.erase(std::make_pair(entry._deadline, in_machine));
+  
+  // A deadline reached before the run has been checked by the run, it is not waited for anymore.
+  entry._hasDeadline = in_machine->nextDeadline(entry._deadline) && entry._deadline > in_before;
+  if (entry._hasDeadline) this->_deadlines.insert(std::make_pair(entry._deadline, in_machine));
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool EventLoop::armTimer(long long int in_now)
+{
+  itimerspec timer;
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_nsec = 0;
+  timer.it_value.tv_sec = 0;
+  timer.it_value.tv_nsec = 0;
+  if (!this->_deadlines.empty())
+    {
+      long long int delay = this->_deadlines.begin()->first - in_now;
+      if (delay <= 0) return false;
+      timer.it_value.tv_sec = delay / 1000000;
+      timer.it_value.tv_nsec = (delay % 1000000) * 1000;
+    }
+  timerfd_settime(this->_timerFd, 0, &timer, nullptr);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+long long int EventLoop::now()
+{
+  return OpenSourceTime::microseconds();
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef EVENTLOOP_HPP
+#define EVENTLOOP_HPP
+
+#include "machine.hpp"
+
+#include <atomic>
+#include <cstdint> // uint32_t
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility> // pair
+#include <vector>
+
+namespace fisa
+{
+  //! Payload of the signal sent to a machine when a file descriptor it watches is ready.
+  /** Transitions are triggered by a SignalEvent<Readiness>, whose "accept" method can filter on the file descriptor. **/
+  typedef struct Readiness
+  {
+    int _fd;
+    std::uint32_t _events; // Ready events, as returned by epoll (eg: EPOLLIN, EPOLLOUT).
+  } Readiness;
+
+#ifdef EPOLL_EVENT_LOOP
+
+  //#########################################################################################################
+  /*
+    EventLoop
+  */
+  //! Driver that runs machines only when they have something to do.
+  /**
+   * A single thread waits, with epoll, on the file descriptors watched by the machines, on a 
+   * timerfd armed for the earliest deadline of the TimeEvents of the active states (see Machine's 
+   * "nextDeadline" method), and on an eventfd signaled when a signal is posted from another thread, 
+   * or when a machine is woken up (see Machine's "setWakeUp" method). 
+   * Ready file descriptors are sent as Readiness signals to the machines that watch them, and only 
+   * the machines that received a signal or reached a deadline are run, until they are stable. 
+   * While nothing happens, the thread sleeps.
+   * Supported on Linux.
+   **/
+
+  class EventLoop
+  {
+  public:
+    //! Constructor. Each machine is run at most "in_max_steps" microsteps per iteration of the loop.
+    /** A machine stopped by this cap is run again on the next iteration, without waiting for another event. **/
+    EventLoop(int in_max_steps = 64);
+
+    //! Destructor.
+    ~EventLoop();
+
+    //! Returns false if the epoll, timerfd or eventfd file descriptors couldn't be created.
+    bool isValid() const;
+
+    //! Registers a machine, which is run on the next iteration of the loop.
+    bool add(Machine &io_machine);
+
+    //! Unregisters a machine, and stops watching its file descriptors.
+    bool remove(Machine &io_machine);
+
+    //! Watches the file descriptor specified in first argument for the epoll events specified in second argument.
+    /** The machine is sent a Readiness signal each time the file descriptor is ready. **/
+    bool watch(int in_fd, std::uint32_t in_events, Machine &io_machine);
+
+    //! Stops watching the file descriptor specified in argument.
+    bool unwatch(int in_fd);
+
+    //! Sends a signal with the payload specified in second argument to a registered machine. May be called from any thread.
+    template<typename P>
+    void post(Machine &io_machine, const P &in_payload)
+    {
+      this->inject(&io_machine, std::make_shared<const PayloadSignal<P> >(in_payload));
+    }
+
+    //! Waits for at most "in_timeout" milliseconds (-1 for no limit) that a machine has something to do, then runs it.
+    /** Returns the number of machines that have been run, or -1 if an error occurred. **/
+    int poll(int in_timeout);
+
+    //! Polls until the "stop" method is called. Returns false if an error occurred.
+    bool run();
+
+    //! Makes the "run" method return. May be called from any thread.
+    void stop();
+
+  private:
+    EventLoop(const EventLoop &in_loop);
+    EventLoop& operator = (const EventLoop &in_loop);
+
+    //! State of a registered machine.
+    typedef struct Entry
+    {
+      bool _isPending; // The machine is run on the current iteration.
+      bool _hasDeadline;
+      long long int _deadline;
+    } Entry;
+
+    //! Queues a signal for a machine and wakes the loop up. Without signal, the machine is only run.
+    void inject(Machine *in_machine, std::shared_ptr<const Signal> in_signal);
+
+    //! Sets the machine to be run on the current iteration.
+    void schedule(Machine *in_machine);
+
+    //! Runs the machine and stores its next deadline.
+    bool step(Machine *in_machine, long long int in_before);
+
+    //! Arms the timerfd for the earliest deadline, returns false if a deadline is already reached.
+    bool armTimer(long long int in_now);
+
+    //! Returns the current time in microseconds since 1970.
+    static long long int now();
+
+    int _maxSteps;
+    int _epollFd;
+    int _timerFd;
+    int _eventFd;
+    std::atomic<bool> _isStopped;
+    std::unordered_map<Machine*, Entry> _machines;
+    std::unordered_map<int, Machine*> _watches;
+    std::set<std::pair<long long int, Machine*> > _deadlines;
+    std::vector<Machine*> _pending;
+    std::mutex _mutex; // Protects the posted signals.
+    std::vector<std::pair<Machine*, std::shared_ptr<const Signal> > > _posted;
+  };
+
+#endif
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "executor.hpp"
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  Executor
+*/
+
+// -----------------------------------------------------------------------------------
+Executor::~Executor()
+{
+}
+
+//#########################################################################################################
+/*
+  ThreadPool
+*/
+
+// -----------------------------------------------------------------------------------
+ThreadPool::ThreadPool(std::size_t in_threads) : _isStopped(false)
+{
+  if (in_threads == 0) in_threads = 1;
+  for (std::size_t i = 0; i < in_threads; i++)
+    this->_threads.push_back(std::thread(&ThreadPool::work, this));
+}
+
+// -----------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_isStopped = true;
+  }
+  this->_condition.notify_all();
+  for (auto it = this->_threads.begin(); it != this->_threads.end(); it++)
+    it->join();
+}
+
+// -----------------------------------------------------------------------------------
+void ThreadPool::post(Callback in_task)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_tasks.pushBack(std::move(in_task));
+  }
+  this->_condition.notify_one();
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<ThreadPool> ThreadPool::shared()
+{
+  static std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(std::thread::hardware_concurrency());
+  return pool;
+}
+
+// -----------------------------------------------------------------------------------
+void ThreadPool::work()
+{
+  while (true)
+    {
+      Callback task;
+      {
+	std::unique_lock<std::mutex> lock(this->_mutex);
+	while (!this->_isStopped && this->_tasks.empty()) this->_condition.wait(lock);
+	if (this->_isStopped) return;
+	task = std::move(this->_tasks.front());
+	this->_tasks.popFront();
+      }
+      task();
+    }
+}
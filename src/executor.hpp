@@ -0,0 +1,100 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef EXECUTOR_HPP
+#define EXECUTOR_HPP
+
+#include "callbacks.hpp"
+#include "ringbuffer.hpp"
+
+#include <condition_variable>
+#include <cstddef> // size_t
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fisa
+{
+  //#########################################################################################################
+  /*
+    Executor
+  */
+  //! Abstract class of the executors on which the do-activities of the states are run.
+
+  class Executor
+  {
+  public:
+    //! Destructor.
+    virtual ~Executor();
+
+    //! Runs the task specified in argument asynchronously. May be called from any thread.
+    virtual void post(Callback in_task) = 0;
+  };
+
+  //#########################################################################################################
+  /*
+    ThreadPool
+  */
+  //! Executor that runs tasks on a fixed number of threads, in the order they have been posted.
+  /**
+   * Tasks that have not been started when the pool is destroyed are discarded, the running 
+   * ones are waited for.
+   **/
+
+  class ThreadPool : public Executor
+  {
+  public:
+    //! Construct a pool with the number of threads specified in argument, at least one.
+    ThreadPool(std::size_t in_threads);
+
+    //! Destructor. Waits for the running tasks.
+    ~ThreadPool();
+
+    //! Specializes Executor's "post" method.
+    void post(Callback in_task);
+
+    //! Returns the number of threads.
+    std::size_t size() const {return this->_threads.size();}
+
+    //! Returns the pool shared by machines without executor, created on first use with one thread per core.
+    static std::shared_ptr<ThreadPool> shared();
+
+  private:
+    //! Loop of the threads, running the posted tasks.
+    void work();
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    RingBuffer<Callback> _tasks;
+    bool _isStopped;
+    std::vector<std::thread> _threads;
+  };
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "frames.hpp"
+#include "transitions.hpp"
+
+#include <new> // placement new
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  Frame
+*/
+
+// -----------------------------------------------------------------------------------
+void Frame::release()
+{
+  this->_transition = nullptr;
+  this->_holders.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+//#########################################################################################################
+/*
+  Resume
+*/
+
+// -----------------------------------------------------------------------------------
+void Resume::operator () () const
+{
+  // A copy called twice, or called once the frame has been reused by another suspension, is ignored.
+  unsigned long long int expected = this->_stamp;
+  if (!this->_frame->_stamp.compare_exchange_strong(expected, this->_stamp | 1, std::memory_order_acq_rel)) return;
+  this->_frame->_holders.fetch_sub(1, std::memory_order_acq_rel);
+  if (this->_wakeUp) this->_wakeUp->notify();
+}
+
+//#########################################################################################################
+/*
+  FramePool
+*/
+
+// -----------------------------------------------------------------------------------
+FramePool::FramePool() : _arena(32 * sizeof(Frame))
+{
+}
+
+// -----------------------------------------------------------------------------------
+FramePool::~FramePool()
+{
+  for (auto it = this->_frames.begin(); it != this->_frames.end(); it++)
+    (*it)->~Frame();
+}
+
+// -----------------------------------------------------------------------------------
+Frame *FramePool::acquire()
+{
+  Frame *frame = nullptr;
+  for (auto it = this->_frames.begin(); it != this->_frames.end() && !frame; it++)
+    if ((*it)->_holders.load(std::memory_order_acquire) == 0) frame = *it;
+  if (!frame)
+    {
+      frame = new (this->_arena.allocate(sizeof(Frame), alignof(Frame))) Frame();
+      this->_frames.push_back(frame);
+    }
+  // A new generation, not resumed.
+  frame->_stamp.store((frame->_stamp.load(std::memory_order_relaxed) | 1) + 1, std::memory_order_relaxed);
+  frame->_holders.store(2, std::memory_order_release);
+  return frame;
+}
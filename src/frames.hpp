@@ -0,0 +1,156 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef FRAMES_HPP
+#define FRAMES_HPP
+
+#include "arena.hpp"
+
+#include <atomic>
+#include <cstddef> // size_t
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace fisa
+{
+  class Transition;
+  class FramePool;
+  class WakeUp;
+  
+  //#########################################################################################################
+  /*
+    Frame
+  */
+  //! State of a transition whose asynchronous effect is pending, the region that fired it is suspended.
+  /**
+   * A frame is held by the suspended region and by the effect until it resumes, then it is 
+   * given back to its FramePool to be reused by a next suspension. Each reuse starts a new 
+   * generation of the frame, so that a Resume of a previous suspension doesn't resume it.
+   **/
+
+  class Frame
+  {
+  public:
+    //! Constructor.
+    Frame() : _holders(0), _stamp(0) {}
+
+    //! Returns true once the asynchronous effect has resumed. May be called from any thread.
+    bool isResumed() const {return (this->_stamp.load(std::memory_order_acquire) & 1) != 0;}
+
+    //! Stores the transition whose effect is pending.
+    void hold(std::shared_ptr<Transition> in_transition) {this->_transition = in_transition;}
+
+    //! Returns the transition whose effect is pending.
+    std::shared_ptr<Transition> transition() const {return this->_transition;}
+
+    //! Called by the region when it doesn't wait for the effect anymore.
+    void release();
+
+  private:
+    friend class FramePool;
+    friend class Resume;
+
+    Frame(const Frame &in_frame);
+    Frame& operator = (const Frame &in_frame);
+
+    std::atomic<int> _holders; // The frame is free when neither the region nor the effect hold it.
+    std::atomic<unsigned long long int> _stamp; // Generation of the frame, shifted by one bit, and the resumed bit.
+    std::shared_ptr<Transition> _transition;
+  };
+
+  //#########################################################################################################
+  /*
+    Resume
+  */
+  //! Function object given to an asynchronous effect, to be called once the effect has completed.
+  /**
+   * It may be copied and called from any thread, only its first call is taken into account. 
+   * The first call wakes the driver of the machine up (see Machine's "setWakeUp" method), and 
+   * the region that fired the transition goes on to the target of the transition on the next 
+   * run of the machine. An effect that never calls it keeps its frame until the machine is 
+   * destroyed.
+   **/
+
+  class Resume
+  {
+  public:
+    //! Construct a function object that resumes the frame specified in second argument, and notifies the wake-up specified in third argument.
+    /** Only the current generation of the frame is resumed, the frame must have been acquired and not yet resumed. **/
+    Resume(std::shared_ptr<FramePool> in_pool, Frame *in_frame, std::shared_ptr<const WakeUp> in_wake_up) :
+      _pool(in_pool), _frame(in_frame), _stamp(in_frame->_stamp.load(std::memory_order_acquire) & ~1ULL), _wakeUp(in_wake_up) {}
+
+    //! Resumes the region suspended on the frame.
+    void operator () () const;
+
+  private:
+    std::shared_ptr<FramePool> _pool; // Keeps the frame alive if the machine is destroyed before the effect completes.
+    Frame *_frame;
+    unsigned long long int _stamp; // Generation of the frame when the effect was launched.
+    std::shared_ptr<const WakeUp> _wakeUp;
+  };
+
+  //! Effect of a transition that completes asynchronously (eg: a socket write, a disk flush), see Machine's "onAsyncEffect" method.
+  typedef std::function<void(Resume)> AsyncEffect;
+
+  //#########################################################################################################
+  /*
+    FramePool
+  */
+  //! Pool of the frames of the suspended regions of a machine.
+  /**
+   * Frames are allocated in an Arena and reused once their effect has resumed, so that 
+   * suspending a region doesn't allocate memory once the pool holds as many frames as there 
+   * are pending effects. The pool is used by the thread that runs the machine.
+   **/
+
+  class FramePool
+  {
+  public:
+    //! Constructor.
+    FramePool();
+
+    //! Destructor. Destroys the frames.
+    ~FramePool();
+
+    //! Returns a free frame, held by the region and by the effect.
+    Frame *acquire();
+
+    //! Returns the number of frames allocated by the pool.
+    std::size_t size() const {return this->_frames.size();}
+
+  private:
+    FramePool(const FramePool &in_pool);
+    FramePool& operator = (const FramePool &in_pool);
+
+    Arena _arena;
+    std::vector<Frame*> _frames;
+  };
+}
+
+#endif
@@ -0,0 +1,241 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "guards.hpp"
+
+#include <algorithm> // set_union
+#include <iterator> // back_inserter
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  Expressions
+*/
+
+// -----------------------------------------------------------------------------------
+Expressions::Expressions(std::shared_ptr<Variables> in_variables) : _variables(in_variables)
+{
+}
+
+// -----------------------------------------------------------------------------------
+std::uint32_t Expressions::node(Operation in_operation, std::uint32_t in_left, std::uint32_t in_right, double in_constant)
+{
+  auto key = std::make_tuple(static_cast<int>(in_operation), in_left, in_right, in_constant);
+  auto found = this->_indexes.find(key);
+  if (found != this->_indexes.end()) return found->second;
+
+  Node node;
+  node._operation = in_operation;
+  node._left = in_left;
+  node._right = in_right;
+  node._constant = in_constant;
+  node._value = 0.;
+  node._evaluatedAt = 0;
+  node._isCached = false;
+  switch (in_operation)
+    {
+    case Operation::Constant:
+      break;
+    case Operation::Variable:
+      node._dependencies.push_back(in_left);
+      break;
+    case Operation::Not:
+    case Operation::Negate:
+      node._dependencies = this->_nodes[in_left]._dependencies;
+      break;
+    default:
+      std::set_union(this->_nodes[in_left]._dependencies.begin(), this->_nodes[in_left]._dependencies.end(),
+		     this->_nodes[in_right]._dependencies.begin(), this->_nodes[in_right]._dependencies.end(),
+		     std::back_inserter(node._dependencies));
+    }
+
+  auto index = static_cast<std::uint32_t>(this->_nodes.size());
+  this->_nodes.push_back(node);
+  this->_indexes[key] = index;
+  return index;
+}
+
+// -----------------------------------------------------------------------------------
+double Expressions::evaluate(std::uint32_t in_node)
+{
+  Node &node = this->_nodes[in_node];
+  auto version = this->_variables->version();
+  if (node._isCached && node._evaluatedAt == version) return node._value;
+  if (node._isCached)
+    {
+      bool is_changed = false;
+      for (auto it = node._dependencies.begin(); it != node._dependencies.end() && !is_changed; it++)
+	if (this->_variables->version(*it) > node._evaluatedAt) is_changed = true;
+      if (!is_changed)
+	{
+	  node._evaluatedAt = version;
+	  return node._value;
+	}
+    }
+
+  double value = 0.;
+  switch (node._operation)
+    {
+    case Operation::Constant: value = node._constant; break;
+    case Operation::Variable: value = this->_variables->value(node._left); break;
+    case Operation::Not: value = (this->evaluate(node._left) == 0.) ? 1. : 0.; break;
+    case Operation::Negate: value = -this->evaluate(node._left); break;
+    case Operation::And: value = (this->evaluate(node._left) != 0. && this->evaluate(node._right) != 0.) ? 1. : 0.; break;
+    case Operation::Or: value = (this->evaluate(node._left) != 0. || this->evaluate(node._right) != 0.) ? 1. : 0.; break;
+    case Operation::Equal: value = (this->evaluate(node._left) == this->evaluate(node._right)) ? 1. : 0.; break;
+    case Operation::NotEqual: value = (this->evaluate(node._left) != this->evaluate(node._right)) ? 1. : 0.; break;
+    case Operation::Less: value = (this->evaluate(node._left) < this->evaluate(node._right)) ? 1. : 0.; break;
+    case Operation::LessEqual: value = (this->evaluate(node._left) <= this->evaluate(node._right)) ? 1. : 0.; break;
+    case Operation::Greater: value = (this->evaluate(node._left) > this->evaluate(node._right)) ? 1. : 0.; break;
+    case Operation::GreaterEqual: value = (this->evaluate(node._left) >= this->evaluate(node._right)) ? 1. : 0.; break;
+    case Operation::Add: value = this->evaluate(node._left) + this->evaluate(node._right); break;
+    case Operation::Subtract: value = this->evaluate(node._left) - this->evaluate(node._right); break;
+    case Operation::Multiply: value = this->evaluate(node._left) * this->evaluate(node._right); break;
+    }
+
+  // The nodes aren't reallocated during the evaluation, "node" is still valid.
+  node._value = value;
+  node._evaluatedAt = version;
+  node._isCached = true;
+  return value;
+}
+
+//#########################################################################################################
+/*
+  Expression
+*/
+
+// -----------------------------------------------------------------------------------
+Expression::Expression(std::shared_ptr<Expressions> in_expressions, std::uint32_t in_node) :
+  _expressions(in_expressions), _node(in_node)
+{
+}
+
+// -----------------------------------------------------------------------------------
+Expression Expression::constant(double in_value) const
+{
+  return Expression(this->_expressions, this->_expressions->node(Operation::Constant, 0, 0, in_value));
+}
+
+// -----------------------------------------------------------------------------------
+Expression Expression::unary(Operation in_operation) const
+{
+  return Expression(this->_expressions, this->_expressions->node(in_operation, this->_node));
+}
+
+// -----------------------------------------------------------------------------------
+Expression Expression::binary(Operation in_operation, const Expression &in_right) const
+{
+  if (in_right._expressions != this->_expressions)
+    {
+      std::cout << "ERROR: Expression::binary, operands are variables of different machines." << std::endl;
+      return this->constant(0.);
+    }
+  return Expression(this->_expressions, this->_expressions->node(in_operation, this->_node, in_right._node));
+}
+
+// -----------------------------------------------------------------------------------
+double Expression::evaluate() const
+{
+  return this->_expressions->evaluate(this->_node);
+}
+
+// -----------------------------------------------------------------------------------
+Expression fisa::operator ! (const Expression &in_expression) {return in_expression.unary(Operation::Not);}
+Expression fisa::operator - (const Expression &in_expression) {return in_expression.unary(Operation::Negate);}
+Expression fisa::operator && (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::And, in_right);}
+Expression fisa::operator || (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::Or, in_right);}
+Expression fisa::operator == (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::Equal, in_right);}
+Expression fisa::operator == (const Expression &in_left, double in_right) {return in_left.binary(Operation::Equal, in_left.constant(in_right));}
+Expression fisa::operator != (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::NotEqual, in_right);}
+Expression fisa::operator != (const Expression &in_left, double in_right) {return in_left.binary(Operation::NotEqual, in_left.constant(in_right));}
+Expression fisa::operator < (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::Less, in_right);}
+Expression fisa::operator < (const Expression &in_left, double in_right) {return in_left.binary(Operation::Less, in_left.constant(in_right));}
+Expression fisa::operator <= (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::LessEqual, in_right);}
+Expression fisa::operator <= (const Expression &in_left, double in_right) {return in_left.binary(Operation::LessEqual, in_left.constant(in_right));}
+Expression fisa::operator > (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::Greater, in_right);}
+Expression fisa::operator > (const Expression &in_left, double in_right) {return in_left.binary(Operation::Greater, in_left.constant(in_right));}
+Expression fisa::operator >= (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::GreaterEqual, in_right);}
+Expression fisa::operator >= (const Expression &in_left, double in_right) {return in_left.binary(Operation::GreaterEqual, in_left.constant(in_right));}
+Expression fisa::operator + (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::Add, in_right);}
+Expression fisa::operator + (const Expression &in_left, double in_right) {return in_left.binary(Operation::Add, in_left.constant(in_right));}
+Expression fisa::operator - (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::Subtract, in_right);}
+Expression fisa::operator - (const Expression &in_left, double in_right) {return in_left.binary(Operation::Subtract, in_left.constant(in_right));}
+Expression fisa::operator * (const Expression &in_left, const Expression &in_right) {return in_left.binary(Operation::Multiply, in_right);}
+Expression fisa::operator * (const Expression &in_left, double in_right) {return in_left.binary(Operation::Multiply, in_left.constant(in_right));}
+
+//#########################################################################################################
+/*
+  GuardEvent
+*/
+
+// -----------------------------------------------------------------------------------
+GuardEvent::GuardEvent(const Expression &in_expression) : _expression(in_expression)
+{
+}
+
+// -----------------------------------------------------------------------------------
+GuardEvent::~GuardEvent()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool GuardEvent::init()
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool GuardEvent::happened() const
+{
+  return this->_expression.evaluate() != 0.;
+}
+
+// -----------------------------------------------------------------------------------
+bool GuardEvent::listen(std::shared_ptr<EventListener> in_listener)
+{
+  this->_listeners.push_back(in_listener);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void GuardEvent::changed(const Event *in_event)
+{
+  auto it = this->_listeners.begin();
+  while (it != this->_listeners.end())
+    {
+      auto listener = it->lock();
+      if (!listener) it = this->_listeners.erase(it);
+      else
+	{
+	  listener->changed(this);
+	  it++;
+	}
+    }
+}
@@ -0,0 +1,222 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef GUARDS_HPP
+#define GUARDS_HPP
+
+#include "transitions.hpp"
+#include "variables.hpp"
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+#include <vector>
+#include <map>
+#include <tuple>
+#include <memory>
+
+namespace fisa
+{
+  //#########################################################################################################
+  /*
+    Expressions
+  */
+  //! Operations of the nodes of guard expressions.
+  enum class Operation
+  {
+    Constant,
+    Variable,
+    Not,
+    Negate,
+    And,
+    Or,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Add,
+    Subtract,
+    Multiply
+  };
+
+  //! Pool of the compiled nodes of the guard expressions of a machine.
+  /**
+   * Expressions are compiled into a flat array of nodes, and identical nodes are shared, so 
+   * that a sub-expression used by many guards is computed once. Each node knows the variables 
+   * it depends on and caches its value, which is computed again only after one of them has changed.
+   **/
+
+  class Expressions
+  {
+  public:
+    //! Construct a pool of nodes reading the variables specified in argument.
+    Expressions(std::shared_ptr<Variables> in_variables);
+
+    //! Returns the variables read by the expressions.
+    std::shared_ptr<Variables> variables() const {return this->_variables;}
+
+    //! Returns the index of the node with the operation and operands specified in argument, adding it if needed.
+    /** 
+     * Operands are indexes of nodes, excepted for "Constant" whose value is specified in 
+     * last argument, and "Variable" whose first operand is the index of the variable.
+     **/
+    std::uint32_t node(Operation in_operation, std::uint32_t in_left, std::uint32_t in_right = 0, double in_constant = 0.);
+
+    //! Returns the variables the node specified in argument depends on.
+    const std::vector<std::size_t>& dependencies(std::uint32_t in_node) const {return this->_nodes[in_node]._dependencies;}
+    
+    //! Returns the value of the node specified in argument.
+    double evaluate(std::uint32_t in_node);
+
+    //! Returns the number of nodes.
+    std::size_t size() const {return this->_nodes.size();}
+    
+  private:
+    typedef struct
+    {
+      Operation _operation;
+      std::uint32_t _left;
+      std::uint32_t _right;
+      double _constant;
+      std::vector<std::size_t> _dependencies; // Sorted indexes of the variables read.
+      double _value;
+      unsigned long _evaluatedAt; // Version of the variables when the value has been computed.
+      bool _isCached;
+    } Node;
+    
+    std::shared_ptr<Variables> _variables;
+    std::vector<Node> _nodes;
+    std::map<std::tuple<int, std::uint32_t, std::uint32_t, double>, std::uint32_t> _indexes; // {node, index}
+  };
+
+  //#########################################################################################################
+  /*
+    Expression
+  */
+  //! Handle of a guard expression, built with operators from the machine's variables.
+  /**
+   * Expressions are created with the Machine's "variable" method and combined with the 
+   * operators "!", "-", "&&", "||", "==", "!=", "<", "<=", ">", ">=", "+", "-" and "*".
+   * Values are doubles, and a value different from 0 is true.
+   **/
+
+  class Expression
+  {
+  public:
+    //! Construct a handle of the node specified in argument.
+    Expression(std::shared_ptr<Expressions> in_expressions, std::uint32_t in_node);
+
+    //! Returns the pool of the expression's nodes.
+    std::shared_ptr<Expressions> expressions() const {return this->_expressions;}
+
+    //! Returns the index of the expression's node.
+    std::uint32_t node() const {return this->_node;}
+
+    //! Returns a constant expression with the value specified in argument, in the same pool.
+    Expression constant(double in_value) const;
+
+    //! Returns the expression with the operation specified in argument and this expression as only operand.
+    Expression unary(Operation in_operation) const;
+    
+    //! Returns the expression with the operation specified in argument and the two operands.
+    Expression binary(Operation in_operation, const Expression &in_right) const;
+
+    //! Returns the current value of the expression.
+    double evaluate() const;
+    
+  private:
+    std::shared_ptr<Expressions> _expressions;
+    std::uint32_t _node;
+  };
+
+  Expression operator ! (const Expression &in_expression);
+  Expression operator - (const Expression &in_expression);
+  Expression operator && (const Expression &in_left, const Expression &in_right);
+  Expression operator || (const Expression &in_left, const Expression &in_right);
+  Expression operator == (const Expression &in_left, const Expression &in_right);
+  Expression operator == (const Expression &in_left, double in_right);
+  Expression operator != (const Expression &in_left, const Expression &in_right);
+  Expression operator != (const Expression &in_left, double in_right);
+  Expression operator < (const Expression &in_left, const Expression &in_right);
+  Expression operator < (const Expression &in_left, double in_right);
+  Expression operator <= (const Expression &in_left, const Expression &in_right);
+  Expression operator <= (const Expression &in_left, double in_right);
+  Expression operator > (const Expression &in_left, const Expression &in_right);
+  Expression operator > (const Expression &in_left, double in_right);
+  Expression operator >= (const Expression &in_left, const Expression &in_right);
+  Expression operator >= (const Expression &in_left, double in_right);
+  Expression operator + (const Expression &in_left, const Expression &in_right);
+  Expression operator + (const Expression &in_left, double in_right);
+  Expression operator - (const Expression &in_left, const Expression &in_right);
+  Expression operator - (const Expression &in_left, double in_right);
+  Expression operator * (const Expression &in_left, const Expression &in_right);
+  Expression operator * (const Expression &in_left, double in_right);
+  
+  //#########################################################################################################
+  /*
+    GuardEvent
+  */
+  //! Event triggered when a guard expression is true.
+  /**
+   * To create automata, the Machine's "guard" method should be used. The event can be the 
+   * trigger of a transition, or its guard (see Transition's "setGuard" method). 
+   * It is checked again only when a variable read by the expression changes.
+   **/
+
+  class GuardEvent : public Event, public EventListener
+  {
+  public:
+    //! Construct an event triggered when the expression specified in argument is true.
+    GuardEvent(const Expression &in_expression);
+
+    //! Destructor.
+    ~GuardEvent();
+
+    //! Specializes Event's "init" method.
+    bool init();
+
+    //! Specializes Event's "happened" method.
+    bool happened() const;
+
+    //! Specializes Event's "listen" method.
+    bool listen(std::shared_ptr<EventListener> in_listener);
+
+    //! Specializes EventListener's "changed" method, called when a variable read by the expression changes.
+    void changed(const Event *in_event);
+
+    //! Returns the expression.
+    const Expression& expression() const {return this->_expression;}
+    
+  private:
+    Expression _expression;
+    std::vector<std::weak_ptr<EventListener> > _listeners;
+  };
+}
+
+#endif
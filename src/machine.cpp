@@ -28,6 +28,8 @@
 
 #include "machine.hpp"
 
+#include <limits> // numeric_limits
+
 using namespace fisa;
 
 //#########################################################################################################
@@ -38,9 +40,13 @@ using namespace fisa;
 // -----------------------------------------------------------------------------------
 Machine::Machine(const char *in_machine_name) : RegionsComponent()
 {
-  this->_machineName = std::make_shared<std::string>(in_machine_name);
+  this->_machineSymbol = SymbolTable::intern(in_machine_name);
   this->_isInitiated = false;
   this->_isTerminated = false;
+  this->_expressions = std::make_shared<Expressions>(std::make_shared<Variables>());
+  this->_isUpdating = false;
+  this->_conflictPolicy = ConflictPolicy::PriorityWins;
+  this->_callbacks = std::make_shared<Callbacks>();
 }
 
 // -----------------------------------------------------------------------------------
@@ -51,7 +57,7 @@ Machine::~Machine()
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::string> Machine::name() const
 {
-  return this->_machineName;
+  return SymbolTable::name(this->_machineSymbol);
 }
 
 // -----------------------------------------------------------------------------------
@@ -63,8 +69,8 @@ RegionsComponent Machine::regionsComponent()
 // -----------------------------------------------------------------------------------
 std::string Machine::activeState(const char *in_region_name) const
 {
-  auto region_name = std::make_shared<std::string>(in_region_name);
-  auto region = this->findRegion(region_name);
+  Symbol region_symbol;
+  auto region = SymbolTable::find(in_region_name, region_symbol) ? this->findRegion(region_symbol) : nullptr;
   if (region)
     {
       auto active_state = region->activeState();
@@ -72,7 +78,7 @@ std::string Machine::activeState(const char *in_region_name) const
       else
 	{
 #ifdef WARNING
-	  std::cout << "WARNING: Machine::activeState, region \"" << *region_name <<
+	  std::cout << "WARNING: Machine::activeState, region \"" << in_region_name <<
 	    "\" doesn't have any active state." << std::endl;
 #endif
 	  return std::string("");
@@ -81,7 +87,7 @@ std::string Machine::activeState(const char *in_region_name) const
   else 
     {
 #ifdef WARNING
-      std::cout << "WARNING: Machine::activeState, region \"" << *region_name <<
+      std::cout << "WARNING: Machine::activeState, region \"" << in_region_name <<
 	"\" doesn't exist." << std::endl;
 #endif
       return std::string("");
@@ -91,6 +97,154 @@ std::string Machine::activeState(const char *in_region_name) const
 // -----------------------------------------------------------------------------------
 bool Machine::run()
 {
+  bool fired;
+  return this->step(fired);
+}
+
+// -----------------------------------------------------------------------------------
+int Machine::runUntilStable(int in_max_steps)
+{
+  int steps = 0;
+  bool fired = true;
+  while ((fired || !this->_signals.empty()) && steps < in_max_steps)
+    {
+      if (!this->step(fired)) return -1;
+      if (fired) steps++;
+    }
+  
+#ifdef WARNING
+  if (fired || !this->_signals.empty())
+    std::cout << "WARNING: Machine::runUntilStable, machine \"" << *this->name() <<
+      "\" still firing transitions after " << in_max_steps << " microsteps." << std::endl;
+#endif
+  
+  return steps;
+}
+
+// -----------------------------------------------------------------------------------
+void Machine::sendSignal(std::shared_ptr<const Signal> in_signal)
+{
+  this->_signals.pushBack(in_signal);
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::nextDeadline(long long int &out_microseconds) const
+{
+  out_microseconds = std::numeric_limits<long long int>::max();
+  this->RegionsComponent::earliestDeadline(out_microseconds);
+  return out_microseconds != std::numeric_limits<long long int>::max();
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t Machine::pendingSignals() const
+{
+  return this->_signals.size();
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t Machine::deferredSignals() const
+{
+  return this->_deferredSignals.size();
+}
+
+// -----------------------------------------------------------------------------------
+void Machine::beginUpdate()
+{
+#ifdef WARNING
+  if (this->_isUpdating)
+    std::cout << "WARNING: Machine::beginUpdate, machine \"" << *this->name() <<
+      "\" is already updating." << std::endl;
+#endif
+  this->_isUpdating = true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::commitUpdate()
+{
+  if (!this->_isUpdating)
+    {
+      std::cout << "ERROR: Machine::commitUpdate, machine \"" << *this->name() <<
+	"\" isn't updating." << std::endl;
+      return false;
+    }
+  for (auto it = this->_updatedVariables.begin(); it != this->_updatedVariables.end(); it++)
+    (*it)->commit();
+  this->_updatedVariables.clear();
+  this->_isUpdating = false;
+  return this->run();
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::setVariable(const char *in_variable_name, double in_value)
+{
+  std::size_t index;
+  auto variables = this->_expressions->variables();
+  Symbol variable_symbol;
+  if (!SymbolTable::find(in_variable_name, variable_symbol) || !variables->find(variable_symbol, index))
+    {
+      std::cout << "ERROR: Machine::setVariable, variable \"" << in_variable_name <<
+	"\" not found." << std::endl;
+      return false;
+    }
+  if (!variables->setValue(index, in_value))
+    {
+      std::cout << "ERROR: Machine::setVariable, variable \"" << in_variable_name <<
+	"\" isn't arithmetic." << std::endl;
+      return false;
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::variableValue(const char *in_variable_name, double &out_value) const
+{
+  std::size_t index;
+  auto variables = this->_expressions->variables();
+  Symbol variable_symbol;
+  if (!SymbolTable::find(in_variable_name, variable_symbol) || !variables->find(variable_symbol, index))
+    {
+      std::cout << "ERROR: Machine::variableValue, variable \"" << in_variable_name <<
+	"\" not found." << std::endl;
+      return false;
+    }
+  if (!variables->isArithmetic(index))
+    {
+      std::cout << "ERROR: Machine::variableValue, variable \"" << in_variable_name <<
+	"\" isn't arithmetic." << std::endl;
+      return false;
+    }
+  out_value = variables->value(index);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void Machine::setConflictPolicy(ConflictPolicy in_policy)
+{
+  this->_conflictPolicy = in_policy;
+}
+
+// -----------------------------------------------------------------------------------
+ConflictPolicy Machine::conflictPolicy() const
+{
+  return this->_conflictPolicy;
+}
+
+// -----------------------------------------------------------------------------------
+void Machine::setExecutor(std::shared_ptr<Executor> in_executor)
+{
+  this->_callbacks->setExecutor(in_executor);
+}
+
+// -----------------------------------------------------------------------------------
+void Machine::setWakeUp(std::function<void()> in_wake_up)
+{
+  this->_callbacks->wakeUp()->set(std::move(in_wake_up));
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::step(bool &out_fired)
+{
+  out_fired = false;
   if (this->_isTerminated)
     {
 #ifdef DEBUG
@@ -100,28 +254,82 @@ bool Machine::run()
     }
   else if (!this->_isInitiated)
     {
-      if(!this->RegionsComponent::init())
+      if(!this->RegionsComponent::resolveConflicts(this->_conflictPolicy) ||
+	 !this->RegionsComponent::flattenJunctions() || !this->RegionsComponent::init())
 	{
 	  std::cout << "ERROR: Machine::run, run failed" << std::endl;
 	  return false;
 	}
       this->_isInitiated = true;
+      out_fired = true;
       return true;
     }
   else
     {
       RegionInfo region_info;
       region_info.init();
+      if (!this->_signals.empty())
+	{
+	  region_info._signal = std::move(this->_signals.front());
+	  this->_signals.popFront();
+	}
       if(!this->RegionsComponent::run(region_info))
 	{
 	  std::cout << "ERROR: Machine::run(), failed" << std::endl;
 	  return false;
 	}
+      if (region_info._signal && !region_info._signal_consumed)
+	{
+	  if (region_info._signal_deferred) this->_deferredSignals.pushBack(std::move(region_info._signal));
+	  else
+	    {
+#ifdef DEBUG
+	      std::cout << "DEBUG: Machine::run, signal discarded." << std::endl;
+#endif
+	    }
+	}
       if (region_info._is_terminated) this->_isTerminated = true;
+      // Regions forbid further firing as soon as a transition has been fired inside them.
+      out_fired = !region_info._transition_firing_allowed;
+      // Deferred signals are offered again, before the other signals, once the machine has changed of state.
+      if (out_fired)
+	while (!this->_deferredSignals.empty())
+	  {
+	    this->_signals.pushFront(std::move(this->_deferredSignals.back()));
+	    this->_deferredSignals.popBack();
+	  }
       return true;
     }
 }
 
+// -----------------------------------------------------------------------------------
+void Machine::useArena(std::size_t in_chunk_size)
+{
+  this->RegionsComponent::useArena(std::make_shared<Arena>(in_chunk_size));
+}
+
+// -----------------------------------------------------------------------------------
+Expression Machine::variable(const char *in_variable_name, double in_initial_value)
+{
+  std::size_t index;
+  auto variables = this->_expressions->variables();
+  if (!variables->declare(SymbolTable::intern(in_variable_name), in_initial_value, index) &&
+      !variables->isArithmetic(index))
+    std::cout << "ERROR: Machine::variable, variable \"" << in_variable_name <<
+      "\" isn't arithmetic." << std::endl;
+  return Expression(this->_expressions, this->_expressions->node(Operation::Variable, static_cast<std::uint32_t>(index)));
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<GuardEvent> Machine::guard(const Expression &in_expression)
+{
+  auto event = this->create<GuardEvent>(in_expression);
+  auto &dependencies = in_expression.expressions()->dependencies(in_expression.node());
+  for (auto it = dependencies.begin(); it != dependencies.end(); it++)
+    in_expression.expressions()->variables()->listen(*it, event);
+  return event;
+}
+
 // -----------------------------------------------------------------------------------
 void Machine::newRegion(const char *in_region_name)
 {
@@ -131,15 +339,16 @@ void Machine::newRegion(const char *in_region_name)
 // -----------------------------------------------------------------------------------
 bool Machine::addState(const char *in_region_name, std::shared_ptr<SimpleState> in_state)
 {
-  auto region_name = std::make_shared<std::string>(in_region_name);
-  auto region = this->findRegion(region_name);
+  Symbol region_symbol;
+  auto region = SymbolTable::find(in_region_name, region_symbol) ? this->findRegion(region_symbol) : nullptr;
   if (!region)
     {
-      std::cout << "ERROR: Machine::addState, region \"" << *region_name <<
+      std::cout << "ERROR: Machine::addState, region \"" << in_region_name <<
 	"\" not found." << std::endl;
       return false;
     }
-  in_state->setOwningRegion(region_name);
+  in_state->setOwningRegion(region->symbol());
+  in_state->setCallbacks(this->_callbacks, this->_callbacks->indexState(in_state->symbol()));
   region->addState(in_state);      
   return true;  
 }
@@ -157,97 +366,200 @@ bool Machine::addTransition(std::shared_ptr<Transition> in_transition)
       std::cout << "ERROR: Machine::addTransition, use Machine's \"addFork\" method to add fork compound transition." << std::endl;
       return false;
     }
-  auto starting_state_name = in_transition->startingState(0);
-  auto starting_state = this->findState(starting_state_name);
+  if (in_transition->kind() == TransitionKind::Internal && in_transition->startingSymbol(0) != in_transition->reachableSymbol(0))
+    {
+      std::cout << "ERROR: Machine::addTransition, internal transition \"" << *(in_transition->name()) <<
+	"\" must reach the state it starts from." << std::endl;
+      return false;
+    }
+  auto starting_state = this->findState(in_transition->startingSymbol(0));
   if (!starting_state)
     {
-      std::cout << "ERROR: Machine::addTransition, state \"" << *starting_state_name <<
+      std::cout << "ERROR: Machine::addTransition, state \"" << *(in_transition->startingState(0)) <<
 	"\" not found." << std::endl;
       std::cout << "Starting state of transition \"" << *(in_transition->name()) <<
 	"\" not found." << std::endl;
       return false;
     }
-  auto reachable_state_name = in_transition->reachableState(0);
   if (!starting_state->addTransition(in_transition))
     {
       std::cout << "ERROR: Machine::addTransition, adding transition \""
 		<< *(in_transition->name()) << "\" failed." << std::endl;
       return false;
     }  
+  in_transition->setCallbacks(this->_callbacks, this->_callbacks->indexTransition(in_transition->symbol()));
+  this->_addedTransitions[in_transition->symbol()] = in_transition;
   return true;
 }
 
 // -----------------------------------------------------------------------------------
 bool Machine::addJoin(const char *in_outermost_starting_state_name, std::shared_ptr<Join> in_join)
 {
-  auto outermost_starting_state_name = std::make_shared<std::string>(in_outermost_starting_state_name);
   if (in_join->startingStates() < 2)
     {
       std::cout << "ERROR: Machine::addJoin, join compound transition \"" << *(in_join->name()) <<
 	"\" must have at least two incomings transition." << std::endl;
       return false;
     }
-  auto outermost_starting_state = this->findState(outermost_starting_state_name);
+  Symbol starting_state_symbol;
+  auto outermost_starting_state = SymbolTable::find(in_outermost_starting_state_name, starting_state_symbol) ?
+    this->findState(starting_state_symbol) : nullptr;
   if (!outermost_starting_state)
     {
       std::cout << "ERROR: Machine::addJoin, adding join compound transition \"" << *(in_join->name()) <<
 	"\" failed." << std::endl;
-      std::cout << "Can't retrieve outermost starting state \"" << *outermost_starting_state_name <<
+      std::cout << "Can't retrieve outermost starting state \"" << in_outermost_starting_state_name <<
 	"\"." << std::endl;
       
       return false;
     }
-  if (!outermost_starting_state->checkForkOrJoin(in_join->startingStatesNames(), true))
+  if (!outermost_starting_state->checkForkOrJoin(in_join->startingStatesSymbols(), true))
     {
       std::cout << "ERROR: Machine::addJoin, bad incoming transitions specification for the join compound transition \"" <<
 	*(in_join->name()) << "\"." << std::endl;
       return false;
     }
-  return outermost_starting_state->addJoin(in_join);
+  if (!outermost_starting_state->addJoin(in_join)) return false;
+  in_join->setCallbacks(this->_callbacks, this->_callbacks->indexTransition(in_join->symbol()));
+  this->_addedTransitions[in_join->symbol()] = in_join;
+  return true;
 }
 
 // -----------------------------------------------------------------------------------
 bool Machine::addFork(const char *in_outermost_reachable_state_name, std::shared_ptr<Fork> in_fork)
 {
-  auto outermost_reachable_state_name = std::make_shared<std::string>(in_outermost_reachable_state_name);
   if (in_fork->reachableStates() < 2)
     {
       std::cout << "ERROR: Machine::addFork, fork compound transition \"" << *(in_fork->name()) <<
 	"\" must have at least two outgoings transition." << std::endl;
       return false;
     }
-  auto outermost_reachable_state = this->findState(outermost_reachable_state_name);
+  Symbol reachable_state_symbol;
+  auto outermost_reachable_state = SymbolTable::find(in_outermost_reachable_state_name, reachable_state_symbol) ?
+    this->findState(reachable_state_symbol) : nullptr;
   if (!outermost_reachable_state)
     {
       std::cout << "ERROR: Machine::addFork, adding fork compound transition \"" << *(in_fork->name()) <<
 	"\" failed." << std::endl;
-      std::cout << "Can't retrieve outermost reachable state \"" << *outermost_reachable_state_name <<
+      std::cout << "Can't retrieve outermost reachable state \"" << in_outermost_reachable_state_name <<
 	"\"." << std::endl;
       return false;
     }
-  if (!outermost_reachable_state->checkForkOrJoin(in_fork->reachableStatesNames(), true))
+  if (!outermost_reachable_state->checkForkOrJoin(in_fork->reachableStatesSymbols(), true))
     {
       std::cout << "ERROR: Machine::addFork, bad outgoing transitions specification for the fork compound transition \"" <<
 	*(in_fork->name()) << "\" ." << std::endl;
       return false;
     }
-  auto starting_state_name = in_fork->startingState(0);
-  auto starting_state = this->findState(starting_state_name);
+  auto starting_state = this->findState(in_fork->startingSymbol(0));
   if (!starting_state)
     {
       std::cout << "ERROR: Machine::addFork, adding fork compound transition \"" << *(in_fork->name()) <<
 	"\" failed." << std::endl;
-      std::cout << "Can't retrieve starting state \"" << *starting_state_name << "\"." << std::endl;
+      std::cout << "Can't retrieve starting state \"" << *(in_fork->startingState(0)) << "\"." << std::endl;
       return false;
     }    
-  return starting_state->addTransition(in_fork);
+  if (!starting_state->addTransition(in_fork)) return false;
+  in_fork->setCallbacks(this->_callbacks, this->_callbacks->indexTransition(in_fork->symbol()));
+  this->_addedTransitions[in_fork->symbol()] = in_fork;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::onEntry(const char *in_state_name, Callback in_callback)
+{
+  Symbol state_symbol;
+  std::size_t state_index;
+  if (!SymbolTable::find(in_state_name, state_symbol) || !this->_callbacks->findState(state_symbol, state_index))
+    {
+      std::cout << "ERROR: Machine::onEntry, state \"" << in_state_name << "\" not found." << std::endl;
+      return false;
+    }
+  this->_callbacks->setEntry(state_index, std::move(in_callback));
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::onExit(const char *in_state_name, Callback in_callback)
+{
+  Symbol state_symbol;
+  std::size_t state_index;
+  if (!SymbolTable::find(in_state_name, state_symbol) || !this->_callbacks->findState(state_symbol, state_index))
+    {
+      std::cout << "ERROR: Machine::onExit, state \"" << in_state_name << "\" not found." << std::endl;
+      return false;
+    }
+  this->_callbacks->setExit(state_index, std::move(in_callback));
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::onEffect(const char *in_transition_name, Callback in_callback)
+{
+  Symbol transition_symbol;
+  std::size_t transition_index;
+  if (!SymbolTable::find(in_transition_name, transition_symbol) || !this->_callbacks->findTransition(transition_symbol, transition_index))
+    {
+      std::cout << "ERROR: Machine::onEffect, transition \"" << in_transition_name << "\" not found." << std::endl;
+      return false;
+    }
+  this->_callbacks->setEffect(transition_index, std::move(in_callback));
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::onAsyncEffect(const char *in_transition_name, AsyncEffect in_effect)
+{
+  Symbol transition_symbol;
+  std::size_t transition_index;
+  if (!SymbolTable::find(in_transition_name, transition_symbol) || !this->_callbacks->findTransition(transition_symbol, transition_index))
+    {
+      std::cout << "ERROR: Machine::onAsyncEffect, transition \"" << in_transition_name << "\" not found." << std::endl;
+      return false;
+    }
+  
+  // Only the regions firing a transition that leaves its starting state launch asynchronous effects, 
+  // the other transitions are fired on the way (eg: initializations, branches, flattened junctions).
+  auto transition = this->_addedTransitions[transition_symbol];
+  auto starting_state = (transition->startingStates() == 1) ? this->findState(transition->startingSymbol(0)) : nullptr;
+  auto reached_state = (transition->reachableStates() == 1) ? this->findState(transition->reachableSymbol(0)) : nullptr;
+  if ((transition->startingStates() == 1 && !starting_state) || (transition->reachableStates() == 1 && !reached_state))
+    {
+      std::cout << "ERROR: Machine::onAsyncEffect, states of transition \"" << in_transition_name << "\" not found." << std::endl;
+      return false;
+    }
+  if (transition->kind() == TransitionKind::Internal ||
+      (transition->kind() == TransitionKind::Local && starting_state && starting_state->kind() == StateKind::Composite) ||
+      (starting_state && (starting_state->kind() == StateKind::Initial || starting_state->kind() == StateKind::Choice ||
+			  starting_state->kind() == StateKind::Junction)) ||
+      (reached_state && reached_state->kind() == StateKind::Junction))
+    {
+      std::cout << "ERROR: Machine::onAsyncEffect, transition \"" << in_transition_name << "\" can't suspend its region." << std::endl;
+      return false;
+    }
+  this->_callbacks->setAsyncEffect(transition_index, std::move(in_effect));
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Machine::onDo(const char *in_state_name, DoActivity in_activity)
+{
+  Symbol state_symbol;
+  std::size_t state_index;
+  if (!SymbolTable::find(in_state_name, state_symbol) || !this->_callbacks->findState(state_symbol, state_index))
+    {
+      std::cout << "ERROR: Machine::onDo, state \"" << in_state_name << "\" not found." << std::endl;
+      return false;
+    }
+  this->_callbacks->setActivity(state_index, std::move(in_activity));
+  return true;
 }
 
 // -----------------------------------------------------------------------------------
 bool Machine::addSubmachine(const char *in_region_name, Machine &in_machine)
 {
   RegionsComponent regions_component = in_machine.regionsComponent();
-  auto state = std::make_shared<CompositeState>(in_machine.name()->c_str(), regions_component);
+  auto state = this->create<CompositeState>(in_machine.name()->c_str(), regions_component);
   if (!this->addState(in_region_name, state))
     {
       std::cout << "ERROR: Machine::addSubmachine, adding submachine failed." << std::endl;
@@ -257,26 +569,26 @@ bool Machine::addSubmachine(const char *in_region_name, Machine &in_machine)
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<Region> Machine::findRegion(std::shared_ptr<std::string> in_region_name) const
+std::shared_ptr<Region> Machine::findRegion(Symbol in_region_symbol) const
 {
-  auto region = this->RegionsComponent::findRegion(in_region_name);  
+  auto region = this->RegionsComponent::findRegion(in_region_symbol);  
 
 #ifdef WARNING
   if (!region)
-    std::cout << "WARNING: Machine::findRegion, region \"" << *in_region_name << "\" not found." << std::endl;
+    std::cout << "WARNING: Machine::findRegion, region \"" << *SymbolTable::name(in_region_symbol) << "\" not found." << std::endl;
 #endif
 
   return region; 
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<SimpleState> Machine::findState(std::shared_ptr<std::string> in_state_name) const
+std::shared_ptr<SimpleState> Machine::findState(Symbol in_state_symbol) const
 {
-  auto state = this->RegionsComponent::findState(in_state_name);
+  auto state = this->RegionsComponent::findState(in_state_symbol);
   
 #ifdef WARNING
   if (!state)
-    std::cout << "WARNING: Machine::findState, state \"" << *in_state_name << "\" not found." << std::endl;
+    std::cout << "WARNING: Machine::findState, state \"" << *SymbolTable::name(in_state_symbol) << "\" not found." << std::endl;
 #endif
   
   return state;
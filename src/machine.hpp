@@ -31,9 +31,15 @@
 
 #include "transitions.hpp"
 #include "states.hpp"
+#include "guards.hpp"
+#include "ringbuffer.hpp"
 
-#include <utility> // move
+#include <utility> // move, forward
+#include <functional>
 #include <memory>
+#include <vector>
+#include <algorithm> // find
+#include <unordered_map>
 
 namespace fisa
 {
@@ -79,7 +85,174 @@ namespace fisa
     //! The method checks, each time it is called, fired transitions and changes machine's regions active state consequently.
     bool run();
 
+    //! Runs the machine until no more transition is fired and no signal is pending, or until "in_max_steps" microsteps have been done.
+    /**
+     * Each microstep is equivalent to a call of the "run" method that changes the machine's 
+     * configuration (the first call initializes the machine). Returns the number of microsteps 
+     * done, or -1 if a run failed.
+     **/
+    int runUntilStable(int in_max_steps);
+
+    //! Sets the policy that resolves the conflicts between transitions starting from a same state.
+    /**
+     * The policy is applied before the machine's first run, when transitions are sorted and 
+     * checked for conflicts. ConflictPolicy::PriorityWins is the default policy.
+     * See also Transition's "setPriority" method.
+     **/
+    void setConflictPolicy(ConflictPolicy in_policy);
+
+    //! Returns the policy that resolves the conflicts between transitions.
+    ConflictPolicy conflictPolicy() const;
+
+    //! Retrieves the earliest time at which a TimeEvent of the active states' transitions triggers.
+    /** 
+     * The time is given in microseconds since 1970 (see DateTime's "toMicroseconds" method), 
+     * so that a driver (eg: an EventLoop) can sleep until then instead of polling the machine. 
+     * Returns false if no TimeEvent is pending.
+     **/
+    bool nextDeadline(long long int &out_microseconds) const;
+
+    //! Sets the executor on which the do-activities of the states are launched.
+    /** Without executor, the do-activities are launched on the pool returned by ThreadPool's "shared" method. **/
+    void setExecutor(std::shared_ptr<Executor> in_executor);
+
+    //! Sets the function called, from any thread, when the machine has to be run without having been sent a signal.
+    /**
+     * The function is called when a do-activity returns, so that its completion transitions are 
+     * fired without waiting for another event, and when an asynchronous effect resumes, so that 
+     * its target is reached. It is set by the driver the machine is added to 
+     * (eg: EventLoop, Scheduler), an empty function removes it.
+     **/
+    void setWakeUp(std::function<void()> in_wake_up);
+
+    //! Sends a signal with the payload specified in argument to the machine.
+    /**
+     * Signals are queued and dispatched one per call of the "run" method, in the order they 
+     * have been sent, to the SignalEvent<P> triggers of the active states' transitions.
+     * A signal that triggers no transition is discarded, unless an active state defers it 
+     * (see SimpleState's "defer" method).
+     **/
+    template<typename P>
+    void send(const P &in_payload)
+    {
+      this->_signals.pushBack(std::make_shared<const PayloadSignal<P> >(in_payload));
+    }
+
+    //! Sends to the machine a signal that has already been built (eg: by an EventLoop).
+    void sendSignal(std::shared_ptr<const Signal> in_signal);
+
+    //! Returns the number of signals waiting to be dispatched.
+    std::size_t pendingSignals() const;
+
+    //! Returns the number of deferred signals, waiting for the machine to change of state.
+    std::size_t deferredSignals() const;
+
+    //! Begins an update of the machine's inputs.
+    /**
+     * Variables changed with the "set" method are then only applied, all together, by the 
+     * "commitUpdate" method, so that transitions never observe half-applied inputs.
+     **/
+    void beginUpdate();
+
+    //! Changes the value of the variable specified in first argument.
+    /** During an update, the value is staged until "commitUpdate" is called. **/
+    template<typename T>
+    void set(const Variable<T> &in_variable, const T &in_value)
+    {
+      if (!this->_isUpdating)
+	{
+	  in_variable.set(in_value);
+	  return;
+	}
+      auto variables = in_variable.variables();
+      if (std::find(this->_updatedVariables.begin(), this->_updatedVariables.end(), variables) == this->_updatedVariables.end())
+	this->_updatedVariables.push_back(variables);
+      variables->stage(in_variable.index(), in_value);
+    }
+
+    //! Applies the changes of the update, then runs the machine once.
+    /** Signals sent during the update are dispatched from this run. Returns the result of the run. **/
+    bool commitUpdate();
+
+    //! Changes the value of the machine's variable with name specified in first argument.
+    /** Only the guards that read the variable are checked again. **/
+    bool setVariable(const char *in_variable_name, double in_value);
+
+    //! Retrieves the value of the machine's variable with name specified in first argument.
+    bool variableValue(const char *in_variable_name, double &out_value) const;
+
   protected: 
+    //! Allocates the machine's object graph in a per-machine Arena.
+    /**
+     * Should be called at the beginning of "build". Regions, and objects created with the 
+     * "create" method, are then allocated in contiguous chunks of the size specified in 
+     * argument, which are released together when the last object of the machine is destroyed.
+     **/
+    void useArena(std::size_t in_chunk_size = 65536);
+
+    //! Returns the regions of the machine.
+    const std::vector<std::shared_ptr<Region> >& regions() const {return this->_regions;}
+
+    //! Returns the callback tables of the machine.
+    std::shared_ptr<const Callbacks> callbacks() const {return this->_callbacks;}
+
+    //! Creates a state, a transition, an event, ... with the arguments of its constructor.
+    /**
+     * The object is allocated in the machine's arena if "useArena" has been called, and 
+     * on the heap otherwise. Regions of a created CompositeState are allocated in the arena as well.
+     **/
+    template<typename T, typename... Args>
+    std::shared_ptr<T> create(Args&&... in_args)
+    {
+      if (!this->_arena) return std::make_shared<T>(std::forward<Args>(in_args)...);
+      auto object = std::allocate_shared<T>(ArenaAllocator<T>(this->_arena), std::forward<Args>(in_args)...);
+      this->bindArena(object.get());
+      return object;
+    }
+
+    //! Declares a variable of type T of the machine with the name and initial value specified in argument.
+    /**
+     * Returns a handle of the variable, which events (see ChangeEvent's "bind" method), guards 
+     * and actions keep to read and change it. If the variable is already declared, its value is 
+     * left unchanged, and an invalid handle is returned if it has been declared with another type.
+     **/
+    template<typename T>
+    Variable<T> declare(const char *in_variable_name, const T &in_initial_value)
+    {
+      std::size_t index;
+      auto variables = this->_expressions->variables();
+      if (!variables->declare(SymbolTable::intern(in_variable_name), in_initial_value, index))
+	{
+	  std::cout << "ERROR: Machine::declare, variable \"" << in_variable_name <<
+	    "\" already declared with another type." << std::endl;
+	  return Variable<T>();
+	}
+      return Variable<T>(variables, index);
+    }
+    
+    //! Declares a variable of the machine with the name and initial value specified in argument.
+    /**
+     * Returns an expression reading the variable, to build guards with the "guard" method. 
+     * If the variable is already declared, with any arithmetic type, its value is left unchanged.
+     **/
+    Expression variable(const char *in_variable_name, double in_initial_value = 0.);
+
+    //! Returns an expression reading the arithmetic variable specified in argument.
+    template<typename T>
+    Expression variable(const Variable<T> &in_variable)
+    {
+      static_assert(std::is_arithmetic<T>::value, "Guards only read arithmetic variables.");
+      return Expression(this->_expressions, this->_expressions->node(Operation::Variable, static_cast<std::uint32_t>(in_variable.index())));
+    }
+
+    //! Creates a GuardEvent from the expression specified in argument.
+    /**
+     * The event can be set as the trigger or as the guard of a transition, and it is checked 
+     * again only when a variable read by the expression changes. Identical sub-expressions 
+     * are shared by all guards of the machine and computed once.
+     **/
+    std::shared_ptr<GuardEvent> guard(const Expression &in_expression);
+
     //! Adding a new region within the machine.
     /**
      * See also Region.
@@ -88,7 +261,7 @@ namespace fisa
 
     //! Adding a state within a region of the machine.
     /**
-     * See also SimpleState, InitialState, FinalState, TerminateState and CompositeState.
+     * See also SimpleState, InitialState, FinalState, TerminateState, ChoiceState, JunctionState and CompositeState.
      **/
     bool addState(const char *in_region_name, std::shared_ptr<SimpleState> in_state);
 
@@ -101,6 +274,50 @@ namespace fisa
     //! Adding a fork compound transition within the machine.
     bool addFork(const char *in_outermost_reachable_state_name, std::shared_ptr<Fork> in_fork);
     
+    //! Binds a callback called when the state with the name specified in first argument is reached.
+    /**
+     * The callback is any callable object without argument (eg: a lambda), called after the 
+     * state's "entry" method. Callbacks are stored in the machine's tables, indexed by state, 
+     * so that states don't need to be subclassed to implement their behavior. 
+     * The state must have been added to the machine.
+     **/
+    bool onEntry(const char *in_state_name, Callback in_callback);
+
+    //! Binds a callback called when the state with the name specified in first argument is left.
+    /** The callback is called after the state's "exit" method. **/
+    bool onExit(const char *in_state_name, Callback in_callback);
+
+    //! Binds a callback called when the transition with the name specified in first argument is fired.
+    /** The callback is called after the transition's "effect" method. The transition must have been added to the machine. **/
+    bool onEffect(const char *in_transition_name, Callback in_callback);
+
+    //! Binds an asynchronous effect launched when the transition with the name specified in first argument is fired.
+    /**
+     * The effect is launched after the "effect" method and the effect callback, once the 
+     * starting state has been left. It starts its work (eg: a socket write, a disk flush) and 
+     * calls the Resume object it receives when the work has completed, from any thread. 
+     * Meanwhile the region of the transition is suspended and the other regions keep running; 
+     * the target is reached on the first run after the effect has resumed, which the driver of 
+     * the machine is woken up for (see the "setWakeUp" method). Suspensions take their frame 
+     * from a pool of the machine, so that they don't allocate memory.
+     * The transition and its states must have been added to the machine. Only a transition that 
+     * leaves its starting state can suspend its region: the binding is rejected for internal 
+     * transitions, local transitions of a composite state, transitions starting from an initial, 
+     * choice or junction pseudostate, and transitions reaching a junction pseudostate.
+     **/
+    bool onAsyncEffect(const char *in_transition_name, AsyncEffect in_effect);
+
+    //! Binds a do-activity launched when the state with the name specified in first argument is reached.
+    /**
+     * The do-activity runs on the machine's executor, so that long work doesn't block the "run" 
+     * method. It is cancelled when the state is left, and should check the "cancelled" method of 
+     * the Activity it receives. The state is completed once the do-activity has returned: its 
+     * completion transitions (see CompletionEvent) are fired by the next run of the machine, 
+     * which the driver of the machine is woken up for (see the "setWakeUp" method).
+     * The state must have been added to the machine.
+     **/
+    bool onDo(const char *in_state_name, DoActivity in_activity);
+
     //! Adding a submachine within a region of the machine.
     /**
      * The Machine specified in input argument must contains a least one Region with states and transitions 
@@ -109,15 +326,29 @@ namespace fisa
     bool addSubmachine(const char *in_region_name, Machine &in_machine);
 
   private:    
+    //! Does one step of the machine. "out_fired" is set if the configuration of the machine has changed.
+    bool step(bool &out_fired);
+
+    void bindArena(RegionsComponent *in_regions_component) {in_regions_component->useArena(this->_arena);}
+    void bindArena(const void *in_object) {}
+
     //! Specializes RegionsComponent's "findRegion" method.
-    std::shared_ptr<Region> findRegion(std::shared_ptr<std::string> in_region_name) const;    
+    std::shared_ptr<Region> findRegion(Symbol in_region_symbol) const;    
     
     //! Specializes RegionsComponent's "findState" method.
-    std::shared_ptr<SimpleState> findState(std::shared_ptr<std::string> in_state_name) const;
+    std::shared_ptr<SimpleState> findState(Symbol in_state_symbol) const;
     
     bool _isInitiated;
     bool _isTerminated;
-    std::shared_ptr<std::string> _machineName;
+    Symbol _machineSymbol;
+    RingBuffer<std::shared_ptr<const Signal> > _signals;
+    RingBuffer<std::shared_ptr<const Signal> > _deferredSignals;
+    std::shared_ptr<Expressions> _expressions;
+    bool _isUpdating;
+    std::vector<std::shared_ptr<Variables> > _updatedVariables; // Stores with values staged by the update.
+    ConflictPolicy _conflictPolicy;
+    std::shared_ptr<Callbacks> _callbacks;
+    std::unordered_map<Symbol, std::shared_ptr<Transition> > _addedTransitions; // Checked when an asynchronous effect is bound.
   };
 }
 
@@ -0,0 +1,133 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef RINGBUFFER_HPP
+#define RINGBUFFER_HPP
+
+#include <algorithm> // min
+#include <cstddef> // size_t
+#include <vector>
+#include <utility> // move
+
+namespace fisa
+{
+  //#########################################################################################################
+  /*
+    RingBuffer
+  */
+  //! Double-ended queue stored in a circular array.
+  /**
+   * The capacity is a power of two, which is doubled when the buffer is full, so that items 
+   * are pushed and popped without allocation once the buffer has reached its working size.
+   **/
+  
+  template<typename T>
+  class RingBuffer
+  {
+  public:
+    //! Construct a buffer with the initial capacity specified in argument, rounded up to a power of two.
+    RingBuffer(std::size_t in_capacity = 16) : _head(0), _size(0)
+    {
+      std::size_t capacity = 1;
+      while (capacity < in_capacity) capacity <<= 1;
+      this->_items.resize(capacity);
+    }
+
+    //! Returns true if the buffer is empty.
+    bool empty() const {return this->_size == 0;}
+
+    //! Returns the number of items.
+    std::size_t size() const {return this->_size;}
+
+    //! Returns the number of items that can be stored without allocation.
+    std::size_t capacity() const {return this->_items.size();}
+
+    //! Returns the first item.
+    T& front() {return this->_items[this->_head];}
+
+    //! Returns the last item.
+    T& back() {return this->_items[(this->_head + this->_size - 1) & (this->_items.size() - 1)];}
+
+    //! Returns the address of the item at the position specified in first argument, and the number of items stored contiguously from it.
+    /** Items wrap around the end of the array: all items are reached in at most two contiguous parts. **/
+    const T* contiguous(std::size_t in_position, std::size_t &out_count) const
+    {
+      std::size_t index = (this->_head + in_position) & (this->_items.size() - 1);
+      out_count = (in_position >= this->_size) ? 0 : std::min(this->_size - in_position, this->_items.size() - index);
+      return this->_items.data() + index;
+    }
+
+    //! Adds an item at the end.
+    void pushBack(T in_item)
+    {
+      if (this->_size == this->_items.size()) this->grow();
+      this->_items[(this->_head + this->_size) & (this->_items.size() - 1)] = std::move(in_item);
+      this->_size++;
+    }
+
+    //! Adds an item at the beginning.
+    void pushFront(T in_item)
+    {
+      if (this->_size == this->_items.size()) this->grow();
+      this->_head = (this->_head + this->_items.size() - 1) & (this->_items.size() - 1);
+      this->_items[this->_head] = std::move(in_item);
+      this->_size++;
+    }
+
+    //! Removes the first item.
+    void popFront()
+    {
+      this->_items[this->_head] = T();
+      this->_head = (this->_head + 1) & (this->_items.size() - 1);
+      this->_size--;
+    }
+
+    //! Removes the last item.
+    void popBack()
+    {
+      this->back() = T();
+      this->_size--;
+    }
+    
+  private:
+    void grow()
+    {
+      std::vector<T> items(this->_items.size() * 2);
+      for (std::size_t i = 0; i < this->_size; i++)
+	items[i] = std::move(this->_items[(this->_head + i) & (this->_items.size() - 1)]);
+      this->_items.swap(items);
+      this->_head = 0;
+    }
+    
+    std::vector<T> _items;
+    std::size_t _head;
+    std::size_t _size;
+  };
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "scheduler.hpp"
+
+#include <chrono>
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  Scheduler
+*/
+
+// -----------------------------------------------------------------------------------
+Scheduler::Scheduler(int in_max_steps) : _maxSteps(in_max_steps), _sequence(0), _isStopped(false)
+{
+}
+
+// -----------------------------------------------------------------------------------
+Scheduler::~Scheduler()
+{
+  for (auto it = this->_machines.begin(); it != this->_machines.end(); it++)
+    it->first->setWakeUp(nullptr);
+}
+
+// -----------------------------------------------------------------------------------
+bool Scheduler::add(Machine &io_machine)
+{
+  if (this->_machines.find(&io_machine) != this->_machines.end())
+    {
+      std::cout << "ERROR: Scheduler::add, machine \"" << *io_machine.name() << "\" already added." << std::endl;
+      return false;
+    }
+  this->_machines[&io_machine] = 0;
+  Machine *machine = &io_machine;
+  io_machine.setWakeUp([this, machine]() {this->wake(machine);});
+  return this->step(&io_machine, this->now());
+}
+
+// -----------------------------------------------------------------------------------
+bool Scheduler::remove(Machine &io_machine)
+{
+  auto found = this->_machines.find(&io_machine);
+  if (found == this->_machines.end())
+    {
+      std::cout << "ERROR: Scheduler::remove, machine \"" << *io_machine.name() << "\" not found." << std::endl;
+      return false;
+    }
+  // Its deadline is left in the queue, it is dropped when it reaches the top.
+  this->_machines.erase(found);
+  io_machine.setWakeUp(nullptr);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Scheduler::reschedule(Machine &io_machine)
+{
+  if (this->_machines.find(&io_machine) == this->_machines.end())
+    {
+      std::cout << "ERROR: Scheduler::reschedule, machine \"" << *io_machine.name() << "\" not added." << std::endl;
+      return false;
+    }
+  return this->step(&io_machine, this->now());
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t Scheduler::size() const
+{
+  return this->_machines.size();
+}
+
+// -----------------------------------------------------------------------------------
+bool Scheduler::nextDeadline(long long int &out_microseconds)
+{
+  this->prune();
+  if (this->_deadlines.empty()) return false;
+  out_microseconds = this->_deadlines.top()._microseconds;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+int Scheduler::dispatch()
+{
+  long long int before = this->now();
+  if (before < 0) return -1;
+  
+  // Woken machines are run first, then queued at their next deadline.
+  std::vector<Machine*> woken;
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    woken.swap(this->_woken);
+  }
+  int stepped = 0;
+  for (auto it = woken.begin(); it != woken.end(); it++)
+    {
+      auto found = this->_machines.find(*it);
+      if (found == this->_machines.end()) continue;
+      found->second = 0;
+      if (!this->step(*it, before)) return -1;
+      stepped++;
+    }
+  
+  this->prune();
+  while (!this->_deadlines.empty() && this->_deadlines.top()._microseconds <= before)
+    {
+      auto machine = this->_deadlines.top()._machine;
+      this->_deadlines.pop();
+      this->_machines[machine] = 0;
+      if (!this->step(machine, before)) return -1;
+      stepped++;
+      this->prune();
+    }
+  return stepped;
+}
+
+// -----------------------------------------------------------------------------------
+int Scheduler::poll(int in_timeout)
+{
+  long long int deadline;
+  if (this->nextDeadline(deadline))
+    {
+      long long int delay = (deadline - this->now() + 999) / 1000;
+      if (delay < 0) delay = 0;
+      if (in_timeout < 0 || delay < in_timeout) in_timeout = static_cast<int>(delay);
+    }
+
+  if (in_timeout != 0)
+    {
+      std::unique_lock<std::mutex> lock(this->_mutex);
+      auto is_woken = [this]() {return this->_isStopped.load() || !this->_woken.empty();};
+      if (in_timeout < 0) this->_wakeUp.wait(lock, is_woken);
+      else this->_wakeUp.wait_for(lock, std::chrono::milliseconds(in_timeout), is_woken);
+    }
+  return this->dispatch();
+}
+
+// -----------------------------------------------------------------------------------
+bool Scheduler::run()
+{
+  this->_isStopped = false;
+  while (!this->_isStopped)
+    if (this->poll(-1) < 0) return false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void Scheduler::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_isStopped = true;
+  }
+  this->_wakeUp.notify_all();
+}
+
+// -----------------------------------------------------------------------------------
+void Scheduler::wake(Machine *in_machine)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_woken.push_back(in_machine);
+  }
+  this->_wakeUp.notify_all();
+}
+
+// -----------------------------------------------------------------------------------
+void Scheduler::setClock(std::function<long long int()> in_clock)
+{
+  this->_clock = in_clock;
+}
+
+// -----------------------------------------------------------------------------------
+bool Scheduler::step(Machine *in_machine, long long int in_before)
+{
+  int steps = in_machine->runUntilStable(this->_maxSteps);
+  if (steps < 0)
+    {
+      std::cout << "ERROR: Scheduler::step, machine \"" << *in_machine->name() << "\" run failed." << std::endl;
+      return false;
+    }
+  // A run stopped by the step cap goes on at the next dispatch, without waiting for a deadline.
+  if (steps >= this->_maxSteps || in_machine->pendingSignals() > 0) this->wake(in_machine);
+  
+  // A deadline reached before the run has been checked by the run, it is not waited for anymore.
+  Deadline deadline;
+  if (!in_machine->nextDeadline(deadline._microseconds) || deadline._microseconds <= in_before)
+    {
+      this->_machines[in_machine] = 0;
+      return true;
+    }
+  deadline._sequence = ++this->_sequence;
+  deadline._machine = in_machine;
+  this->_machines[in_machine] = deadline._sequence;
+  this->_deadlines.push(deadline);
+
+  // The replaced deadlines are removed once they outnumber the machines.
+  if (this->_deadlines.size() > 2 * this->_machines.size() + 64)
+    {
+      std::vector<Deadline> deadlines;
+      while (!this->_deadlines.empty())
+	{
+	  auto found = this->_machines.find(this->_deadlines.top()._machine);
+	  if (found != this->_machines.end() && found->second == this->_deadlines.top()._sequence)
+	    deadlines.push_back(this->_deadlines.top());
+	  this->_deadlines.pop();
+	}
+      this->_deadlines = std::priority_queue<Deadline, std::vector<Deadline>, Later>(Later(), std::move(deadlines));
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void Scheduler::prune()
+{
+  while (!this->_deadlines.empty())
+    {
+      auto found = this->_machines.find(this->_deadlines.top()._machine);
+      if (found != this->_machines.end() && found->second == this->_deadlines.top()._sequence) return;
+      this->_deadlines.pop();
+    }
+}
+
+// -----------------------------------------------------------------------------------
+long long int Scheduler::now() const
+{
+  if (this->_clock) return this->_clock();
+#if defined OPENSOURCE_PLATFORM_TIME
+  return OpenSourceTime::microseconds();
+#elif defined WINDOWS_PLATFORM_TIME
+  return WindowsTime::microseconds();
+#else
+  std::cout << "ERROR: Scheduler::now, time not supported." << std::endl;
+  return -1;
+#endif
+}
@@ -0,0 +1,155 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include "machine.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // size_t
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace fisa
+{
+  //#########################################################################################################
+  /*
+    Scheduler
+  */
+  //! Driver that runs machines at the deadlines of their time events.
+  /**
+   * The earliest deadline of each registered machine (see Machine's "nextDeadline" method) is 
+   * kept in a single priority queue. The machines whose deadline is reached are run in the 
+   * order of their deadlines, until they are stable, then queued again at their next deadline. 
+   * A machine is never run while none of its deadlines is reached, so that scheduling a machine 
+   * costs O(log n) for n machines whatever their number.
+   * A machine changed outside of the scheduler (eg: by a signal or a variable) must be given 
+   * to the "reschedule" method to be queued at its new deadline. A machine woken up from another 
+   * thread (see Machine's "setWakeUp" method) is run by the next dispatch.
+   * Except for the "stop" method and the wake-ups, the scheduler must be used from a single thread.
+   **/
+
+  class Scheduler
+  {
+  public:
+    //! Constructor. Each machine is run at most "in_max_steps" microsteps each time its deadline is reached.
+    /** A machine stopped by this cap is run again by the next dispatch, without waiting for a deadline. **/
+    Scheduler(int in_max_steps = 64);
+
+    //! Destructor.
+    ~Scheduler();
+
+    //! Registers a machine, which is run once then queued at its next deadline.
+    bool add(Machine &io_machine);
+
+    //! Unregisters a machine.
+    bool remove(Machine &io_machine);
+
+    //! Runs a registered machine until it is stable, then queues it at its next deadline.
+    bool reschedule(Machine &io_machine);
+
+    //! Returns the number of registered machines.
+    std::size_t size() const;
+
+    //! Retrieves the earliest deadline of the registered machines, in microseconds since 1970. Returns false if there is none.
+    bool nextDeadline(long long int &out_microseconds);
+
+    //! Runs, in the order of their deadlines, the machines whose deadline is reached.
+    /** Returns the number of machines that have been run, or -1 if an error occurred. **/
+    int dispatch();
+
+    //! Waits for at most "in_timeout" milliseconds (-1 for no limit) until the earliest deadline, then dispatches.
+    /** Returns the number of machines that have been run, or -1 if an error occurred. **/
+    int poll(int in_timeout);
+
+    //! Polls until the "stop" method is called. Returns false if an error occurred.
+    bool run();
+
+    //! Makes the "run" method return. May be called from any thread.
+    void stop();
+
+    //! Replaces the platform time by the clock specified in argument, which returns microseconds since 1970.
+    /** 
+     * The time events of the machines should be given the same clock (see RecurringEvent's 
+     * "setClock" method). The "poll" method still waits in platform time until the deadlines.
+     **/
+    void setClock(std::function<long long int()> in_clock);
+
+  private:
+    Scheduler(const Scheduler &in_scheduler);
+    Scheduler& operator = (const Scheduler &in_scheduler);
+
+    //! Deadline of a machine in the queue.
+    typedef struct Deadline
+    {
+      long long int _microseconds;
+      unsigned long long int _sequence; // Order in which the deadlines have been queued.
+      Machine *_machine;
+    } Deadline;
+
+    //! Orders the deadlines from the earliest, then from the first queued.
+    typedef struct Later
+    {
+      bool operator () (const Deadline &in_first, const Deadline &in_second) const
+      {
+	return in_first._microseconds > in_second._microseconds ||
+	  (in_first._microseconds == in_second._microseconds && in_first._sequence > in_second._sequence);
+      }
+    } Later;
+
+    //! Runs the machine and queues its next deadline.
+    bool step(Machine *in_machine, long long int in_before);
+
+    //! Queues a machine to be run by the next dispatch and wakes the "poll" method up. May be called from any thread.
+    void wake(Machine *in_machine);
+
+    //! Removes the deadlines of the top of the queue that are no longer those of their machine.
+    void prune();
+
+    //! Returns the current time in microseconds since 1970, -1 if the time isn't supported.
+    long long int now() const;
+
+    int _maxSteps;
+    unsigned long long int _sequence;
+    // Sequence of the queued deadline of each machine, 0 if it has none. Replaced deadlines are left in the queue until they reach its top.
+    std::unordered_map<Machine*, unsigned long long int> _machines;
+    std::priority_queue<Deadline, std::vector<Deadline>, Later> _deadlines;
+    std::atomic<bool> _isStopped;
+    std::mutex _mutex; // Protects the waiting of the "poll" method and the woken machines.
+    std::condition_variable _wakeUp;
+    std::vector<Machine*> _woken;
+    std::function<long long int()> _clock; // The platform time is used when empty.
+  };
+}
+
+#endif
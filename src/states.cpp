@@ -30,44 +30,128 @@
 
 using namespace fisa;
 
+//#########################################################################################################
+/*
+  ChangedEvents
+*/
+
+// -----------------------------------------------------------------------------------
+ChangedEvents::ChangedEvents() : _all(true), _capacity(0)
+{
+}
+
+// -----------------------------------------------------------------------------------
+void ChangedEvents::changed(const Event *in_event)
+{
+  if (this->_all) return;
+  // Events keep notifying while the state isn't active, so the list is bounded.
+  if (this->_pending.size() >= this->_capacity) this->markAll();
+  else this->_pending.push_back(in_event);
+}
+
+// -----------------------------------------------------------------------------------
+void ChangedEvents::setCapacity(std::size_t in_capacity)
+{
+  this->_capacity = in_capacity;
+}
+
+// -----------------------------------------------------------------------------------
+void ChangedEvents::markAll()
+{
+  this->_all = true;
+  this->_pending.clear();
+}
+
+// -----------------------------------------------------------------------------------
+void ChangedEvents::clear()
+{
+  this->_all = false;
+  this->_pending.clear();
+}
+
 //#########################################################################################################
 /*
   SimpleState
 */
 
 // -----------------------------------------------------------------------------------
-SimpleState::SimpleState(const char *in_state_name)
+SimpleState::SimpleState(const char *in_state_name) : SimpleState(in_state_name, StateKind::Simple)
+{
+}
+
+// -----------------------------------------------------------------------------------
+SimpleState::SimpleState(const char *in_state_name, StateKind in_kind) :
+  _changedEvents(std::make_shared<ChangedEvents>()), _callbacksIndex(0), _kind(in_kind)
 {
-  this->_stateName = std::make_shared<std::string>(in_state_name);
+  this->_stateSymbol = SymbolTable::intern(in_state_name);
+  this->_regionSymbol = SymbolTable::intern("");
 }
 
 // -----------------------------------------------------------------------------------
 SimpleState::~SimpleState()
 {
+  // A do-activity still running when the machine is destroyed is asked to stop as well.
+  if (this->_activity) this->_activity->cancel();
 }
 
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::string> SimpleState::name() const
 {
-  return this->_stateName;
+  return SymbolTable::name(this->_stateSymbol);
+}
+
+// -----------------------------------------------------------------------------------
+void SimpleState::setOwningRegion(Symbol in_region_symbol)
+{
+  this->_regionSymbol = in_region_symbol;
 }
 
 // -----------------------------------------------------------------------------------
-void SimpleState::setOwningRegion(std::shared_ptr<std::string> in_region_name)
+void SimpleState::setCallbacks(std::shared_ptr<const Callbacks> in_callbacks, std::size_t in_index)
 {
-  this->_regionName =  in_region_name;
+  this->_callbacks = in_callbacks;
+  this->_callbacksIndex = in_index;
 }
 
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::string> SimpleState::owningRegion() const
 {
-  return this->_regionName;
+  return SymbolTable::name(this->_regionSymbol);
 }
 
 // -----------------------------------------------------------------------------------
 bool SimpleState::addTransition(std::shared_ptr<Transition> in_transition)
 {
-  this->_transitions.push_back(in_transition);
+  auto trigger = in_transition->trigger();
+  if (trigger && trigger->isCompletion())
+    this->_completionTransitions.push_back(in_transition);
+  else if (trigger && trigger->signal())
+    this->_signalTransitions[trigger->signal()].push_back(in_transition);
+  else
+    {
+      auto index = this->_transitions.size();
+      this->_transitions.push_back(in_transition);
+      // Untriggered transitions without guard are always activated.
+      bool is_polled = !trigger && !in_transition->guard();
+      if (trigger && !this->indexChangeTransition(trigger, index)) is_polled = true;
+      if (in_transition->guard() && !this->indexChangeTransition(in_transition->guard(), index)) is_polled = true;
+      if (is_polled) this->_polledTransitions.push_back(index);
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool SimpleState::indexChangeTransition(std::shared_ptr<Event> in_event, std::vector<std::shared_ptr<Transition> >::size_type in_index)
+{
+  auto found = this->_changeTransitions.find(in_event.get());
+  if (found != this->_changeTransitions.end())
+    {
+      found->second.push_back(in_index);
+      return true;
+    }
+  if (!in_event->listen(this->_changedEvents)) return false;
+  this->_changeTransitions[in_event.get()].push_back(in_index);
+  this->_changedEvents->setCapacity(this->_changeTransitions.size());
   return true;
 }
 
@@ -81,37 +165,86 @@ bool SimpleState::addJoin(std::shared_ptr<Join> in_join)
 // -----------------------------------------------------------------------------------
 std::shared_ptr<Transition> SimpleState::fireTransition() const
 {
-#ifdef WARNING
-  std::shared_ptr<Transition> fired_transition = nullptr;
-#endif
-  for (auto it = this->_transitions.begin(); it != this->_transitions.end(); it++)
+  if (!this->_changedEvents->all())
     {
-#ifndef WARNING
-      if ((*it)->isActivated())
+      // Only transitions that are polled, or whose event has changed, can have been activated.
+      auto first = this->_transitions.size();
+      for (auto it = this->_polledTransitions.begin(); it != this->_polledTransitions.end(); it++)
+	if (this->_transitions[*it]->isActivated())
+	  {
+	    first = *it;
+	    break;
+	  }
+      auto &pending = this->_changedEvents->pending();
+      for (auto event = pending.begin(); event != pending.end(); event++)
 	{
-	  return *it;
+	  auto &indexes = this->_changeTransitions.find(*event)->second;
+	  for (auto it = indexes.begin(); it != indexes.end() && *it < first; it++)
+	    if (this->_transitions[*it]->isActivated())
+	      {
+		first = *it;
+		break;
+	      }
 	}
-#else
-      if (!fired_transition && (*it)->isActivated()) fired_transition = *it;
-      else if (fired_transition && (*it)->isActivated())
-	{
-	  std::cout << "WARNING: SimpleState::fireTransition, state \"" << *this->_stateName <<
-	    "\" has fired more than one transition." << std::endl;
-	  std::cout << "Transitions \"" << *(fired_transition->name()) << "\" and \"" <<
-	    *((*it)->name()) << "\" have been fired." << std::endl;
-	}
-#endif
+      this->_changedEvents->clear();
+      if (first < this->_transitions.size()) return this->_transitions[first];
+      return nullptr;
     }
-#ifndef WARNING
+  this->_changedEvents->clear();
+  for (auto it = this->_transitions.begin(); it != this->_transitions.end(); it++)
+    if ((*it)->isActivated()) return *it;
   return nullptr;
-#else
-  return fired_transition;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<Transition> SimpleState::dispatch(std::shared_ptr<const Signal> in_signal) const
+{
+  auto found = this->_signalTransitions.find(in_signal->id());
+  if (found == this->_signalTransitions.end()) return nullptr;
+  for (auto it = found->second.begin(); it != found->second.end(); it++)
+    if ((!(*it)->guard() || (*it)->guard()->happened()) && (*it)->trigger()->consume(in_signal))
+      {
+#ifdef DEBUG
+	std::cout << "DEBUG: SimpleState::dispatch, signal consumed by transition \"" <<
+	  *((*it)->name()) << "\"." << std::endl;
 #endif
+	return *it;
+      }
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<Transition> SimpleState::fireCompletion() const
+{
+  if (this->_completionTransitions.empty() || !this->isCompleted()) return nullptr;
+  for (auto it = this->_completionTransitions.begin(); it != this->_completionTransitions.end(); it++)
+    if (!(*it)->guard() || (*it)->guard()->happened())
+      return *it;
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------------
+bool SimpleState::isCompleted() const
+{
+  return !this->_activity || this->_activity->finished();
+}
+
+// -----------------------------------------------------------------------------------
+void SimpleState::defer(SignalId in_signal)
+{
+  if (!this->defers(in_signal)) this->_deferredSignals.push_back(in_signal);
+}
+
+// -----------------------------------------------------------------------------------
+bool SimpleState::defers(SignalId in_signal) const
+{
+  return std::find(this->_deferredSignals.begin(), this->_deferredSignals.end(), in_signal) != this->_deferredSignals.end();
 }
 
 // -----------------------------------------------------------------------------------
 bool SimpleState::init()
 {
+  this->_changedEvents->markAll();
   for (auto it = this->_transitions.begin(); it != this->_transitions.end(); it++)
     if (!(*it)->init())
       {
@@ -125,20 +258,68 @@ bool SimpleState::init()
 	std::cout << "DEBUG: SimpleState::init, transition \"" << *((*it)->name()) << "\" initialization." << std::endl;
 #endif
       }
+  for (auto it = this->_signalTransitions.begin(); it != this->_signalTransitions.end(); it++)
+    for (auto transition = it->second.begin(); transition != it->second.end(); transition++)
+      if (!(*transition)->init())
+	{
+	  std::cout << "ERROR: SimpleState::init, transition \"" << *((*transition)->name()) <<
+	    "\" initialization failed." << std::endl;
+	  return false;
+	}
+  for (auto it = this->_completionTransitions.begin(); it != this->_completionTransitions.end(); it++)
+    if (!(*it)->init())
+      {
+	std::cout << "ERROR: SimpleState::init, transition \"" << *((*it)->name()) <<
+	  "\" initialization failed." << std::endl;
+	return false;
+      }
   this->entry();
+  if (!this->_callbacks) return true;
+  this->_callbacks->entry(this->_callbacksIndex);
+
+  // The do-activity is launched after the entry, and runs until it returns or the state is left.
+  auto do_activity = this->_callbacks->activity(this->_callbacksIndex);
+  if (do_activity)
+    {
+      auto executor = this->_callbacks->executor();
+      if (!executor) executor = ThreadPool::shared();
+      auto activity = std::make_shared<Activity>();
+      DoActivity function = *do_activity;
+      auto wake_up = this->_callbacks->wakeUp();
+      this->_activity = activity;
+      executor->post([function, activity, wake_up]()
+		     {
+		       if (!activity->cancelled()) function(*activity);
+		       activity->finish();
+		       // The state is completed, the machine is run again by its driver.
+		       if (!activity->cancelled()) wake_up->notify();
+		     });
+    }
   return true;
 }
 
 // -----------------------------------------------------------------------------------
-bool SimpleState::initFork(std::shared_ptr<std::vector<std::string> > in_states_names)
+bool SimpleState::initFork(std::shared_ptr<std::vector<Symbol> > in_states_names)
 {
   return false;
 }
 
+// -----------------------------------------------------------------------------------
+bool SimpleState::resume()
+{
+  return this->init();
+}
+
 // -----------------------------------------------------------------------------------
 bool SimpleState::finalize()
 {
+  if (this->_activity)
+    {
+      this->_activity->cancel();
+      this->_activity = nullptr;
+    }
   this->exit();
+  if (this->_callbacks) this->_callbacks->exit(this->_callbacksIndex);
   return true;
 }
 
@@ -152,7 +333,7 @@ bool SimpleState::run(RegionInfo &io_region_info)
 void SimpleState::entry() const
 {
 #ifdef DEBUG
-  std::cout << "DEBUG: SimpleState::entry, state \"" << *this->_stateName << "\"." << std::endl;
+  std::cout << "DEBUG: SimpleState::entry, state \"" << *this->name() << "\"." << std::endl;
 #endif
 }
 
@@ -160,39 +341,179 @@ void SimpleState::entry() const
 void SimpleState::exit() const
 {
 #ifdef DEBUG
-  std::cout << "DEBUG: SimpleState::exit, state \"" << *this->_stateName << "\"." << std::endl;
+  std::cout << "DEBUG: SimpleState::exit, state \"" << *this->name() << "\"." << std::endl;
 #endif
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<Region> SimpleState::findRegion(std::shared_ptr<std::string> in_region_name) const
+std::shared_ptr<Region> SimpleState::findRegion(Symbol in_region_symbol) const
 {
   return nullptr;
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<SimpleState> SimpleState::findState(std::shared_ptr<std::string> in_state_name) const
+std::shared_ptr<SimpleState> SimpleState::findState(Symbol in_state_symbol) const
 {
   return nullptr;
 }
 
 // -----------------------------------------------------------------------------------
-bool SimpleState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller) const
+bool SimpleState::checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller) const
 {
-  auto it = std::find(in_states_names->begin(), in_states_names->end(), *this->_stateName);
+  auto it = std::find(in_states_names->begin(), in_states_names->end(), this->_stateSymbol);
   if (it != in_states_names->end())
     return true;
   else
     return false;								      
 }
 
+// -----------------------------------------------------------------------------------
+bool SimpleState::resolveConflicts(ConflictPolicy in_policy)
+{
+  if (in_policy != ConflictPolicy::FirstWins) this->sortTransitions();
+  bool is_ok = this->checkConflicts(this->_transitions, in_policy);
+  for (auto it = this->_signalTransitions.begin(); it != this->_signalTransitions.end(); it++)
+    is_ok = this->checkConflicts(it->second, in_policy) && is_ok;
+  is_ok = this->checkConflicts(this->_completionTransitions, in_policy) && is_ok;
+  return is_ok;
+}
+
+// -----------------------------------------------------------------------------------
+void SimpleState::sortTransitions()
+{
+  typedef std::vector<std::shared_ptr<Transition> >::size_type Index;
+  std::vector<Index> order(this->_transitions.size());
+  for (Index i = 0; i < order.size(); i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [this](Index in_a, Index in_b)
+		   {return this->_transitions[in_a]->priority() > this->_transitions[in_b]->priority();});
+
+  // The indexes of the polled and notified transitions follow the transitions to their sorted position.
+  std::vector<Index> position(order.size());
+  std::vector<std::shared_ptr<Transition> > transitions(order.size());
+  for (Index i = 0; i < order.size(); i++)
+    {
+      position[order[i]] = i;
+      transitions[i] = this->_transitions[order[i]];
+    }
+  this->_transitions.swap(transitions);
+  for (auto it = this->_polledTransitions.begin(); it != this->_polledTransitions.end(); it++)
+    *it = position[*it];
+  std::sort(this->_polledTransitions.begin(), this->_polledTransitions.end());
+  for (auto it = this->_changeTransitions.begin(); it != this->_changeTransitions.end(); it++)
+    {
+      for (auto jt = it->second.begin(); jt != it->second.end(); jt++)
+	*jt = position[*jt];
+      std::sort(it->second.begin(), it->second.end());
+    }
+
+  auto by_priority = [](const std::shared_ptr<Transition> &in_a, const std::shared_ptr<Transition> &in_b)
+    {return in_a->priority() > in_b->priority();};
+  for (auto it = this->_signalTransitions.begin(); it != this->_signalTransitions.end(); it++)
+    std::stable_sort(it->second.begin(), it->second.end(), by_priority);
+  std::stable_sort(this->_completionTransitions.begin(), this->_completionTransitions.end(), by_priority);
+}
+
+// -----------------------------------------------------------------------------------
+bool SimpleState::checkConflicts(const std::vector<std::shared_ptr<Transition> > &in_transitions, ConflictPolicy in_policy) const
+{
+#ifndef WARNING
+  if (in_policy != ConflictPolicy::ErrorOnConflict) return true;
+#endif
+  bool is_ok = true;
+  for (auto it = in_transitions.begin(); it != in_transitions.end(); it++)
+    for (auto jt = it + 1; jt != in_transitions.end(); jt++)
+      {
+	auto trigger = (*it)->trigger();
+	auto other_trigger = (*jt)->trigger();
+	bool same_trigger = trigger == other_trigger ||
+	  (trigger && other_trigger && ((trigger->signal() && trigger->signal() == other_trigger->signal()) ||
+					(trigger->isCompletion() && other_trigger->isCompletion())));
+	bool same_guard = !(*it)->guard() || !(*jt)->guard() || (*it)->guard() == (*jt)->guard();
+	if (!same_trigger || !same_guard) continue;
+	if (in_policy != ConflictPolicy::FirstWins && (*it)->priority() != (*jt)->priority()) continue;
+	
+	if (in_policy == ConflictPolicy::ErrorOnConflict)
+	  {
+	    std::cout << "ERROR: SimpleState::checkConflicts, state \"" << *this->name() <<
+	      "\" has conflicting transitions." << std::endl;
+	    std::cout << "Transitions \"" << *((*it)->name()) << "\" and \"" << *((*jt)->name()) <<
+	      "\" have the same priority and may be activated at once." << std::endl;
+	    is_ok = false;
+	  }
+#ifdef WARNING
+	else
+	  {
+	    std::cout << "WARNING: SimpleState::checkConflicts, state \"" << *this->name() <<
+	      "\" has conflicting transitions." << std::endl;
+	    std::cout << "Transitions \"" << *((*it)->name()) << "\" and \"" << *((*jt)->name()) <<
+	      "\" may be activated at once, \"" << *((*it)->name()) << "\" is fired first." << std::endl;
+	  }
+#endif
+      }
+  return is_ok;
+}
+
+// -----------------------------------------------------------------------------------
+bool SimpleState::flattenJunctions(const Region &in_region)
+{
+  // Transitions are listed in the order they have been added, by kind of trigger.
+  std::vector<std::shared_ptr<Transition> > transitions(this->_transitions);
+  for (auto it = this->_signalTransitions.begin(); it != this->_signalTransitions.end(); it++)
+    transitions.insert(transitions.end(), it->second.begin(), it->second.end());
+  transitions.insert(transitions.end(), this->_completionTransitions.begin(), this->_completionTransitions.end());
+
+  bool has_junction = false;
+  for (auto it = transitions.begin(); it != transitions.end() && !has_junction; it++)
+    {
+      if ((*it)->reachableStates() != 1) continue;
+      auto reached_state = in_region.findStateHere((*it)->reachableSymbol(0));
+      if (reached_state && reached_state->kind() == StateKind::Junction) has_junction = true;
+    }
+  if (!has_junction) return true;
+
+  std::vector<std::shared_ptr<Transition> > flattened_transitions;
+  for (auto it = transitions.begin(); it != transitions.end(); it++)
+    if (!in_region.expandJunction(*it, flattened_transitions)) return false;
+  
+  // The indexes are built again, the listener of the replaced transitions' events is dropped with them.
+  this->_transitions.clear();
+  this->_signalTransitions.clear();
+  this->_polledTransitions.clear();
+  this->_changeTransitions.clear();
+  this->_completionTransitions.clear();
+  this->_changedEvents = std::make_shared<ChangedEvents>();
+  for (auto it = flattened_transitions.begin(); it != flattened_transitions.end(); it++)
+    this->SimpleState::addTransition(*it);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void SimpleState::earliestDeadline(long long int &io_deadline) const
+{
+  long long int deadline;
+  for (auto it = this->_transitions.begin(); it != this->_transitions.end(); it++)
+    {
+      if ((*it)->trigger() && (*it)->trigger()->deadline(deadline) && deadline < io_deadline) io_deadline = deadline;
+      if ((*it)->guard() && (*it)->guard()->deadline(deadline) && deadline < io_deadline) io_deadline = deadline;
+    }
+}
+
 // -----------------------------------------------------------------------------------
 bool SimpleState::isKind(const char *in_kind) const
 {
-  if (std::string(in_kind) == std::string("SimpleState"))
-    return true;
-  else
-    return false;
+  switch (this->_kind)
+    {
+    case StateKind::Simple: return std::strcmp(in_kind, "SimpleState") == 0;
+    case StateKind::Initial: return std::strcmp(in_kind, "InitialState") == 0;
+    case StateKind::Final: return std::strcmp(in_kind, "FinalState") == 0;
+    case StateKind::Terminate: return std::strcmp(in_kind, "TerminateState") == 0;
+    case StateKind::Composite: return std::strcmp(in_kind, "CompositeState") == 0;
+    case StateKind::ShallowHistory: return std::strcmp(in_kind, "ShallowHistoryState") == 0;
+    case StateKind::DeepHistory: return std::strcmp(in_kind, "DeepHistoryState") == 0;
+    case StateKind::Choice: return std::strcmp(in_kind, "ChoiceState") == 0;
+    case StateKind::Junction: return std::strcmp(in_kind, "JunctionState") == 0;
+    }
+  return false;
 }
 
 //#########################################################################################################
@@ -201,7 +522,7 @@ bool SimpleState::isKind(const char *in_kind) const
 */
 
 // -----------------------------------------------------------------------------------
-InitialState::InitialState(const char *in_state_name) : SimpleState(in_state_name)
+InitialState::InitialState(const char *in_state_name) : SimpleState(in_state_name, StateKind::Initial)
 {
 }
 
@@ -215,7 +536,7 @@ bool InitialState::addTransition(std::shared_ptr<Transition> in_transition)
 {
   if (this->SimpleState::_transitions.size() != 0)
     {
-      std::cout << "ERROR: InitialState::addTransition, initial state \"" << *this->_stateName <<
+      std::cout << "ERROR: InitialState::addTransition, initial state \"" << *this->name() <<
 	"\" has already one transition." << std::endl;
       std::cout << "The transition \"" << *(in_transition->name()) <<
 	"\" can't be added." << std::endl;
@@ -223,7 +544,7 @@ bool InitialState::addTransition(std::shared_ptr<Transition> in_transition)
     }
   else if (in_transition->isTriggered())
     {
-      std::cout << "ERROR: InitialState::addTransition, initial state \"" << *this->_stateName <<
+      std::cout << "ERROR: InitialState::addTransition, initial state \"" << *this->name() <<
 	"\" can't add a triggered transition." << std::endl;
       std::cout << "The transition \"" << *(in_transition->name()) << "\" is triggered." << std::endl;
       return false;
@@ -238,34 +559,32 @@ bool InitialState::addTransition(std::shared_ptr<Transition> in_transition)
 // -----------------------------------------------------------------------------------
 std::shared_ptr<Transition> InitialState::fireTransition() const
 {
-  if (this->SimpleState::_transitions.size() != 0)
+  // Once flattened, a transition to a junction pseudostate is replaced by guarded compound transitions.
+  if (this->SimpleState::_transitions.size() > 1)
+    {
+      for (auto it = this->SimpleState::_transitions.begin(); it != this->SimpleState::_transitions.end(); it++)
+	if ((*it)->isActivated()) return *it;
+      return nullptr;
+    }
+  else if (this->SimpleState::_transitions.size() != 0)
     return this->SimpleState::_transitions[0];
   else
     return nullptr;  
 }
 
 // -----------------------------------------------------------------------------------
-bool InitialState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_name, bool in_is_caller) const
+bool InitialState::checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_name, bool in_is_caller) const
 {
   return false;
 }
 
-// -----------------------------------------------------------------------------------
-bool InitialState::isKind(const char *in_kind) const
-{
-  if (std::string(in_kind) == std::string("InitialState"))
-    return true;
-  else
-    return false;
-}
-
 //#########################################################################################################
 /*
   FinalState
 */
 
 // -----------------------------------------------------------------------------------
-FinalState::FinalState(const char *in_state_name) : SimpleState(in_state_name)
+FinalState::FinalState(const char *in_state_name) : SimpleState(in_state_name, StateKind::Final)
 {
 }
 
@@ -277,7 +596,7 @@ FinalState::~FinalState()
 // -----------------------------------------------------------------------------------
 bool FinalState::addTransition(std::shared_ptr<Transition> in_transition)
 {
-  std::cout << "ERROR: FinalState::addTransition, final state \"" <<  *this->_stateName <<
+  std::cout << "ERROR: FinalState::addTransition, final state \"" <<  *this->name() <<
     "\" can't have any transition starting from it." << std::endl;
   return false;
 }
@@ -301,74 +620,238 @@ bool FinalState::finalize()
 }
 
 // -----------------------------------------------------------------------------------
-bool FinalState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller) const
+bool FinalState::checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller) const
+{
+  return false;
+}
+
+//#########################################################################################################
+/*
+  TerminateState
+*/
+
+// -----------------------------------------------------------------------------------
+TerminateState::TerminateState(const char *in_state_name) : SimpleState(in_state_name, StateKind::Terminate)
+{
+}
+
+// -----------------------------------------------------------------------------------
+TerminateState::~TerminateState()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool TerminateState::addTransition(std::shared_ptr<Transition> in_transition)
+{
+  std::cout << "ERROR: TerminateState::addTransition, terminate pseudostate \"" <<  *this->name() <<
+    "\" can't have any transition starting from it." << std::endl;
+  return false;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<Transition> TerminateState::fireTransition() const
+{
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------------
+bool TerminateState::init()
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool TerminateState::finalize()
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool TerminateState::checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller) const
+{
+  return false;
+}
+
+//#########################################################################################################
+/*
+  HistoryState
+*/
+
+// -----------------------------------------------------------------------------------
+HistoryState::HistoryState(const char *in_state_name, StateKind in_kind) : SimpleState(in_state_name, in_kind)
+{
+}
+
+// -----------------------------------------------------------------------------------
+HistoryState::~HistoryState()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool HistoryState::addTransition(std::shared_ptr<Transition> in_transition)
 {
+  std::cout << "ERROR: HistoryState::addTransition, history state \"" <<  *this->name() <<
+    "\" can't have any transition starting from it." << std::endl;
   return false;
 }
 
 // -----------------------------------------------------------------------------------
-bool FinalState::isKind(const char *in_kind) const
+std::shared_ptr<Transition> HistoryState::fireTransition() const
+{
+  return nullptr;
+}
+
+//#########################################################################################################
+/*
+  ShallowHistoryState
+*/
+
+// -----------------------------------------------------------------------------------
+ShallowHistoryState::ShallowHistoryState(const char *in_state_name) : HistoryState(in_state_name, StateKind::ShallowHistory)
+{
+}
+
+// -----------------------------------------------------------------------------------
+ShallowHistoryState::~ShallowHistoryState()
+{
+}
+
+//#########################################################################################################
+/*
+  DeepHistoryState
+*/
+
+// -----------------------------------------------------------------------------------
+DeepHistoryState::DeepHistoryState(const char *in_state_name) : HistoryState(in_state_name, StateKind::DeepHistory)
+{
+}
+
+// -----------------------------------------------------------------------------------
+DeepHistoryState::~DeepHistoryState()
+{
+}
+
+//#########################################################################################################
+/*
+  BranchState
+*/
+
+// -----------------------------------------------------------------------------------
+BranchState::BranchState(const char *in_state_name, StateKind in_kind) : SimpleState(in_state_name, in_kind)
+{
+}
+
+// -----------------------------------------------------------------------------------
+BranchState::~BranchState()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool BranchState::addTransition(std::shared_ptr<Transition> in_transition)
+{
+  if (in_transition->isTriggered())
+    {
+      std::cout << "ERROR: BranchState::addTransition, branch state \"" << *this->name() <<
+	"\" can't add a triggered transition." << std::endl;
+      std::cout << "The transition \"" << *(in_transition->name()) << "\" is triggered." << std::endl;
+      return false;
+    }
+  else if (in_transition->reachableStates() != 1)
+    {
+      std::cout << "ERROR: BranchState::addTransition, branch state \"" << *this->name() <<
+	"\" can't add a fork transition." << std::endl;
+      std::cout << "The transition \"" << *(in_transition->name()) << "\" can't be added." << std::endl;
+      return false;
+    }
+  else if (!in_transition->guard())
+    {
+      if (this->_elseBranch)
+	{
+	  std::cout << "ERROR: BranchState::addTransition, branch state \"" << *this->name() <<
+	    "\" has already an else branch \"" << *(this->_elseBranch->name()) << "\"." << std::endl;
+	  std::cout << "The transition \"" << *(in_transition->name()) << "\" can't be added." << std::endl;
+	  return false;
+	}
+      this->_elseBranch = in_transition;
+      return true;
+    }
+  // Branches are only evaluated when the pseudostate is reached, their guards are not indexed.
+  this->_transitions.push_back(in_transition);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<Transition> BranchState::fireTransition() const
+{
+  for (auto it = this->_transitions.begin(); it != this->_transitions.end(); it++)
+    if ((*it)->guard()->happened()) return *it;
+  return this->_elseBranch;
+}
+
+// -----------------------------------------------------------------------------------
+bool BranchState::init()
+{
+  for (auto it = this->_transitions.begin(); it != this->_transitions.end(); it++)
+    if (!(*it)->init()) return false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool BranchState::finalize()
 {
-  if (std::string(in_kind) == std::string("FinalState"))
-    return true;
-  else
-    return false;
+  return true;
 }
 
-//#########################################################################################################
-/*
-  TerminateState
-*/
-
 // -----------------------------------------------------------------------------------
-TerminateState::TerminateState(const char *in_state_name) : SimpleState(in_state_name)
+bool BranchState::resolveConflicts(ConflictPolicy in_policy)
 {
+  if (in_policy != ConflictPolicy::FirstWins)
+    std::stable_sort(this->_transitions.begin(), this->_transitions.end(),
+		     [](const std::shared_ptr<Transition> &in_a, const std::shared_ptr<Transition> &in_b)
+		     {return in_a->priority() > in_b->priority();});
+  return true;
 }
 
 // -----------------------------------------------------------------------------------
-TerminateState::~TerminateState()
+bool BranchState::flattenJunctions(const Region &in_region)
 {
+  return true;
 }
 
 // -----------------------------------------------------------------------------------
-bool TerminateState::addTransition(std::shared_ptr<Transition> in_transition)
+bool BranchState::checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller) const
 {
-  std::cout << "ERROR: TerminateState::addTransition, terminate pseudostate \"" <<  *this->_stateName <<
-    "\" can't have any transition starting from it." << std::endl;
   return false;
 }
 
-// -----------------------------------------------------------------------------------
-std::shared_ptr<Transition> TerminateState::fireTransition() const
-{
-  return nullptr;
-}
+//#########################################################################################################
+/*
+  ChoiceState
+*/
 
 // -----------------------------------------------------------------------------------
-bool TerminateState::init()
+ChoiceState::ChoiceState(const char *in_state_name) : BranchState(in_state_name, StateKind::Choice)
 {
-  return true;
 }
 
 // -----------------------------------------------------------------------------------
-bool TerminateState::finalize()
+ChoiceState::~ChoiceState()
 {
-  return true;
 }
 
+//#########################################################################################################
+/*
+  JunctionState
+*/
+
 // -----------------------------------------------------------------------------------
-bool TerminateState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller) const
+JunctionState::JunctionState(const char *in_state_name) : BranchState(in_state_name, StateKind::Junction)
 {
-  return false;
 }
 
 // -----------------------------------------------------------------------------------
-bool TerminateState::isKind(const char *in_kind) const
+JunctionState::~JunctionState()
 {
-  if (std::string(in_kind) == std::string("TerminateState"))
-    return true;
-  else
-    return false;
 }
 
 //#########################################################################################################
@@ -379,9 +862,10 @@ bool TerminateState::isKind(const char *in_kind) const
 // -----------------------------------------------------------------------------------
 Region::Region(const char *in_region_name)
 {
-  this->_regionName = std::make_shared<std::string>(in_region_name);
+  this->_regionSymbol = SymbolTable::intern(in_region_name);
   this->_activeState = nullptr;
   this->_startingState = nullptr;
+  this->_suspension = nullptr;
 }
 
 // -----------------------------------------------------------------------------------
@@ -392,13 +876,13 @@ Region::~Region()
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::string> Region::name() const
 {
-  return this->_regionName;
+  return SymbolTable::name(this->_regionSymbol);
 }
 
 // -----------------------------------------------------------------------------------
 void Region::addState(std::shared_ptr<SimpleState> in_state)
 {
-  if (in_state->isKind("InitialState"))
+  if (in_state->kind() == StateKind::Initial)
     this->_startingState = in_state;
   
   this->_states.push_back(in_state);
@@ -414,22 +898,23 @@ bool Region::init()
       auto fired_transition = this->_activeState->fireTransition();
       if (!fired_transition)
 	{
-	  std::cout << "ERROR: Region::init, in region \"" << *this->_regionName <<
+	  std::cout << "ERROR: Region::init, in region \"" << *this->name() <<
 	    "\" failure of the firing of a transition." << std::endl;
 	  std::cout << "Initial pseudostate \"" << *(this->_activeState->name()) <<
 	    "\" doesn't have any transition." << std::endl;
 	  return false;
 	}
-      fired_transition->effect();
+      fired_transition->fire();
       
       if (fired_transition->reachableStates() == 1)
-	this->_activeState = this->findStateHere(fired_transition->reachableState(0));
+	this->_activeState = this->findStateHere(fired_transition->reachableSymbol(0));
       else
-	this->initFork(fired_transition->reachableStatesNames());
+	this->initFork(fired_transition->reachableStatesSymbols());
+      if (this->_activeState && !this->leaveBranches()) return false;
       
       if (!this->_activeState)
 	{
-	  std::cout << "ERROR: Region::init, in region \"" << *this->_regionName <<
+	  std::cout << "ERROR: Region::init, in region \"" << *this->name() <<
 	    "\" failure of the retrieving of a state." << std::endl;	   
 	  std::cout << "State \"" << *(this->_activeState->name()) << "\" fired from transition \"" <<
 	    *(fired_transition->name()) << "\" can't be retrieved." << std::endl;
@@ -437,7 +922,7 @@ bool Region::init()
 	}
       if (!this->_activeState->init())
 	{
-	  std::cout << "ERROR: Region::init, in region \"" << *this->_regionName <<
+	  std::cout << "ERROR: Region::init, in region \"" << *this->name() <<
 	    "\" failure of the initialization of a state." << std::endl;
 	  std::cout << "State \"" << *(this->_activeState->name()) << "\" initialization failed." << std::endl;
 	  return false;
@@ -446,9 +931,9 @@ bool Region::init()
     }
   else if (this->_activeState)
     {
-      if (!this->_activeState->init())
+      if (!this->initActiveState())
 	{
-	  std::cout << "ERROR: Region::init, in region \"" << *this->_regionName <<
+	  std::cout << "ERROR: Region::init, in region \"" << *this->name() <<
 	    "\" failure of the initialization of a state." << std::endl;
 	  std::cout << "State \"" << *(this->_activeState->name()) << "\" initialization failed." << std::endl;
 	  return false;
@@ -457,14 +942,30 @@ bool Region::init()
     }
   else
     {
-      std::cout << "ERROR: Region::init, region \"" << *this->_regionName <<
+      std::cout << "ERROR: Region::init, region \"" << *this->name() <<
 	"\" doesn't have an initial pseudostate." << std::endl;
       return false;
     }
 }
 
 // -----------------------------------------------------------------------------------
-bool Region::initFork(std::shared_ptr<std::vector<std::string> > in_states_names)
+bool Region::resume()
+{
+  if (this->_activeState || !this->_lastActiveState) return this->init();
+  
+  this->_activeState = this->_lastActiveState;
+  if (!this->_activeState->resume())
+    {
+      std::cout << "ERROR: Region::resume, in region \"" << *this->name() <<
+	"\" failure of the initialization of a state." << std::endl;
+      std::cout << "State \"" << *(this->_activeState->name()) << "\" initialization failed." << std::endl;
+      return false;
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Region::initFork(std::shared_ptr<std::vector<Symbol> > in_states_names)
 {
   bool is_initialized = false;
   auto jt = in_states_names->end();
@@ -474,7 +975,7 @@ bool Region::initFork(std::shared_ptr<std::vector<std::string> > in_states_names
       if ((*it)->initFork(in_states_names)) is_initialized = true;
       else
 	{
-	  jt = std::find(in_states_names->begin(), in_states_names->end(), *((*it)->name()));
+	  jt = std::find(in_states_names->begin(), in_states_names->end(), (*it)->symbol());
 	  if (jt == in_states_names->end()) it++;
 	}
     }  
@@ -492,13 +993,23 @@ bool Region::initFork(std::shared_ptr<std::vector<std::string> > in_states_names
 // -----------------------------------------------------------------------------------
 bool Region::finalize()
 {
+  // The state has already been left by the suspended transition, whose effect is not waited for anymore.
+  if (this->_suspension)
+    {
+      this->_suspension->release();
+      this->_suspension = nullptr;
+      this->_lastActiveState = nullptr;
+      return true;
+    }
   if (!this->_activeState->finalize())
     {
-      std::cout << "ERROR: Region::finalize, in region \"" << *this->_regionName <<
+      std::cout << "ERROR: Region::finalize, in region \"" << *this->name() <<
 	"\" failure of the finalization of a state." << std::endl;
       std::cout << "State \"" << *(this->_activeState->name()) << "\" finalization failed." << std::endl;
       return false;
     }
+  // Remembered for history pseudostates, a region left from its final pseudostate is entered again from the beginning.
+  this->_lastActiveState = (this->_activeState->kind() == StateKind::Final) ? nullptr : this->_activeState;
   this->_activeState = nullptr;
   return true;
 }
@@ -506,46 +1017,124 @@ bool Region::finalize()
 // -----------------------------------------------------------------------------------
 bool Region::run(RegionInfo &io_region_info)
 {
+  // A region suspended on an asynchronous effect goes on to the target of the transition once the effect has resumed.
+  if (this->_suspension)
+    {
+      if (!this->_suspension->isResumed()) return true;
+      auto resumed_transition = this->_suspension->transition();
+      this->_suspension->release();
+      this->_suspension = nullptr;
+#ifdef DEBUG
+      std::cout << "DEBUG: Region::run, transition \"" << *(resumed_transition->name()) << "\" resumed." << std::endl;
+#endif
+      return this->enter(resumed_transition, io_region_info);
+    }
+  
   if (!this->_activeState->run(io_region_info))
     {
-      std::cout << "ERROR: Region::run, region \"" << *this->_regionName <<
+      std::cout << "ERROR: Region::run, region \"" << *this->name() <<
 	"\" run failed." << std::endl;
       return false;
     }
 
-  if (!io_region_info._transition_firing_allowed || io_region_info._is_terminated) return true;
-  auto fired_transition = this->_activeState->fireTransition();
-  if (!fired_transition) return true;
+  if (io_region_info._signal && this->_activeState->defers(io_region_info._signal->id()))
+    io_region_info._signal_deferred = true;
+  if (io_region_info._is_terminated) return true;
+  
+  // A state completed during this run fires its completion transitions even if a transition has been fired inside it.
+  std::shared_ptr<Transition> fired_transition = nullptr;
+  if (io_region_info._state_completed)
+    {
+      io_region_info._state_completed = false;
+      fired_transition = this->_activeState->fireCompletion();
+    }
+  if (!fired_transition)
+    {
+      if (!io_region_info._transition_firing_allowed) return true;
+      // A pending completion has the priority over the signal.
+      fired_transition = this->_activeState->fireCompletion();
+      if (!fired_transition && io_region_info._signal && !io_region_info._signal_consumed)
+	{
+	  fired_transition = this->_activeState->dispatch(io_region_info._signal);
+	  if (fired_transition) io_region_info._signal_consumed = true;
+	}
+      if (!fired_transition) fired_transition = this->_activeState->fireTransition();
+      if (!fired_transition) return true;
+    }
+  // The signal pre-empted by a completion is kept, like a deferred one, for the state reached.
+  if (fired_transition->trigger() && fired_transition->trigger()->isCompletion() &&
+      io_region_info._signal && !io_region_info._signal_consumed)
+    io_region_info._signal_deferred = true;
+  
+  // Internal transitions, and local transitions of a composite state, don't leave the active state.
+  if (fired_transition->kind() == TransitionKind::Internal)
+    {
+#ifdef DEBUG
+      std::cout << "DEBUG: Region::run, internal transition \"" << *(fired_transition->name()) << "\" fired." << std::endl;
+#endif
+      fired_transition->fire();
+      io_region_info._transition_fired = true;
+      return fired_transition->init();
+    }
+  if (fired_transition->kind() == TransitionKind::Local && this->_activeState->kind() == StateKind::Composite)
+    {
+      io_region_info._transition_fired = true;
+      return std::static_pointer_cast<CompositeState>(this->_activeState)->fireLocal(fired_transition);
+    }
   if (!this->_activeState->finalize())
     {
-      std::cout << "ERROR: Region::run, in region \"" << *this->_regionName <<
+      std::cout << "ERROR: Region::run, in region \"" << *this->name() <<
 	"\" failure of the finalization of a state." << std::endl;
       std::cout << "State \"" << *(this->_activeState->name()) << "\" finalization failed." << std::endl;
       return false;
     }
-  fired_transition->effect();
+  fired_transition->fire();
+
+  // The region is suspended, between the left state and the target, until the asynchronous effect resumes.
+  auto frame = fired_transition->launch();
+  if (frame && !frame->isResumed())
+    {
+#ifdef DEBUG
+      std::cout << "DEBUG: Region::run, transition \"" << *(fired_transition->name()) << "\" suspended." << std::endl;
+#endif
+      frame->hold(fired_transition);
+      this->_suspension = frame;
+      this->_activeState = nullptr;
+      io_region_info._transition_fired = true;
+      return true;
+    }
+  if (frame) frame->release();
+  return this->enter(fired_transition, io_region_info);
+}
+
+// -----------------------------------------------------------------------------------
+bool Region::enter(std::shared_ptr<Transition> in_transition, RegionInfo &io_region_info)
+{
+  auto fired_transition = in_transition;
   if (fired_transition->reachableStates() == 1)
     {
 #ifdef DEBUG
       std::cout << "DEBUG: Region::run, transition \"" << *(fired_transition->name()) << "\" fired." << std::endl;
 #endif
-      this->_activeState = this->findStateHere(fired_transition->reachableState(0));
+      this->_activeState = this->findStateHere(fired_transition->reachableSymbol(0));
     }
   else
     {
 #ifdef DEBUG
       std::cout << "DEBUG: Region::run, fork transition fired." << std::endl;
 #endif
-      this->initFork(fired_transition->reachableStatesNames());
+      this->initFork(fired_transition->reachableStatesSymbols());
     }
+  if (this->_activeState && !this->leaveBranches()) return false;
   
   if (this->_activeState)
     {
-      if (this->_activeState->isKind("TerminateState")) io_region_info._is_terminated = true;
+      if (this->_activeState->kind() == StateKind::Terminate) io_region_info._is_terminated = true;
+      else if (this->_activeState->kind() == StateKind::Final) io_region_info._final_reached = true;
       
-      if (!this->_activeState->init())
+      if (!this->initActiveState())
 	{
-	  std::cout << "ERROR: Region::run, in region \"" << *this->_regionName <<
+	  std::cout << "ERROR: Region::run, in region \"" << *this->name() <<
 	    "\" failure of the initialization of a state." << std::endl;
 	  std::cout << "State \"" << *(this->_activeState->name()) << "\" initialization failed." << std::endl;
 	  return false;
@@ -555,7 +1144,7 @@ bool Region::run(RegionInfo &io_region_info)
     }
   else
     {
-      std::cout << "ERROR: Region::run, in region \"" << *this->_regionName <<
+      std::cout << "ERROR: Region::run, in region \"" << *this->name() <<
 	"\" failure of the retrieving of a state." << std::endl;
       std::cout << "State \"" << *(this->_activeState->name()) << "\" fired from transition \"" <<
 	*(fired_transition->name()) << "\" can't be retrieved." << std::endl;
@@ -563,6 +1152,153 @@ bool Region::run(RegionInfo &io_region_info)
     }
 }
 
+// -----------------------------------------------------------------------------------
+bool Region::leaveBranches()
+{
+  while (this->_activeState->kind() == StateKind::Choice || this->_activeState->kind() == StateKind::Junction)
+    {
+      auto branch_state = this->_activeState;
+      if (!branch_state->init()) return false;
+      auto branch = branch_state->fireTransition();
+      if (!branch)
+	{
+	  std::cout << "ERROR: Region::leaveBranches, in region \"" << *this->name() <<
+	    "\" no branch can be taken." << std::endl;
+	  std::cout << "No guard is true in pseudostate \"" << *(branch_state->name()) <<
+	    "\", which doesn't have an else branch." << std::endl;
+	  return false;
+	}
+#ifdef DEBUG
+      std::cout << "DEBUG: Region::leaveBranches, branch \"" << *(branch->name()) << "\" taken." << std::endl;
+#endif
+      branch->fire();
+      this->_activeState = this->findStateHere(branch->reachableSymbol(0));
+      if (!this->_activeState) return false;
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Region::initActiveState()
+{
+  auto kind = this->_activeState->kind();
+  if (kind != StateKind::ShallowHistory && kind != StateKind::DeepHistory) return this->_activeState->init();
+
+  auto history_state = this->_activeState;
+  this->_activeState = this->_lastActiveState;
+  if (!this->_activeState)
+    {
+      // Without a last active state, the region is entered from its initial pseudostate.
+      if (this->init()) return true;
+      if (!this->_activeState) this->_activeState = history_state;
+      return false;
+    }
+#ifdef DEBUG
+  std::cout << "DEBUG: Region::initActiveState, region \"" << *this->name() << "\" restores state \"" <<
+    *(this->_activeState->name()) << "\"." << std::endl;
+#endif
+  return (kind == StateKind::DeepHistory) ? this->_activeState->resume() : this->_activeState->init();
+}
+
+// -----------------------------------------------------------------------------------
+bool Region::resolveConflicts(ConflictPolicy in_policy)
+{
+  bool is_ok = true;
+  for (auto it = this->_states.begin(); it != this->_states.end(); it++)
+    is_ok = (*it)->resolveConflicts(in_policy) && is_ok;
+  return is_ok;
+}
+
+// -----------------------------------------------------------------------------------
+bool Region::flattenJunctions()
+{
+  for (auto it = this->_states.begin(); it != this->_states.end(); it++)
+    {
+      if (!(*it)->flattenJunctions(*this))
+	{
+	  std::cout << "ERROR: Region::flattenJunctions, in region \"" << *this->name() <<
+	    "\" failure of the flattening of the junctions reached from state \"" << *((*it)->name()) << "\"." << std::endl;
+	  return false;
+	}
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void Region::earliestDeadline(long long int &io_deadline) const
+{
+  if (this->_activeState) this->_activeState->earliestDeadline(io_deadline);
+}
+
+// -----------------------------------------------------------------------------------
+bool Region::expandJunction(std::shared_ptr<Transition> in_transition, std::vector<std::shared_ptr<Transition> > &out_transitions) const
+{
+  std::shared_ptr<SimpleState> reached_state = nullptr;
+  if (in_transition->reachableStates() == 1) reached_state = this->findStateHere(in_transition->reachableSymbol(0));
+  if (!reached_state || reached_state->kind() != StateKind::Junction)
+    {
+      out_transitions.push_back(in_transition);
+      return true;
+    }
+  auto junction = std::static_pointer_cast<BranchState>(reached_state);
+  if (junction->branches().empty() && !junction->elseBranch())
+    {
+      std::cout << "ERROR: Region::expandJunction, in region \"" << *this->name() << "\" junction \"" <<
+	*(junction->name()) << "\" doesn't have any branch." << std::endl;
+      return false;
+    }
+
+  // The guard of the compound transition requires the guards of the transition and of the branch.
+  std::vector<std::shared_ptr<Event> > required;
+  if (in_transition->guard()) required.push_back(in_transition->guard());
+  std::vector<std::shared_ptr<Event> > excluded;
+  for (auto it = junction->branches().begin(); it != junction->branches().end(); it++)
+    {
+      required.push_back((*it)->guard());
+      auto compound_transition = std::make_shared<CompoundTransition>(in_transition, *it,
+								      std::make_shared<CompoundGuard>(required, excluded));
+      required.pop_back();
+      if (!this->expandJunction(compound_transition, out_transitions)) return false;
+    }
+  // The else branch is taken when none of the other branches' guards is true.
+  if (junction->elseBranch())
+    {
+      std::shared_ptr<Event> guard = in_transition->guard();
+      if (!junction->branches().empty())
+	{
+	  for (auto it = junction->branches().begin(); it != junction->branches().end(); it++)
+	    excluded.push_back((*it)->guard());
+	  guard = std::make_shared<CompoundGuard>(required, excluded);
+	}
+      auto compound_transition = std::make_shared<CompoundTransition>(in_transition, junction->elseBranch(), guard);
+      if (!this->expandJunction(compound_transition, out_transitions)) return false;
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool Region::reach(std::shared_ptr<Transition> in_transition)
+{
+  if (this->_activeState && !this->_activeState->finalize())
+    {
+      std::cout << "ERROR: Region::reach, in region \"" << *this->name() <<
+	"\" failure of the finalization of a state." << std::endl;
+      std::cout << "State \"" << *(this->_activeState->name()) << "\" finalization failed." << std::endl;
+      return false;
+    }
+  in_transition->fire();
+  this->_activeState = this->findStateHere(in_transition->reachableSymbol(0));
+  if (!this->_activeState || !this->leaveBranches()) return false;
+  if (!this->initActiveState())
+    {
+      std::cout << "ERROR: Region::reach, in region \"" << *this->name() <<
+	"\" failure of the initialization of a state." << std::endl;
+      std::cout << "State \"" << *(this->_activeState->name()) << "\" initialization failed." << std::endl;
+      return false;
+    }
+  return true;
+}
+
 // -----------------------------------------------------------------------------------
 std::shared_ptr<SimpleState> Region::activeState() const
 {
@@ -570,41 +1306,41 @@ std::shared_ptr<SimpleState> Region::activeState() const
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<SimpleState> Region::findStateHere(std::shared_ptr<std::string> in_state_name) const
+std::shared_ptr<SimpleState> Region::findStateHere(Symbol in_state_symbol) const
 {
   for (auto it = this->_states.begin(); it != this->_states.end(); it++)
     {
-      if (*((*it)->name()) == *in_state_name) return *it;
+      if ((*it)->symbol() == in_state_symbol) return *it;
     }
   
-  std::cout << "ERROR: Region::findStateHere, in region \"" << *this->_regionName <<
+  std::cout << "ERROR: Region::findStateHere, in region \"" << *this->name() <<
     "\" failure of the retrieving of a state." << std::endl;
-  std::cout << "State \"" << *in_state_name << "\" not found." << std::endl;
+  std::cout << "State \"" << *SymbolTable::name(in_state_symbol) << "\" not found." << std::endl;
   return nullptr;
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<Region> Region::findRegion(std::shared_ptr<std::string> in_region_name) const
+std::shared_ptr<Region> Region::findRegion(Symbol in_region_symbol) const
 {
   std::shared_ptr<Region> region;
   for (auto it = this->_states.begin(); it != this->_states.end(); it++)
     {
-      region = (*it)->findRegion(in_region_name);
+      region = (*it)->findRegion(in_region_symbol);
       if (region) return region;
     }
   return nullptr;
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<SimpleState> Region::findState(std::shared_ptr<std::string> in_state_name) const
+std::shared_ptr<SimpleState> Region::findState(Symbol in_state_symbol) const
 {  
   std::shared_ptr<SimpleState> state;
   for (auto it = this->_states.begin(); it != this->_states.end(); it++)
     {
-      if (*((*it)->name()) == *in_state_name) return *it;
+      if ((*it)->symbol() == in_state_symbol) return *it;
       else
 	{
-	  state = (*it)->findState(in_state_name);
+	  state = (*it)->findState(in_state_symbol);
 	  if (state) return state;
 	}
     }
@@ -612,7 +1348,7 @@ std::shared_ptr<SimpleState> Region::findState(std::shared_ptr<std::string> in_s
 }
 
 // -----------------------------------------------------------------------------------
-bool Region::checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller) const
+bool Region::checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller) const
 {
   for (auto it = this->_states.begin(); it != this->_states.end(); it++)
     if ((*it)->checkForkOrJoin(in_states_names)) return true;
@@ -626,34 +1362,46 @@ bool Region::checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_state
 */
 
 // -----------------------------------------------------------------------------------
-RegionsComponent::RegionsComponent() {}
+RegionsComponent::RegionsComponent() : _finalRegions(0) {}
 
 // -----------------------------------------------------------------------------------
 RegionsComponent::~RegionsComponent() {}
 
 // -----------------------------------------------------------------------------------
 RegionsComponent::RegionsComponent(RegionsComponent &&in_regions_component) :
-  _regions(std::move(in_regions_component._regions))
+  _regions(std::move(in_regions_component._regions)), _finalRegions(in_regions_component._finalRegions)
 {
+  in_regions_component._finalRegions = 0;
 }
 
 // -----------------------------------------------------------------------------------
 RegionsComponent& RegionsComponent::operator = (RegionsComponent &&in_regions_component)
 {
   this->_regions = std::move(in_regions_component._regions);
+  this->_finalRegions = in_regions_component._finalRegions;
+  in_regions_component._finalRegions = 0;
   return *this;
 }
 
 // -----------------------------------------------------------------------------------
 void RegionsComponent::newRegion(const char *in_region_name)
 {
-  auto new_region = std::make_shared<Region>(in_region_name);  
+  std::shared_ptr<Region> new_region;
+  if (this->_arena) new_region = std::allocate_shared<Region>(ArenaAllocator<Region>(this->_arena), in_region_name);
+  else new_region = std::make_shared<Region>(in_region_name);
   this->_regions.push_back(new_region);
 }
 
+// -----------------------------------------------------------------------------------
+void RegionsComponent::useArena(std::shared_ptr<Arena> in_arena)
+{
+  this->_arena = in_arena;
+}
+
 // -----------------------------------------------------------------------------------
 bool RegionsComponent::init()
 {
+  this->_finalRegions = 0;
   for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
     {
       if (!(*it)->init())
@@ -662,10 +1410,65 @@ bool RegionsComponent::init()
 	    "\" initialization failed." << std::endl;
 	  return false;
 	}
+      auto active_state = (*it)->activeState();
+      if (active_state && active_state->kind() == StateKind::Final) this->_finalRegions++;
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool RegionsComponent::resume()
+{
+  this->_finalRegions = 0;
+  for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
+    {
+      if (!(*it)->resume())
+	{
+	  std::cout << "ERROR: RegionsComponent::resume, region \"" << *((*it)->name()) <<
+	    "\" initialization failed." << std::endl;
+	  return false;
+	}
+      auto active_state = (*it)->activeState();
+      if (active_state && active_state->kind() == StateKind::Final) this->_finalRegions++;
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void RegionsComponent::countFinalRegions()
+{
+  this->_finalRegions = 0;
+  for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
+    {
+      auto active_state = (*it)->activeState();
+      if (active_state && active_state->kind() == StateKind::Final) this->_finalRegions++;
     }
+}
+
+// -----------------------------------------------------------------------------------
+bool RegionsComponent::resolveConflicts(ConflictPolicy in_policy)
+{
+  bool is_ok = true;
+  for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
+    is_ok = (*it)->resolveConflicts(in_policy) && is_ok;
+  return is_ok;
+}
+
+// -----------------------------------------------------------------------------------
+bool RegionsComponent::flattenJunctions()
+{
+  for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
+    if (!(*it)->flattenJunctions()) return false;
   return true;
 }
 
+// -----------------------------------------------------------------------------------
+void RegionsComponent::earliestDeadline(long long int &io_deadline) const
+{
+  for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
+    (*it)->earliestDeadline(io_deadline);
+}
+
 // -----------------------------------------------------------------------------------
 bool RegionsComponent::run(RegionInfo &io_region_info)
 {
@@ -673,25 +1476,30 @@ bool RegionsComponent::run(RegionInfo &io_region_info)
     {
       RegionInfo region_info;
       region_info.init();
+      // Orthogonal regions are each offered the signal.
+      region_info._signal = io_region_info._signal;
       if (!(*it)->run(region_info))
 	return false;
+      if (region_info._signal_consumed) io_region_info._signal_consumed = true;
+      if (region_info._signal_deferred) io_region_info._signal_deferred = true;
       if (region_info._transition_fired || !region_info._transition_firing_allowed)
 	io_region_info._transition_firing_allowed = false;
       if (region_info._is_terminated) io_region_info._is_terminated = true;
+      if (region_info._final_reached) this->_finalRegions++;
     }
   return true;
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<Region> RegionsComponent::findRegion(std::shared_ptr<std::string> in_region_name) const
+std::shared_ptr<Region> RegionsComponent::findRegion(Symbol in_region_symbol) const
 {
   std::shared_ptr<Region> region;
   for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
     {
-      if ((*((*it)->name()) == *in_region_name)) return *it;
+      if ((*it)->symbol() == in_region_symbol) return *it;
       else
 	{
-	  region = (*it)->findRegion(in_region_name);
+	  region = (*it)->findRegion(in_region_symbol);
 	  if (region) return region;
 	}
     }  
@@ -699,12 +1507,12 @@ std::shared_ptr<Region> RegionsComponent::findRegion(std::shared_ptr<std::string
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<SimpleState> RegionsComponent::findState(std::shared_ptr<std::string> in_state_name) const
+std::shared_ptr<SimpleState> RegionsComponent::findState(Symbol in_state_symbol) const
 {
   std::shared_ptr<SimpleState> state;
   for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
     {
-      state = (*it)->findState(in_state_name);
+      state = (*it)->findState(in_state_symbol);
       if (state) return state;
     }  
   return nullptr;
@@ -716,13 +1524,13 @@ std::shared_ptr<SimpleState> RegionsComponent::findState(std::shared_ptr<std::st
 */
 
 // -----------------------------------------------------------------------------------
-CompositeState::CompositeState(const char *in_state_name) : SimpleState(in_state_name), RegionsComponent()
+CompositeState::CompositeState(const char *in_state_name) : SimpleState(in_state_name, StateKind::Composite), RegionsComponent()
 {
 }
 
 // -----------------------------------------------------------------------------------
 CompositeState::CompositeState(const char *in_state_name, RegionsComponent &in_regions_component) :
-  SimpleState(in_state_name), RegionsComponent(std::move(in_regions_component))
+  SimpleState(in_state_name, StateKind::Composite), RegionsComponent(std::move(in_regions_component))
 {
 }
 
@@ -744,33 +1552,52 @@ bool CompositeState::init()
   
   if (!this->RegionsComponent::init())
     {
-      std::cout << "ERROR: CompositeState::init, state \"" << *this->_stateName <<
+      std::cout << "ERROR: CompositeState::init, state \"" << *this->name() <<
 	"\" initialization failed." << std::endl;
       return false;
     }
-  else
-    return true;
+  if (this->regionsCompleted()) this->completed();
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool CompositeState::resume()
+{
+  this->SimpleState::init();
+  
+  if (!this->RegionsComponent::resume())
+    {
+      std::cout << "ERROR: CompositeState::resume, state \"" << *this->name() <<
+	"\" initialization failed." << std::endl;
+      return false;
+    }
+  if (this->regionsCompleted()) this->completed();
+  return true;
 }
 
 // -----------------------------------------------------------------------------------
-bool CompositeState::initFork(std::shared_ptr<std::vector<std::string> > in_states_names)
+bool CompositeState::initFork(std::shared_ptr<std::vector<Symbol> > in_states_names)
 {
   bool is_regions_initialized = true;
   for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
     is_regions_initialized = is_regions_initialized && (*it)->initFork(in_states_names);
-  if (is_regions_initialized) return true;
-  else return false;
+  if (!is_regions_initialized) return false;
+
+  // The count of a previous activation of the state is not kept.
+  this->countFinalRegions();
+  return true;
 }
 
 // -----------------------------------------------------------------------------------
 bool CompositeState::finalize()
 {
   this->SimpleState::finalize();
+  this->_finalRegions = 0;
   
   for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
     if (!(*it)->finalize())
       {
-	std::cout << "ERROR: CompositeState::finalize, in state \"" << *this->_stateName <<
+	std::cout << "ERROR: CompositeState::finalize, in state \"" << *this->name() <<
 	  "\" failure of the finalization of a region." << std::endl;
 	std::cout << "Region \"" << *((*it)->name()) << "\" finalization failed." << std::endl;
 	return false;
@@ -781,13 +1608,18 @@ bool CompositeState::finalize()
 // -----------------------------------------------------------------------------------
 bool CompositeState::run(RegionInfo &io_region_info)
 {
+  bool was_completed = this->regionsCompleted();
   if (!this->RegionsComponent::run(io_region_info))
     {
-      std::cout << "ERROR: RegionsComponent::run, state \"" << *this->_stateName <<
+      std::cout << "ERROR: RegionsComponent::run, state \"" << *this->name() <<
 	"\" run failed." << std::endl;
       return false;
     }
-  if (this->isCompleted()) this->completed();
+  if (!was_completed && this->regionsCompleted())
+    {
+      this->completed();
+      io_region_info._state_completed = true;
+    }
   return true;
 }
 
@@ -795,9 +1627,7 @@ bool CompositeState::run(RegionInfo &io_region_info)
 std::shared_ptr<Transition> CompositeState::fireTransition() const
 {
   auto fired_transition = this->SimpleState::fireTransition();
-#ifndef WARNING
   if (fired_transition) return fired_transition;
-#endif
 
   bool is_join_ok;
   int i;
@@ -809,44 +1639,52 @@ std::shared_ptr<Transition> CompositeState::fireTransition() const
 	  i = 0;
 	  while (i < (*it)->startingStates() && is_join_ok)
 	    {
-	      auto state = this->findState((*it)->startingState(i));
-	      if (*(this->findRegion(state->owningRegion())->activeState()->name()) != *(state->name()))
+	      auto state = this->findState((*it)->startingSymbol(i));
+	      if (this->findRegion(state->owningRegionSymbol())->activeState() != state)
 		is_join_ok = false;
 	      i++;
 	    }
-#ifndef WARNING
 	  if (is_join_ok) return *it;
-#else
-	  if (is_join_ok && !fired_transition) fired_transition = *it;
-	  else if (is_join_ok && fired_transition)
-	    {
-	      std::cout << "WARNING: CompositeState::fireTransition, state \"" << *this->_stateName <<
-		"\" has fired more than one transition." << std::endl;
-	      std::cout << "Transitions \"" << *(fired_transition->name()) << "\" and \"" <<
-		*((*it)->name()) << "\" have been fired." << std::endl;
-	    }
-#endif
 	}
     }  
-  return fired_transition;
+  return nullptr;
 }
 
 // -----------------------------------------------------------------------------------
-bool CompositeState::isCompleted() const
+bool CompositeState::fireLocal(std::shared_ptr<Transition> in_transition)
 {
-  std::shared_ptr<SimpleState> active_state;
-  for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
+#ifdef DEBUG
+  std::cout << "DEBUG: CompositeState::fireLocal, local transition \"" << *(in_transition->name()) << "\" fired." << std::endl;
+#endif
+  auto reached_state = this->findState(in_transition->reachableSymbol(0));
+  std::shared_ptr<Region> region = nullptr;
+  for (auto it = this->_regions.begin(); it != this->_regions.end() && reached_state && !region; it++)
+    if ((*it)->symbol() == reached_state->owningRegionSymbol()) region = *it;
+  if (!region)
     {
-      active_state = (*it)->activeState();
-      if (!active_state)
-	{
-	  std::cout << "ERROR: CompositeState::isJoined, in state \"" << *this->_stateName <<
-	    "\" failure of the retrieving of a region's active state." << std::endl;
-	  std::cout << "Region \"" << *((*it)->name()) << "\" doesn't have any active state." << std::endl;
-	}
-      else if (!active_state->isKind("FinalState")) return false;
+      std::cout << "ERROR: CompositeState::fireLocal, state \"" << *(in_transition->reachableState(0)) <<
+	"\" is not in a region of state \"" << *this->name() << "\"." << std::endl;
+      std::cout << "Local transition \"" << *(in_transition->name()) << "\" can't be fired." << std::endl;
+      return false;
     }
-  return true;
+  if (!region->reach(in_transition)) return false;
+
+  bool was_completed = this->regionsCompleted();
+  this->countFinalRegions();
+  if (!was_completed && this->regionsCompleted()) this->completed();
+  return in_transition->init();
+}
+
+// -----------------------------------------------------------------------------------
+bool CompositeState::isCompleted() const
+{
+  return this->regionsCompleted() && this->SimpleState::isCompleted();
+}
+
+// -----------------------------------------------------------------------------------
+bool CompositeState::regionsCompleted() const
+{
+  return this->_finalRegions == this->_regions.size();
 }
 
 // -----------------------------------------------------------------------------------
@@ -855,19 +1693,39 @@ void CompositeState::completed() const
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<Region> CompositeState::findRegion(std::shared_ptr<std::string> in_region_name) const
+std::shared_ptr<Region> CompositeState::findRegion(Symbol in_region_symbol) const
+{
+  return this->RegionsComponent::findRegion(in_region_symbol);
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<SimpleState> CompositeState::findState(Symbol in_state_symbol) const
+{
+  return this->RegionsComponent::findState(in_state_symbol);
+}
+
+// -----------------------------------------------------------------------------------
+bool CompositeState::resolveConflicts(ConflictPolicy in_policy)
+{
+  bool is_ok = this->SimpleState::resolveConflicts(in_policy);
+  return this->RegionsComponent::resolveConflicts(in_policy) && is_ok;
+}
+
+// -----------------------------------------------------------------------------------
+bool CompositeState::flattenJunctions(const Region &in_region)
 {
-  return this->RegionsComponent::findRegion(in_region_name);
+  return this->SimpleState::flattenJunctions(in_region) && this->RegionsComponent::flattenJunctions();
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<SimpleState> CompositeState::findState(std::shared_ptr<std::string> in_state_name) const
+void CompositeState::earliestDeadline(long long int &io_deadline) const
 {
-  return this->RegionsComponent::findState(in_state_name);
+  this->SimpleState::earliestDeadline(io_deadline);
+  this->RegionsComponent::earliestDeadline(io_deadline);
 }
 
 // -----------------------------------------------------------------------------------
-bool CompositeState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller) const
+bool CompositeState::checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller) const
 {
   bool is_ok = true;
   for (auto it = this->_regions.begin(); it != this->_regions.end(); it++)
@@ -875,7 +1733,7 @@ bool CompositeState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> >
       is_ok = (*it)->checkForkOrJoin(in_states_names) && is_ok;
       if (!is_ok && in_is_caller)
 	{
-	  std::cout << "ERROR: CompositeState::checkForkOrJoin, in state \"" << *this->_stateName <<
+	  std::cout << "ERROR: CompositeState::checkForkOrJoin, in state \"" << *this->name() <<
 	    "\" bad fork or join transition compound specification." << std::endl;
 	  std::cout << "There are missing incomings/outgoings transitions inside the region \"" <<
 	    *((*it)->name()) << "\"." << std::endl;
@@ -883,12 +1741,12 @@ bool CompositeState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> >
 	}
     }
   
-  auto it = std::find(in_states_names->begin(), in_states_names->end(), *this->_stateName);
+  auto it = std::find(in_states_names->begin(), in_states_names->end(), this->symbol());
   if (it != in_states_names->end())
     {
       if (is_ok)
 	{
-	  std::cout << "ERROR: CompositeState::checkForkOrJoin, in state \"" << *this->_stateName <<
+	  std::cout << "ERROR: CompositeState::checkForkOrJoin, in state \"" << *this->name() <<
 	    "\" bad fork or join transition compound specification." << std::endl;
 	  std::cout << "There are incomings/outgoings inside the state's regions and from the state." << std::endl;
 	  return false;
@@ -897,12 +1755,3 @@ bool CompositeState::checkForkOrJoin(std::shared_ptr<std::vector<std::string> >
     }
   else return is_ok;      
 }
-
-// -----------------------------------------------------------------------------------
-bool CompositeState::isKind(const char *in_kind) const
-{
-  if (std::string(in_kind) == std::string("CompositeState"))
-    return true;
-  else
-    return false;
-}
@@ -30,9 +30,13 @@
 #define STATES_HPP
 
 #include "transitions.hpp"
+#include "arena.hpp"
+#include "executor.hpp"
 
 #include <vector>
-#include <algorithm> // find
+#include <unordered_map>
+#include <algorithm> // find, stable_sort
+#include <cstring> // strcmp
 #include <string>
 #include <memory> // shared_ptr
 #include <utility> // move
@@ -49,14 +53,86 @@ namespace fisa
       this->_transition_fired = false;
       this->_transition_firing_allowed = true;
       this->_is_terminated = false;
+      this->_final_reached = false;
+      this->_signal = nullptr;
+      this->_signal_consumed = false;
+      this->_signal_deferred = false;
+      this->_state_completed = false;
     }
     
     bool _transition_fired;
     bool _transition_firing_allowed;
     bool _is_terminated;
+    bool _final_reached;
+    std::shared_ptr<const Signal> _signal; // Signal dispatched during the run, if any.
+    bool _signal_consumed;
+    bool _signal_deferred;
+    bool _state_completed; // Set by the active state of the region when it has been completed during the run.
   } RegionInfo;
 
+  //! Kinds of states, stored at construction so that the machine dispatches without string comparisons.
+  enum class StateKind
+  {
+    Simple,
+    Initial,
+    Final,
+    Terminate,
+    Composite,
+    ShallowHistory,
+    DeepHistory,
+    Choice,
+    Junction
+  };
+
+  //! Policies to resolve the conflicts between transitions starting from a same state.
+  /**
+   * Between transitions starting from nested states, the transition of the innermost state is 
+   * always fired, as in UML: the policy applies to the transitions starting from a same state.
+   **/
+  enum class ConflictPolicy
+  {
+    FirstWins,       // The first activated transition, in the order transitions have been added, is fired.
+    PriorityWins,    // The activated transition with the highest priority is fired, the first added between equal priorities.
+    ErrorOnConflict  // As PriorityWins, but transitions of equal priority that may be activated at once make the machine's first run fail.
+  };
+
   class Region;
+
+  //#########################################################################################################
+  /* 
+     ChangedEvents
+  */
+  //! Collects the events of a state that have notified a change since the state's transitions were last checked.
+  
+  class ChangedEvents : public EventListener
+  {
+  public:
+    //! Constructor. All events are considered changed until the first check.
+    ChangedEvents();
+
+    //! Specializes EventListener's "changed" method.
+    void changed(const Event *in_event);
+
+    //! Sets the number of distinct events listened, beyond which all events are considered changed.
+    void setCapacity(std::size_t in_capacity);
+
+    //! Considers all events as changed.
+    void markAll();
+
+    //! Forgets the changes, after the transitions have been checked.
+    void clear();
+
+    //! Returns true if all events have to be considered as changed.
+    bool all() const {return this->_all;}
+
+    //! Returns the events that have changed, when "all" returns false.
+    const std::vector<const Event*>& pending() const {return this->_pending;}
+
+  private:
+    bool _all;
+    std::size_t _capacity;
+    std::vector<const Event*> _pending;
+  };
   
   //#########################################################################################################
   /* 
@@ -77,18 +153,30 @@ namespace fisa
     //! Construct a SimpleState with name specified in argument.
     SimpleState(const char *in_state_name);
 
-    //! Destructor.
+    //! Destructor. Cancels the do-activity of the state, if it is still running.
     virtual ~SimpleState();
 
+    //! Returns the kind of the state.
+    StateKind kind() const {return this->_kind;}
+
     //! Retrieves the name of the state.
     std::shared_ptr<std::string> name() const;
 
-    //! Sets the name of the Region that own the state.
-    void setOwningRegion(std::shared_ptr<std::string> in_region_name);
+    //! Retrieves the interned name of the state.
+    Symbol symbol() const {return this->_stateSymbol;}
+
+    //! Sets the interned name of the Region that own the state.
+    void setOwningRegion(Symbol in_region_symbol);
     
     //! Retrieves the name of the Region that own the state.
     std::shared_ptr<std::string> owningRegion() const;
 
+    //! Retrieves the interned name of the Region that own the state.
+    Symbol owningRegionSymbol() const {return this->_regionSymbol;}
+
+    //! Sets the callback tables of the machine the state has been added to, and the index of the state in them.
+    void setCallbacks(std::shared_ptr<const Callbacks> in_callbacks, std::size_t in_index);
+
     //! Adds a transition within the state.
     /** To create automata, the Machine's class "addTransition" method should be used. **/
     virtual bool addTransition(std::shared_ptr<Transition> in_transition);
@@ -98,15 +186,63 @@ namespace fisa
     bool addJoin(std::shared_ptr<Join> in_join);
 
     //! Checks if an event has triggered a transition and returns the fired transition.
+    /**
+     * Transitions triggered by events that notify their changes (eg: ChangeEvent) are only 
+     * checked after the state has been reached or after their event has changed, the others 
+     * are checked each time. Transitions are sorted once before the machine's first run, 
+     * see "resolveConflicts", and the first activated transition is returned.
+     **/
     virtual std::shared_ptr<Transition> fireTransition() const;
 
-    //! Called when the state is reached. Initializes transitions within the state and calls the "entry" method.
+    //! Returns the first completion transition whose guard is true, if the state is completed.
+    std::shared_ptr<Transition> fireCompletion() const;
+
+    //! Returns the transitions checked by "fireTransition", in the order they are checked.
+    const std::vector<std::shared_ptr<Transition> >& transitions() const {return this->_transitions;}
+
+    //! Returns true if the state has transitions that are not checked by "fireTransition" (completion, signal or join transitions).
+    bool hasDispatchedTransitions() const
+    {
+      return !this->_completionTransitions.empty() || !this->_signalTransitions.empty() || !this->_joinPseudostates.empty();
+    }
+
+    //! Returns true if the state is completed.
+    /** 
+     * A SimpleState is completed as soon as it has been reached or, if it has a do-activity 
+     * (see Machine's "onDo" method), once the do-activity has returned.
+     **/
+    virtual bool isCompleted() const;
+
+    //! Offers a signal to the transitions listening for its type and returns the transition that consumed it.
+    /** Transitions are offered the signal in the order they have been added to the state. **/
+    std::shared_ptr<Transition> dispatch(std::shared_ptr<const Signal> in_signal) const;
+
+    //! Defers the signals of the type specified in argument while the state is active.
+    /**
+     * A signal that is deferred by an active state, and consumed by no transition, is kept 
+     * by the machine and offered again once the machine has changed of state.
+     **/
+    void defer(SignalId in_signal);
+
+    //! Defers the signals with a payload of type P while the state is active.
+    template<typename P>
+    void defer() {this->defer(SignalType<P>::id());}
+
+    //! Returns true if the state defers the signals of the type specified in argument.
+    bool defers(SignalId in_signal) const;
+
+    //! Called when the state is reached. Initializes transitions within the state and calls the "entry" method, then the entry callback.
+    /** The do-activity of the state, if any, is then launched on the machine's executor. **/
     virtual bool init();
 
     //! Nothing to do for a SimpleState.
-    virtual bool initFork(std::shared_ptr<std::vector<std::string> > in_states_names);
+    virtual bool initFork(std::shared_ptr<std::vector<Symbol> > in_states_names);
+
+    //! Called when the state is reached again through a deep history pseudostate.
+    /** For a SimpleState, same as "init". **/
+    virtual bool resume();
 
-    //! Called when the state is leaved. Calls the "exit" method.
+    //! Called when the state is leaved. Cancels the do-activity and calls the "exit" method, then the exit callback.
     virtual bool finalize();
 
     //! Nothing to do for a SimpleState. 
@@ -121,22 +257,68 @@ namespace fisa
     virtual void exit() const;
 
     //! Nothing to do for a SimpleState.
-    virtual std::shared_ptr<Region> findRegion(std::shared_ptr<std::string> in_region_name) const;
+    virtual std::shared_ptr<Region> findRegion(Symbol in_region_symbol) const;
 
     //! Nothing to do for a SimpleState.
-    virtual std::shared_ptr<SimpleState> findState(std::shared_ptr<std::string> in_state_name) const;
+    virtual std::shared_ptr<SimpleState> findState(Symbol in_state_symbol) const;
 
     //! Checks if the state takes part to a join or a fork transition.
-    virtual bool checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller = false) const;
+    virtual bool checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller = false) const;
 
-    //! Checks the kind of the state. Returns true for "SimpleState" in input argument.
+    //! Sorts the transitions of the state following the policy, and checks for conflicts between them.
+    /**
+     * Called once by the machine before its first run. Two transitions may be activated at once 
+     * when they share their trigger (or are both untriggered, or both listen for the same type of 
+     * signal) and at least one of them has no guard, or they share their guard. With the 
+     * ConflictPolicy::ErrorOnConflict policy, such transitions with equal priorities are reported 
+     * as an error and false is returned, otherwise the conflicts are reported as warnings.
+     **/
+    virtual bool resolveConflicts(ConflictPolicy in_policy);
+
+    //! Replaces the transitions of the state that reach a junction pseudostate of the region by compound transitions.
+    /** Called once by the machine before its first run. **/
+    virtual bool flattenJunctions(const Region &in_region);
+
+    //! Lowers the deadline in argument to the earliest deadline of the events that trigger the state's transitions.
+    /** See Event's "deadline" method. **/
+    virtual void earliestDeadline(long long int &io_deadline) const;
+
+    //! Checks the kind of the state by its class name (eg: "SimpleState", "FinalState").
+    /** 
+     * Kept for compatibility, the "kind" method should be preferred: the machine dispatches on 
+     * the kind given at construction, not on this method. 
+     **/
     virtual bool isKind(const char *in_kind) const;
     
-  protected:    
-    std::shared_ptr<std::string> _stateName;
-    std::shared_ptr<std::string> _regionName;
+  protected:
+    //! Construct a state of the kind specified in second argument.
+    SimpleState(const char *in_state_name, StateKind in_kind);
+
+    Symbol _stateSymbol;
+    Symbol _regionSymbol;
     std::vector<std::shared_ptr<Transition> > _transitions;
     std::vector<std::shared_ptr<Join> > _joinPseudostates;
+    std::unordered_map<SignalId, std::vector<std::shared_ptr<Transition> > > _signalTransitions; // Transitions triggered by signals, by signal type.
+    std::vector<std::vector<std::shared_ptr<Transition> >::size_type> _polledTransitions; // Indexes of transitions checked at each run.
+    std::unordered_map<const Event*, std::vector<std::vector<std::shared_ptr<Transition> >::size_type> > _changeTransitions; // Indexes of transitions by notifying event.
+    std::shared_ptr<ChangedEvents> _changedEvents;
+    std::vector<SignalId> _deferredSignals;
+    std::vector<std::shared_ptr<Transition> > _completionTransitions;
+    std::shared_ptr<const Callbacks> _callbacks;
+    std::size_t _callbacksIndex; // Index of the state in the callback tables.
+    std::shared_ptr<Activity> _activity; // Do-activity running while the state is active.
+
+  private:
+    //! Sorts the transitions by decreasing priority, keeping the order they have been added between equal priorities.
+    void sortTransitions();
+
+    //! Checks for conflicts between the transitions in argument, returns false if a conflict is an error.
+    bool checkConflicts(const std::vector<std::shared_ptr<Transition> > &in_transitions, ConflictPolicy in_policy) const;
+    
+    //! Indexes the transition at the index specified in argument by the event, if the event notifies its changes.
+    bool indexChangeTransition(std::shared_ptr<Event> in_event, std::vector<std::shared_ptr<Transition> >::size_type in_index);
+    
+    StateKind _kind;
   };
 
   //#########################################################################################################
@@ -167,10 +349,7 @@ namespace fisa
     std::shared_ptr<Transition> fireTransition() const;
 
     //! Nothing to do for an initial pseudostate.
-    bool checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_name, bool in_is_caller = false) const;
-
-    //! Returns true for "InitialState" in input argument. 
-    bool isKind(const char *in_kind) const;
+    bool checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_name, bool in_is_caller = false) const;
   };
 
   //#########################################################################################################
@@ -204,10 +383,7 @@ namespace fisa
     bool finalize();
 
     //! Nothing to do for a final pseudostate.
-    bool checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller = false) const;
-
-    //! Returns true for "FinalState" in input argument.
-    bool isKind(const char *in_kind) const;
+    bool checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller = false) const;
   };
 
   //#########################################################################################################
@@ -245,10 +421,176 @@ namespace fisa
     bool finalize();
 
     //! Nothing to do for a terminate pseudostate.
-    bool checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller = false) const;
+    bool checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller = false) const;
+  };
+
+  //#########################################################################################################
+  /*
+    HistoryState
+  */
+  //! Base class of the history pseudostates.
+  /**
+   * A region remembers its last active state when it is left. A transition that targets the 
+   * history pseudostate of a region (eg: an outgoing of a Fork) restores that state instead of 
+   * firing the initial transition. The initial pseudostate is used if the region hasn't been 
+   * left yet, or was left from a final pseudostate, and whenever the region is entered without 
+   * targeting its history pseudostate.
+   * To create automata, only the constructors of ShallowHistoryState and DeepHistoryState should be used.
+   **/
 
-    //! Returns true for "TerminateState" in input argument.
-    bool isKind(const char *in_kind) const;
+  class HistoryState : public SimpleState
+  {
+  public:
+    //! Destructor.
+    ~HistoryState();
+    
+    //! A history pseudostate can't have any transition starting from it.
+    bool addTransition(std::shared_ptr<Transition> in_transition);
+
+    //! Returns a null pointer since there is no starting transition from a history pseudostate.
+    std::shared_ptr<Transition> fireTransition() const;
+
+  protected:
+    //! Construct a history pseudostate of the kind specified in second argument.
+    HistoryState(const char *in_state_name, StateKind in_kind);
+  };
+
+  //#########################################################################################################
+  /*
+    ShallowHistoryState
+  */
+  //! Class to program a pseudostate that restores the last active state of its region.
+  /**
+   * Only the last active state of the region is restored: regions of a restored composite 
+   * state are entered by their own initial or history pseudostate.
+   **/
+
+  class ShallowHistoryState : public HistoryState
+  {
+  public:
+    //! Construct a shallow history pseudostate with name specified in input argument.
+    ShallowHistoryState(const char *in_state_name);
+
+    //! Destructor.
+    ~ShallowHistoryState();
+  };
+
+  //#########################################################################################################
+  /*
+    DeepHistoryState
+  */
+  //! Class to program a pseudostate that restores the last active configuration of its region.
+  /**
+   * The last active state of the region is restored, and recursively the last active states 
+   * of the regions of a restored composite state.
+   **/
+
+  class DeepHistoryState : public HistoryState
+  {
+  public:
+    //! Construct a deep history pseudostate with name specified in input argument.
+    DeepHistoryState(const char *in_state_name);
+
+    //! Destructor.
+    ~DeepHistoryState();
+  };
+
+  //#########################################################################################################
+  /*
+    BranchState
+  */
+  //! Base class of the choice and junction pseudostates.
+  /**
+   * The transitions starting from a branch pseudostate can't be triggered. Their guards are evaluated 
+   * in the order the transitions have been added, and the first transition whose guard is true is 
+   * the branch taken. The transition without guard, if any, is the "else" branch: it is taken when 
+   * no guard is true, whatever the order it has been added in.
+   * To create automata, only the constructors of ChoiceState and JunctionState should be used.
+   **/
+
+  class BranchState : public SimpleState
+  {
+  public:
+    //! Destructor.
+    ~BranchState();
+    
+    //! A branch pseudostate only accepts untriggered transitions, and at most one without guard.
+    bool addTransition(std::shared_ptr<Transition> in_transition);
+
+    //! Returns the first branch whose guard is true, or the "else" branch.
+    std::shared_ptr<Transition> fireTransition() const;
+
+    //! Returns the guarded branches, in the order they are evaluated.
+    const std::vector<std::shared_ptr<Transition> >& branches() const {return this->_transitions;}
+
+    //! Returns the "else" branch, a null pointer if there is none.
+    std::shared_ptr<Transition> elseBranch() const {return this->_elseBranch;}
+
+    //! Nothing to do for a branch pseudostate, which is never active at the end of a run.
+    bool init();
+
+    //! Nothing to do for a branch pseudostate.
+    bool finalize();
+
+    //! Sorts the branches by decreasing priority, unless the policy is ConflictPolicy::FirstWins.
+    bool resolveConflicts(ConflictPolicy in_policy);
+
+    //! Nothing to do for a branch pseudostate, chains of junctions are flattened from the states they start from.
+    bool flattenJunctions(const Region &in_region);
+
+    //! Nothing to do for a branch pseudostate.
+    bool checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller = false) const;
+
+  protected:
+    //! Construct a branch pseudostate of the kind specified in second argument.
+    BranchState(const char *in_state_name, StateKind in_kind);
+
+  private:
+    std::shared_ptr<Transition> _elseBranch;
+  };
+
+  //#########################################################################################################
+  /*
+    ChoiceState
+  */
+  //! Class to program a dynamic conditional branch.
+  /**
+   * When a transition reaches a choice pseudostate, the guards of its branches are evaluated after 
+   * the effect of the transition, and the region directly goes on to the target of the branch taken. 
+   * The "else" branch should be defined, a choice without any branch to take makes the run fail.
+   **/
+
+  class ChoiceState : public BranchState
+  {
+  public:
+    //! Construct a choice pseudostate with name specified in input argument.
+    ChoiceState(const char *in_state_name);
+
+    //! Destructor.
+    ~ChoiceState();
+  };
+
+  //#########################################################################################################
+  /*
+    JunctionState
+  */
+  //! Class to program a static conditional branch.
+  /**
+   * Before the first run of the machine, each transition reaching a junction pseudostate is replaced 
+   * by a CompoundTransition for each branch of the junction, so that the guards of the branches are 
+   * evaluated before the starting state is left: a transition whose junction has no branch to take 
+   * is not fired. The compound transitions are checked in the order of the branches, the "else" 
+   * branch last, and chains of junctions are flattened the same way.
+   **/
+
+  class JunctionState : public BranchState
+  {
+  public:
+    //! Construct a junction pseudostate with name specified in input argument.
+    JunctionState(const char *in_state_name);
+
+    //! Destructor.
+    ~JunctionState();
   };
 
   //#########################################################################################################
@@ -273,54 +615,102 @@ namespace fisa
     //! Retrieves the region's name.
     std::shared_ptr<std::string> name() const;
 
+    //! Retrieves the region's interned name.
+    Symbol symbol() const {return this->_regionSymbol;}
+
     //! Adds a state within the region.
     void addState(std::shared_ptr<SimpleState> in_state);
 
     //! Intialization with the InitialState or by calling the "init" method of the active state.
+    /** If the active state is a history pseudostate targeted by a transition, the last active state is restored instead. **/
     bool init();
 
+    //! Restores the last active state of the region, and of its nested regions, or initializes the region if there is none.
+    bool resume();
+
     //! Initializes the active state in regions that takes part to the fork transition.
-    bool initFork(std::shared_ptr<std::vector<std::string> > in_states_names);
+    bool initFork(std::shared_ptr<std::vector<Symbol> > in_states_names);
 
     //! Calls finalize for the active state.
+    /** A suspended region doesn't wait for the asynchronous effect anymore, it is entered again from the beginning. **/
     bool finalize();
 
     //! Checks of an active state's activated transition and changes of state consequently.
     /**
      * Do the job for this region, for the regions inside composite states of this region, 
      * and so on recursively.
+     * A transition with an asynchronous effect suspends the region: the region doesn't have an 
+     * active state until the effect resumes, and the target is reached on the next run.
      **/
     bool run(RegionInfo &io_region_info);
 
+    //! Returns true if the region waits for the asynchronous effect of a transition.
+    bool isSuspended() const {return this->_suspension != nullptr;}
+
+    //! Leaves the active state, if any, and reaches the state reachable by the transition, calling its effect.
+    /** Used to fire the local transitions of the composite state that owns the region. **/
+    bool reach(std::shared_ptr<Transition> in_transition);
+
     //! Returns the active state.
     std::shared_ptr<SimpleState> activeState() const;
 
+    //! Returns the states of the region, in the order they have been added.
+    const std::vector<std::shared_ptr<SimpleState> >& states() const {return this->_states;}
+
     //! Returns the state that has the name specified in argument.
     /** The method searches only among states within this region. **/
-    std::shared_ptr<SimpleState> findStateHere(std::shared_ptr<std::string> state_name) const;
+    std::shared_ptr<SimpleState> findStateHere(Symbol in_state_symbol) const;
 
     //! Returns the region that has the name specified in argument.
     /** 
      * The method searches among composite states within this region, composites states in 
      * composites states within this region and so on recursively.
      **/
-    std::shared_ptr<Region> findRegion(std::shared_ptr<std::string> in_region_name) const;
+    std::shared_ptr<Region> findRegion(Symbol in_region_symbol) const;
 
     //! Returns the state that has the name specified in argument.
     /**
      * The method searches among states within this region, states in composite states within 
      * this region and so on recursively.
      **/
-    std::shared_ptr<SimpleState> findState(std::shared_ptr<std::string> state_name) const;
+    std::shared_ptr<SimpleState> findState(Symbol in_state_symbol) const;
 
     //! Calls the method to check fork or join transition in all region's states.
-    bool checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_names, bool in_is_caller = false) const;
+    bool checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_names, bool in_is_caller = false) const;
+
+    //! Calls the method to resolve conflicts between transitions in all region's states.
+    bool resolveConflicts(ConflictPolicy in_policy);
+
+    //! Calls the method to flatten junction pseudostates in all region's states.
+    bool flattenJunctions();
+
+    //! Calls the method to retrieve the earliest deadline for the active state.
+    void earliestDeadline(long long int &io_deadline) const;
+
+    //! Appends to the output argument the transitions resulting from the flattening of the transition in input argument.
+    /** 
+     * A transition that doesn't reach a junction pseudostate is appended as is, otherwise a 
+     * CompoundTransition is appended for each branch of the junction, recursively.
+     **/
+    bool expandJunction(std::shared_ptr<Transition> in_transition, std::vector<std::shared_ptr<Transition> > &out_transitions) const;
 
   private:
-    std::shared_ptr<std::string> _regionName;
+    //! Reaches the target of the fired transition, once the active state has been left and the effect called.
+    bool enter(std::shared_ptr<Transition> in_transition, RegionInfo &io_region_info);
+
+    //! Goes on from choice and junction pseudostates to the targets of the branches taken, calling their effect.
+    bool leaveBranches();
+
+    //! Initializes the active state, or restores the last active state if the active state is a history pseudostate.
+    bool initActiveState();
+    
+
+    Symbol _regionSymbol;
     std::vector<std::shared_ptr<SimpleState> > _states;
     std::shared_ptr<SimpleState> _startingState;
     std::shared_ptr<SimpleState> _activeState;
+    std::shared_ptr<SimpleState> _lastActiveState; // Active state when the region has last been finalized.
+    Frame *_suspension; // Frame of the transition whose asynchronous effect is pending, if any.
   };
 
   //#########################################################################################################
@@ -350,21 +740,42 @@ namespace fisa
     
     //! Creates a new region which has the name specified in argument.
     virtual void newRegion(const char *in_region_name);
+
+    //! Sets the arena in which new regions are allocated.
+    /** If no arena has been set, regions are allocated on the heap. **/
+    void useArena(std::shared_ptr<Arena> in_arena);
     
     //! Initializes all regions depending on the initial state defined inside them.
     virtual bool init();
+
+    //! Restores the last active states of all regions.
+    bool resume();
+
+    //! Resolves the conflicts between transitions in all regions.
+    bool resolveConflicts(ConflictPolicy in_policy);
+
+    //! Flattens the junction pseudostates in all regions.
+    bool flattenJunctions();
+
+    //! Lowers the deadline in argument to the earliest deadline of the active states in all regions.
+    void earliestDeadline(long long int &io_deadline) const;
     
     //! Changes the states in all regions depending on the transitions fired.
     virtual bool run(RegionInfo &io_region_info);
     
     //! Searches, in the regions of the container, and returns the region with the name specified in argument.
-    virtual std::shared_ptr<Region> findRegion(std::shared_ptr<std::string> in_region_name) const;
+    virtual std::shared_ptr<Region> findRegion(Symbol in_region_symbol) const;
     
     //! Searches, in the regions of the container, and returns the state with the name specified in argument.
-    virtual std::shared_ptr<SimpleState> findState(std::shared_ptr<std::string> in_state_name) const;    
+    virtual std::shared_ptr<SimpleState> findState(Symbol in_state_symbol) const;    
     
   protected:
+    //! Counts again the regions whose active state is a FinalState.
+    void countFinalRegions();
+    
     std::vector<std::shared_ptr<Region> > _regions;
+    std::vector<std::shared_ptr<Region> >::size_type _finalRegions; // Number of regions whose active state is a FinalState.
+    std::shared_ptr<Arena> _arena;
   };
 
   //#########################################################################################################
@@ -405,8 +816,11 @@ namespace fisa
     //! Specializes RegionsComponent's "init" method.
     bool init();
 
+    //! Specializes SimpleState's "resume" method, the state's regions are resumed.
+    bool resume();
+
     //! Initializes the active state inside regions of this state, with state names specified in argument.
-    bool initFork(std::shared_ptr<std::vector<std::string> > in_states_names);
+    bool initFork(std::shared_ptr<std::vector<Symbol> > in_states_names);
 
     //! Calls the finalize method of this state and for all state's regions.
     bool finalize();
@@ -417,23 +831,41 @@ namespace fisa
     //! Specializes SimpleState's "fireTransition" method.
     std::shared_ptr<Transition> fireTransition() const;
 
-    //! Calls the overloadable method "completed" if all state's regions have reached a FinalState.
+    //! Fires a local transition, to a state in one of the state's regions, without leaving the state.
+    bool fireLocal(std::shared_ptr<Transition> in_transition);
+
+    //! Specializes SimpleState's "isCompleted" method, returns true if all state's regions have reached a FinalState and the do-activity has returned.
+    /**
+     * The count of completed regions is updated when regions change of state, so that 
+     * the overloadable method "completed" is called once, on the run where the last region 
+     * reaches its FinalState, and the completion transitions are fired in the same run.
+     **/
     bool isCompleted() const;
 
     //! Overloadable method called when all regions in the state have reached a FinalState.
     virtual void completed() const;
 
     //! Specializes RegionsComponent's "findRegion" method.
-    std::shared_ptr<Region> findRegion(std::shared_ptr<std::string> in_region_name) const;
+    std::shared_ptr<Region> findRegion(Symbol in_region_symbol) const;
 
     //! Specializes RegionsComponent's "findState" method.
-    std::shared_ptr<SimpleState> findState(std::shared_ptr<std::string> in_state_name) const;
+    std::shared_ptr<SimpleState> findState(Symbol in_state_symbol) const;
 
     //! Specializes SimpleState's "checkForkOrJoin" method.
-    bool checkForkOrJoin(std::shared_ptr<std::vector<std::string> > in_states_name, bool in_is_caller = false) const;
+    bool checkForkOrJoin(std::shared_ptr<std::vector<Symbol> > in_states_name, bool in_is_caller = false) const;
+
+    //! Specializes SimpleState's "resolveConflicts" method, the conflicts in the state's regions are resolved too.
+    bool resolveConflicts(ConflictPolicy in_policy);
+
+    //! Specializes SimpleState's "flattenJunctions" method, the junctions of the state's regions are flattened too.
+    bool flattenJunctions(const Region &in_region);
 
-    //! Returns true for "CompositeState" in input argument.
-    bool isKind(const char *in_kind) const;
+    //! Specializes SimpleState's "earliestDeadline" method, the active states of the state's regions are checked too.
+    void earliestDeadline(long long int &io_deadline) const;
+
+  private:
+    //! Returns true if all state's regions have reached a FinalState.
+    bool regionsCompleted() const;
   };
 }
 
@@ -0,0 +1,706 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "stream.hpp"
+
+#include <algorithm> // min
+#include <cstring> // strlen
+
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+#include <immintrin.h>
+#endif
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  ByteView
+*/
+
+// -----------------------------------------------------------------------------------
+ByteView ByteView::slice(std::size_t in_position, std::size_t in_count) const
+{
+  if (in_position >= this->_size) return ByteView(this->_data + this->_size, 0);
+  if (in_count > this->_size - in_position) in_count = this->_size - in_position;
+  return ByteView(this->_data + in_position, in_count);
+}
+
+//#########################################################################################################
+/*
+  ByteClass
+*/
+
+// -----------------------------------------------------------------------------------
+ByteClass::ByteClass()
+{
+  for (int i = 0; i < 4; i++) this->_bits[i] = 0;
+}
+
+// -----------------------------------------------------------------------------------
+ByteClass ByteClass::any()
+{
+  return ~ByteClass();
+}
+
+// -----------------------------------------------------------------------------------
+ByteClass ByteClass::of(unsigned char in_byte)
+{
+  ByteClass byte_class;
+  byte_class._bits[in_byte >> 6] |= std::uint64_t(1) << (in_byte & 63);
+  return byte_class;
+}
+
+// -----------------------------------------------------------------------------------
+ByteClass ByteClass::range(unsigned char in_first, unsigned char in_last)
+{
+  ByteClass byte_class;
+  for (int byte = in_first; byte <= in_last; byte++)
+    byte_class._bits[byte >> 6] |= std::uint64_t(1) << (byte & 63);
+  return byte_class;
+}
+
+// -----------------------------------------------------------------------------------
+ByteClass ByteClass::oneOf(const char *in_bytes)
+{
+  ByteClass byte_class;
+  for (std::size_t i = 0; i < std::strlen(in_bytes); i++)
+    {
+      unsigned char byte = static_cast<unsigned char>(in_bytes[i]);
+      byte_class._bits[byte >> 6] |= std::uint64_t(1) << (byte & 63);
+    }
+  return byte_class;
+}
+
+// -----------------------------------------------------------------------------------
+bool ByteClass::empty() const
+{
+  return !(this->_bits[0] | this->_bits[1] | this->_bits[2] | this->_bits[3]);
+}
+
+// -----------------------------------------------------------------------------------
+ByteClass ByteClass::operator | (const ByteClass &in_class) const
+{
+  ByteClass byte_class;
+  for (int i = 0; i < 4; i++) byte_class._bits[i] = this->_bits[i] | in_class._bits[i];
+  return byte_class;
+}
+
+// -----------------------------------------------------------------------------------
+ByteClass ByteClass::operator & (const ByteClass &in_class) const
+{
+  ByteClass byte_class;
+  for (int i = 0; i < 4; i++) byte_class._bits[i] = this->_bits[i] & in_class._bits[i];
+  return byte_class;
+}
+
+// -----------------------------------------------------------------------------------
+ByteClass ByteClass::operator ~ () const
+{
+  ByteClass byte_class;
+  for (int i = 0; i < 4; i++) byte_class._bits[i] = ~this->_bits[i];
+  return byte_class;
+}
+
+// -----------------------------------------------------------------------------------
+bool ByteClass::operator == (const ByteClass &in_class) const
+{
+  for (int i = 0; i < 4; i++)
+    if (this->_bits[i] != in_class._bits[i]) return false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool ByteClass::operator != (const ByteClass &in_class) const
+{
+  return !(*this == in_class);
+}
+
+//#########################################################################################################
+/*
+  ByteEvent
+*/
+
+// -----------------------------------------------------------------------------------
+ByteEvent::ByteEvent(const ByteClass &in_class, std::shared_ptr<const ByteCursor> in_cursor) :
+  _class(in_class), _cursor(in_cursor)
+{
+}
+
+// -----------------------------------------------------------------------------------
+ByteEvent::~ByteEvent()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool ByteEvent::init()
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool ByteEvent::happened() const
+{
+  return this->_cursor->_byte >= 0 && this->_class.contains(static_cast<unsigned char>(this->_cursor->_byte));
+}
+
+//#########################################################################################################
+/*
+  StreamMachine
+*/
+
+// -----------------------------------------------------------------------------------
+StreamMachine::StreamMachine(const char *in_machine_name) :
+  Machine(in_machine_name), _cursor(std::make_shared<ByteCursor>()), _isStarted(false), _base(0), _position(0), _mark(-1), _scan(ByteScan::Vector)
+{
+  this->_cursor->_byte = -1;
+}
+
+// -----------------------------------------------------------------------------------
+StreamMachine::~StreamMachine()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamMachine::feed(ByteView in_bytes)
+{
+  if (!this->beginFeed(in_bytes)) return false;
+  
+  const unsigned char *bytes = in_bytes.data();
+  std::size_t size = in_bytes.size();
+  if (this->isCompiled())
+    {
+      if (!this->feedCompiled(bytes, size))
+	{
+	  this->_cursor->_byte = -1;
+	  return false;
+	}
+    }
+  else
+    {
+      for (std::size_t i = 0; i < size; i++)
+	{
+	  this->_cursor->_byte = bytes[i];
+	  this->_position = this->_base + i;
+	  if (!this->run())
+	    {
+	      std::cout << "ERROR: StreamMachine::feed, machine \"" << *this->name() << "\" run failed at position " <<
+		this->_position << "." << std::endl;
+	      this->_cursor->_byte = -1;
+	      return false;
+	    }
+	}
+    }
+  this->endFeed();
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamMachine::beginFeed(ByteView in_bytes)
+{
+  if (!this->_isStarted)
+    {
+      if (!this->run()) return false;
+      this->_isStarted = true;
+    }
+  this->_buffer = in_bytes;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void StreamMachine::endFeed()
+{
+  this->_cursor->_byte = -1;
+
+  // The bytes of an unfinished slice are kept, the buffer may be released after the call.
+  const unsigned char *bytes = this->_buffer.data();
+  std::size_t size = this->_buffer.size();
+  if (this->_mark < 0) this->_carry.clear();
+  else if (static_cast<unsigned long long int>(this->_mark) >= this->_base)
+    this->_carry.assign(bytes + (this->_mark - this->_base), bytes + size);
+  else this->_carry.insert(this->_carry.end(), bytes, bytes + size);
+  this->_base += size;
+  this->_position = this->_base;
+  this->_buffer = ByteView();
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamMachine::feed(const RingBuffer<unsigned char> &in_buffer)
+{
+  std::size_t count;
+  auto first = in_buffer.contiguous(0, count);
+  if (!this->feed(ByteView(first, count))) return false;
+  std::size_t position = count;
+  auto second = in_buffer.contiguous(position, count);
+  return this->feed(ByteView(second, count));
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<ByteEvent> StreamMachine::byteEvent(const ByteClass &in_class)
+{
+  return std::make_shared<ByteEvent>(in_class, this->_cursor);
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamMachine::markOn(const char *in_transition_name)
+{
+  Symbol transition_symbol;
+  if (!SymbolTable::find(in_transition_name, transition_symbol) ||
+      !this->onEffect(in_transition_name, [this, transition_symbol]() {this->slice(transition_symbol);}))
+    {
+      std::cout << "ERROR: StreamMachine::markOn, transition \"" << in_transition_name << "\" not found." << std::endl;
+      return false;
+    }
+  auto found = this->_slicings.find(transition_symbol);
+  if (found == this->_slicings.end())
+    {
+      Slicing slicing;
+      slicing._isMark = false;
+      found = this->_slicings.insert(std::make_pair(transition_symbol, slicing)).first;
+    }
+  found->second._isMark = true;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamMachine::onSlice(const char *in_transition_name, SliceCallback in_callback)
+{
+  Symbol transition_symbol;
+  if (!SymbolTable::find(in_transition_name, transition_symbol) ||
+      !this->onEffect(in_transition_name, [this, transition_symbol]() {this->slice(transition_symbol);}))
+    {
+      std::cout << "ERROR: StreamMachine::onSlice, transition \"" << in_transition_name << "\" not found." << std::endl;
+      return false;
+    }
+  auto found = this->_slicings.find(transition_symbol);
+  if (found == this->_slicings.end())
+    {
+      Slicing slicing;
+      slicing._isMark = false;
+      found = this->_slicings.insert(std::make_pair(transition_symbol, slicing)).first;
+    }
+  found->second._callback = std::move(in_callback);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void StreamMachine::slice(Symbol in_transition_symbol)
+{
+  auto &slicing = this->_slicings[in_transition_symbol];
+  if (slicing._callback)
+    {
+      slicing._callback(this->currentSlice());
+      this->_mark = -1;
+    }
+  if (slicing._isMark) this->_mark = this->_position + 1;
+}
+
+// -----------------------------------------------------------------------------------
+ByteView StreamMachine::currentSlice()
+{
+  if (this->_mark < 0 || this->_cursor->_byte < 0) return ByteView();
+  auto mark = static_cast<unsigned long long int>(this->_mark);
+  if (mark >= this->_base) return this->_buffer.slice(mark - this->_base, this->_position - mark);
+
+  // The slice began in a previous buffer, its bytes have been kept.
+  this->_carry.insert(this->_carry.end(), this->_buffer.data(), this->_buffer.data() + (this->_position - this->_base));
+  return ByteView(this->_carry.data(), this->_carry.size());
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamMachine::compile()
+{
+  if (!this->_isStarted)
+    {
+      if (!this->run()) return false;
+      this->_isStarted = true;
+    }
+  if (this->regions().size() != 1)
+    {
+#ifdef WARNING
+      std::cout << "WARNING: StreamMachine::compile, machine \"" << *this->name() << "\" doesn't have a single region." << std::endl;
+#endif
+      return false;
+    }
+  auto region = this->regions().front();
+
+  // Indexes of the states that can be active once the machine has been initialized.
+  std::vector<CompiledState> states;
+  std::unordered_map<const SimpleState*, int> indexes;
+  for (auto it = region->states().begin(); it != region->states().end(); it++)
+    {
+      if ((*it)->kind() != StateKind::Simple && (*it)->kind() != StateKind::Final) continue;
+      indexes[it->get()] = static_cast<int>(states.size());
+      CompiledState state;
+      state._state = *it;
+      state._stops = 0;
+      states.push_back(state);
+    }
+  if (!region->activeState() || indexes.find(region->activeState().get()) == indexes.end())
+    {
+#ifdef WARNING
+      std::cout << "WARNING: StreamMachine::compile, machine \"" << *this->name() << "\" isn't in a simple state." << std::endl;
+#endif
+      return false;
+    }
+
+  std::vector<std::int16_t> table(states.size() * 256, -1);
+  std::vector<CompiledTransition> transitions;
+  for (std::size_t i = 0; i < states.size(); i++)
+    {
+      auto state = states[i]._state;
+      bool is_compilable = !state->hasDispatchedTransitions();
+      for (auto it = state->transitions().begin(); it != state->transitions().end() && is_compilable; it++)
+	{
+	  auto byte_event = std::dynamic_pointer_cast<ByteEvent>((*it)->trigger());
+	  auto target = ((*it)->reachableStates() == 1) ? region->findStateHere((*it)->reachableSymbol(0)) : nullptr;
+	  is_compilable = byte_event && !(*it)->guard() && (*it)->kind() != TransitionKind::Local && target &&
+	    indexes.find(target.get()) != indexes.end() && !(*it)->hasAsyncEffect();
+	  if (!is_compilable) break;
+	  
+	  // The transitions are in the order they are checked, a byte fires the first one whose class contains it.
+	  CompiledTransition transition;
+	  transition._transition = *it;
+	  transition._target = indexes[target.get()];
+	  auto index = static_cast<std::int16_t>(transitions.size());
+	  transitions.push_back(transition);
+	  for (int byte = 0; byte < 256; byte++)
+	    if (table[i * 256 + byte] < 0 && byte_event->byteClass().contains(static_cast<unsigned char>(byte)))
+	      table[i * 256 + byte] = index;
+	}
+      if (!is_compilable || transitions.size() > 32767)
+	{
+#ifdef WARNING
+	  std::cout << "WARNING: StreamMachine::compile, machine \"" << *this->name() << "\" can't be compiled, state \"" <<
+	    *state->name() << "\" has transitions that are not triggered by byte events only." << std::endl;
+#endif
+	  return false;
+	}
+
+      // The bytes to search for when the state has at most four of them.
+      for (int byte = 0; byte < 256; byte++)
+	if (table[i * 256 + byte] >= 0)
+	  {
+	    if (states[i]._stops < 4) states[i]._stopBytes[states[i]._stops] = static_cast<unsigned char>(byte);
+	    if (states[i]._stops < 5) states[i]._stops++;
+	  }
+    }
+
+  this->_region = region;
+  this->_states.swap(states);
+  this->_transitions.swap(transitions);
+  this->_table.swap(table);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamMachine::feedCompiled(const unsigned char *in_bytes, std::size_t in_size)
+{
+  int state = this->compiledState();
+  if (state < 0) return false;
+
+  std::size_t position = 0;
+  while (position < in_size)
+    {
+      const CompiledState &compiled_state = this->_states[state];
+      const std::int16_t *row = &this->_table[state * 256];
+      if (this->_scan == ByteScan::Vector && compiled_state._stops <= 4)
+	position = StreamMachine::scanVector(compiled_state, in_bytes, position, in_size);
+      else position = StreamMachine::scanScalar(row, in_bytes, position, in_size);
+      if (position == in_size) break;
+
+      state = this->fireCompiled(row[in_bytes[position]], in_bytes[position], position);
+      if (state < 0) return false;
+      position++;
+    }
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+int StreamMachine::compiledState() const
+{
+  for (std::size_t i = 0; i < this->_states.size(); i++)
+    if (this->_states[i]._state == this->_region->activeState()) return static_cast<int>(i);
+  std::cout << "ERROR: StreamMachine::compiledState, machine \"" << *this->name() << "\" active state isn't compiled." << std::endl;
+  return -1;
+}
+
+// -----------------------------------------------------------------------------------
+int StreamMachine::fireCompiled(std::int16_t in_transition, unsigned char in_byte, std::size_t in_position)
+{
+  // The byte fires its transition as a run of the machine would.
+  const CompiledTransition &compiled_transition = this->_transitions[in_transition];
+  this->_cursor->_byte = in_byte;
+  this->_position = this->_base + in_position;
+  if (compiled_transition._transition->kind() == TransitionKind::Internal)
+    {
+      compiled_transition._transition->fire();
+      if (!compiled_transition._transition->init()) return -1;
+    }
+  else if (!this->_region->reach(compiled_transition._transition))
+    {
+      std::cout << "ERROR: StreamMachine::fireCompiled, machine \"" << *this->name() << "\" transition \"" <<
+	*compiled_transition._transition->name() << "\" failed at position " << this->_position << "." << std::endl;
+      return -1;
+    }
+  return compiled_transition._target;
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t StreamMachine::scanScalar(const std::int16_t *in_row, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size)
+{
+  while (in_position < in_size && in_row[in_bytes[in_position]] < 0) in_position++;
+  return in_position;
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t StreamMachine::scanVector(const CompiledState &in_state, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size)
+{
+  if (in_state._stops == 0) return in_size;
+  // Missing stop bytes are replaced by the first one, so that four bytes are always compared.
+  unsigned char stops[4];
+  for (int i = 0; i < 4; i++) stops[i] = in_state._stopBytes[i < in_state._stops ? i : 0];
+
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+  // The instructions are chosen once, from the processor the library runs on rather than the one it was built for.
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  static const bool has_sse2 = __builtin_cpu_supports("sse2");
+  if (has_avx2) in_position = StreamMachine::scanAvx2(stops, in_bytes, in_position, in_size);
+  else if (has_sse2) in_position = StreamMachine::scanSse2(stops, in_bytes, in_position, in_size);
+#endif
+
+  // Remaining bytes, or all bytes without vector instructions.
+  while (in_position < in_size && in_bytes[in_position] != stops[0] && in_bytes[in_position] != stops[1] &&
+	 in_bytes[in_position] != stops[2] && in_bytes[in_position] != stops[3])
+    in_position++;
+  return in_position;
+}
+
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__)
+// -----------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+std::size_t StreamMachine::scanAvx2(const unsigned char *in_stops, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size)
+{
+  const __m256i stop0 = _mm256_set1_epi8(static_cast<char>(in_stops[0]));
+  const __m256i stop1 = _mm256_set1_epi8(static_cast<char>(in_stops[1]));
+  const __m256i stop2 = _mm256_set1_epi8(static_cast<char>(in_stops[2]));
+  const __m256i stop3 = _mm256_set1_epi8(static_cast<char>(in_stops[3]));
+  while (in_position + 32 <= in_size)
+    {
+      __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in_bytes + in_position));
+      __m256i found = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, stop0), _mm256_cmpeq_epi8(bytes, stop1)),
+				      _mm256_or_si256(_mm256_cmpeq_epi8(bytes, stop2), _mm256_cmpeq_epi8(bytes, stop3)));
+      unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(found));
+      if (mask) return in_position + __builtin_ctz(mask);
+      in_position += 32;
+    }
+  return in_position;
+}
+
+// -----------------------------------------------------------------------------------
+__attribute__((target("sse2")))
+std::size_t StreamMachine::scanSse2(const unsigned char *in_stops, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size)
+{
+  const __m128i stop0 = _mm_set1_epi8(static_cast<char>(in_stops[0]));
+  const __m128i stop1 = _mm_set1_epi8(static_cast<char>(in_stops[1]));
+  const __m128i stop2 = _mm_set1_epi8(static_cast<char>(in_stops[2]));
+  const __m128i stop3 = _mm_set1_epi8(static_cast<char>(in_stops[3]));
+  while (in_position + 16 <= in_size)
+    {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in_bytes + in_position));
+      __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, stop0), _mm_cmpeq_epi8(bytes, stop1)),
+				   _mm_or_si128(_mm_cmpeq_epi8(bytes, stop2), _mm_cmpeq_epi8(bytes, stop3)));
+      unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+      if (mask) return in_position + __builtin_ctz(mask);
+      in_position += 16;
+    }
+  return in_position;
+}
+#endif
+
+//#########################################################################################################
+/*
+  StreamBatch
+*/
+
+// -----------------------------------------------------------------------------------
+StreamBatch::StreamBatch()
+{
+}
+
+// -----------------------------------------------------------------------------------
+StreamBatch::~StreamBatch()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamBatch::add(std::shared_ptr<StreamMachine> in_machine)
+{
+  if (!in_machine->isCompiled() && !in_machine->compile())
+    {
+      std::cout << "ERROR: StreamBatch::add, machine \"" << *in_machine->name() << "\" can't be compiled." << std::endl;
+      return false;
+    }
+  this->_machines.push_back(in_machine);
+  this->_states.push_back(-1);
+  this->_rows.push_back(nullptr);
+  this->_bytes.push_back(nullptr);
+  this->_positions.push_back(0);
+  this->_sizes.push_back(0);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamBatch::feed(const std::vector<ByteView> &in_buffers)
+{
+  if (in_buffers.size() != this->_machines.size())
+    {
+      std::cout << "ERROR: StreamBatch::feed, " << in_buffers.size() << " buffers for " << this->_machines.size() << " machines." << std::endl;
+      return false;
+    }
+
+  bool is_fed = true;
+  for (std::size_t lane = 0; lane < this->_machines.size(); lane++)
+    {
+      auto &machine = *this->_machines[lane];
+      this->_rows[lane] = nullptr;
+      if (!machine.beginFeed(in_buffers[lane]))
+	{
+	  is_fed = false;
+	  continue;
+	}
+      this->_states[lane] = machine.compiledState();
+      if (this->_states[lane] < 0)
+	{
+	  is_fed = false;
+	  continue;
+	}
+      this->_rows[lane] = &machine._table[this->_states[lane] * 256];
+      this->_bytes[lane] = in_buffers[lane].data();
+      this->_positions[lane] = 0;
+      this->_sizes[lane] = in_buffers[lane].size();
+    }
+
+  // The lanes are fed by groups, the last ones alone.
+  std::size_t lane = 0;
+  for (; lane + StreamBatch::GROUP <= this->_machines.size(); lane += StreamBatch::GROUP)
+    if (!this->feedGroup(lane)) is_fed = false;
+  for (; lane < this->_machines.size(); lane++)
+    if (!this->feedLane(lane)) is_fed = false;
+
+  for (lane = 0; lane < this->_machines.size(); lane++)
+    {
+      if (this->_rows[lane]) this->_machines[lane]->endFeed();
+      else this->_machines[lane]->_cursor->_byte = -1;
+    }
+  return is_fed;
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamBatch::feedGroup(std::size_t in_lane)
+{
+  for (std::size_t k = 0; k < StreamBatch::GROUP; k++)
+    if (!this->_rows[in_lane + k])
+      {
+	// A lane has failed, the other ones are fed alone.
+	for (k = 0; k < StreamBatch::GROUP; k++) this->feedLane(in_lane + k);
+	return false;
+      }
+
+  const std::int16_t **rows = &this->_rows[in_lane];
+  const unsigned char **bytes = &this->_bytes[in_lane];
+  std::size_t *positions = &this->_positions[in_lane];
+  const std::size_t *sizes = &this->_sizes[in_lane];
+  while (true)
+    {
+      // Bytes left in each lane of the group.
+      std::size_t steps = sizes[0] - positions[0];
+      for (std::size_t k = 1; k < StreamBatch::GROUP; k++) steps = std::min(steps, sizes[k] - positions[k]);
+      if (steps == 0) break;
+
+      // A byte of each lane in turn, the lookups of the different lanes don't wait for each other.
+      const unsigned char *bytes0 = bytes[0] + positions[0], *bytes1 = bytes[1] + positions[1];
+      const unsigned char *bytes2 = bytes[2] + positions[2], *bytes3 = bytes[3] + positions[3];
+      const std::int16_t *row0 = rows[0], *row1 = rows[1], *row2 = rows[2], *row3 = rows[3];
+      std::size_t step = 0;
+      while (step < steps && (row0[bytes0[step]] & row1[bytes1[step]] & row2[bytes2[step]] & row3[bytes3[step]]) < 0) step++;
+      for (std::size_t k = 0; k < StreamBatch::GROUP; k++) positions[k] += step;
+      if (step == steps) continue;
+
+      // At least one lane fires a transition.
+      for (std::size_t k = 0; k < StreamBatch::GROUP; k++)
+	{
+	  std::int16_t transition = rows[k][bytes[k][positions[k]]];
+	  if (transition >= 0 && !this->fire(in_lane + k, transition))
+	    {
+	      // The other lanes are fed alone, from the byte they're at.
+	      for (std::size_t j = 0; j < StreamBatch::GROUP; j++) this->feedLane(in_lane + j);
+	      return false;
+	    }
+	  positions[k]++;
+	}
+    }
+
+  // The lanes that have bytes left are ended alone.
+  bool is_fed = true;
+  for (std::size_t k = 0; k < StreamBatch::GROUP; k++)
+    if (!this->feedLane(in_lane + k)) is_fed = false;
+  return is_fed;
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamBatch::feedLane(std::size_t in_lane)
+{
+  if (!this->_rows[in_lane]) return false;
+  std::size_t position = this->_positions[in_lane];
+  while (position < this->_sizes[in_lane])
+    {
+      position = StreamMachine::scanScalar(this->_rows[in_lane], this->_bytes[in_lane], position, this->_sizes[in_lane]);
+      if (position == this->_sizes[in_lane]) break;
+      this->_positions[in_lane] = position;
+      if (!this->fire(in_lane, this->_rows[in_lane][this->_bytes[in_lane][position]])) return false;
+      position++;
+    }
+  this->_positions[in_lane] = position;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool StreamBatch::fire(std::size_t in_lane, std::int16_t in_transition)
+{
+  auto &machine = *this->_machines[in_lane];
+  std::size_t position = this->_positions[in_lane];
+  int state = machine.fireCompiled(in_transition, this->_bytes[in_lane][position], position);
+  if (state < 0)
+    {
+      this->_rows[in_lane] = nullptr;
+      return false;
+    }
+  this->_states[in_lane] = state;
+  this->_rows[in_lane] = &machine._table[state * 256];
+  return true;
+}
@@ -0,0 +1,392 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include "machine.hpp"
+#include "ringbuffer.hpp"
+
+#include <cstddef> // size_t
+#include <cstdint> // int16_t, uint64_t
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fisa
+{
+  //#########################################################################################################
+  /*
+    ByteView
+  */
+  //! View over a contiguous sequence of bytes owned by someone else, copied without copying the bytes.
+
+  class ByteView
+  {
+  public:
+    //! Construct an empty view.
+    ByteView() : _data(nullptr), _size(0) {}
+
+    //! Construct a view over the "in_size" bytes at the address specified in first argument.
+    ByteView(const void *in_data, std::size_t in_size) : _data(static_cast<const unsigned char*>(in_data)), _size(in_size) {}
+
+    //! Construct a view over the characters of the string specified in argument.
+    ByteView(const std::string &in_string) : _data(reinterpret_cast<const unsigned char*>(in_string.data())), _size(in_string.size()) {}
+
+    //! Returns the address of the first byte.
+    const unsigned char* data() const {return this->_data;}
+
+    //! Returns the number of bytes.
+    std::size_t size() const {return this->_size;}
+
+    //! Returns true if the view doesn't have any byte.
+    bool empty() const {return this->_size == 0;}
+
+    //! Returns the byte at the position specified in argument.
+    unsigned char operator [] (std::size_t in_position) const {return this->_data[in_position];}
+
+    //! Returns the address of the first byte, for range-based loops.
+    const unsigned char* begin() const {return this->_data;}
+
+    //! Returns the address following the last byte.
+    const unsigned char* end() const {return this->_data + this->_size;}
+
+    //! Returns the view over at most "in_count" bytes from the position specified in first argument.
+    ByteView slice(std::size_t in_position, std::size_t in_count) const;
+
+    //! Returns a copy of the bytes.
+    std::string toString() const {return std::string(reinterpret_cast<const char*>(this->_data), this->_size);}
+
+  private:
+    const unsigned char *_data;
+    std::size_t _size;
+  };
+
+  //#########################################################################################################
+  /*
+    ByteClass
+  */
+  //! Set of byte values, checked with a single bit test.
+
+  class ByteClass
+  {
+  public:
+    //! Construct an empty class.
+    ByteClass();
+
+    //! Returns the class of all bytes.
+    static ByteClass any();
+
+    //! Returns the class of the byte specified in argument.
+    static ByteClass of(unsigned char in_byte);
+
+    //! Returns the class of the bytes between the bytes specified in arguments, included.
+    static ByteClass range(unsigned char in_first, unsigned char in_last);
+
+    //! Returns the class of the characters of the string specified in argument.
+    static ByteClass oneOf(const char *in_bytes);
+
+    //! Returns true if the byte specified in argument belongs to the class.
+    bool contains(unsigned char in_byte) const {return (this->_bits[in_byte >> 6] >> (in_byte & 63)) & 1;}
+
+    //! Returns true if no byte belongs to the class.
+    bool empty() const;
+
+    //! Union of classes.
+    ByteClass operator | (const ByteClass &in_class) const;
+
+    //! Intersection of classes.
+    ByteClass operator & (const ByteClass &in_class) const;
+
+    //! Complement of the class.
+    ByteClass operator ~ () const;
+
+    bool operator == (const ByteClass &in_class) const;
+    bool operator != (const ByteClass &in_class) const;
+
+  private:
+    std::uint64_t _bits[4];
+  };
+
+  //! Byte being fed to a StreamMachine, -1 between two calls of the "feed" method.
+  typedef struct ByteCursor
+  {
+    int _byte;
+  } ByteCursor;
+
+  //#########################################################################################################
+  /*
+    ByteEvent
+  */
+  //! Event triggered when the byte fed to a StreamMachine belongs to a ByteClass.
+  /** Byte events are created with StreamMachine's "byteEvent" method. **/
+
+  class ByteEvent : public Event
+  {
+  public:
+    //! Construct an event on the byte class specified in first argument, reading the cursor of a StreamMachine.
+    ByteEvent(const ByteClass &in_class, std::shared_ptr<const ByteCursor> in_cursor);
+
+    //! Destructor.
+    ~ByteEvent();
+
+    //! Specializes Event's "init" method.
+    bool init();
+
+    //! Specializes Event's "happened" method.
+    bool happened() const;
+
+    //! Returns the class of the bytes that trigger the event.
+    const ByteClass &byteClass() const {return this->_class;}
+
+  private:
+    ByteClass _class;
+    std::shared_ptr<const ByteCursor> _cursor;
+  };
+
+  //! Callback receiving a slice of the fed bytes, see StreamMachine's "onSlice" method.
+  typedef std::function<void(ByteView)> SliceCallback;
+
+  //! Ways a compiled StreamMachine searches the next byte that fires a transition.
+  enum class ByteScan
+  {
+    Scalar, // A table lookup for each byte.
+    Vector  // Up to four bytes are searched 16 (SSE2) or 32 (AVX2, if the processor supports it at run time) bytes at a time on x86 with GCC or Clang.
+  };
+
+  //#########################################################################################################
+  /*
+    StreamMachine
+  */
+  //! Machine that decodes a stream of bytes, its transitions being triggered by ByteEvent.
+  /**
+   * Each byte fed to the machine makes one run of the machine, during which the transitions 
+   * triggered by a ByteEvent whose class contains the byte can be fired. A byte that triggers 
+   * no transition is skipped.
+   * Slices of the stream are handed to callbacks without copying: a slice begins after the 
+   * byte on which a transition set with "markOn" is fired, and ends before the byte on which 
+   * a transition set with "onSlice" is fired. Only a slice spanning several calls of "feed" 
+   * is copied, once, since the previous buffers may have been released.
+   * A machine whose transitions are all triggered by byte events can be compiled into a table 
+   * with an entry for each state and byte value, see the "compile" method.
+   **/
+
+  class StreamMachine : public Machine
+  {
+    friend class StreamBatch;
+    
+  public:
+    //! Construct a machine with name specified in argument.
+    StreamMachine(const char *in_machine_name);
+
+    //! Destructor.
+    virtual ~StreamMachine();
+
+    //! Runs the machine once for each byte of the view specified in argument. The first call initializes the machine.
+    bool feed(ByteView in_bytes);
+
+    //! Feeds the bytes stored in the ring buffer, which are left in it.
+    bool feed(const RingBuffer<unsigned char> &in_buffer);
+
+    //! Compiles the machine into a table giving, for each state and byte value, the transition fired.
+    /**
+     * The machine must have a single region, whose states are simple or final states with 
+     * transitions triggered by byte events only, without guard nor asynchronous effect, and 
+     * reaching a simple or final state of the region. Otherwise false is returned and the 
+     * machine is still run once per byte. The first call initializes the machine.
+     * The "feed" method then only looks the bytes up in the table: the bytes that fire no 
+     * transition from the active state are skipped by the search set with "setScan", the others 
+     * fire their transition exactly as the machine would (exit, effect, entry, slices).
+     **/
+    bool compile();
+
+    //! Returns true if the machine has been compiled.
+    bool isCompiled() const {return !this->_table.empty();}
+
+    //! Sets how a compiled machine searches the bytes that fire transitions. ByteScan::Vector is the default.
+    void setScan(ByteScan in_scan) {this->_scan = in_scan;}
+
+    //! Returns the byte being fed, -1 between two calls of "feed".
+    int currentByte() const {return this->_cursor->_byte;}
+
+    //! Returns the position of the byte being fed in the stream, that is the number of bytes fed before it.
+    unsigned long long int position() const {return this->_position;}
+
+  protected:
+    //! Creates an event triggered by the bytes of the class specified in argument.
+    std::shared_ptr<ByteEvent> byteEvent(const ByteClass &in_class);
+
+    //! Begins a slice after the byte on which the transition with the name specified in argument is fired.
+    bool markOn(const char *in_transition_name);
+
+    //! Calls the callback in second argument with the slice that ends before the byte on which the transition is fired.
+    /**
+     * The slice is only valid during the call. The callback replaces the effect callback of 
+     * the transition (see Machine's "onEffect" method). After the call, no slice is begun, 
+     * unless the transition is set with "markOn" as well.
+     **/
+    bool onSlice(const char *in_transition_name, SliceCallback in_callback);
+
+  private:
+    //! Slicing done when a transition set with "markOn" or "onSlice" is fired.
+    typedef struct Slicing
+    {
+      bool _isMark;
+      SliceCallback _callback;
+    } Slicing;
+
+    //! Effect callback of the transitions set with "markOn" or "onSlice".
+    void slice(Symbol in_transition_symbol);
+
+    //! Returns the bytes from the beginning of the slice to the byte being fed.
+    ByteView currentSlice();
+
+    //! Starts a call of "feed" over the bytes specified in argument. The first call initializes the machine.
+    bool beginFeed(ByteView in_bytes);
+
+    //! Ends a call of "feed", keeping the bytes of an unfinished slice.
+    void endFeed();
+
+    //! Feeds the bytes with the compiled table.
+    bool feedCompiled(const unsigned char *in_bytes, std::size_t in_size);
+
+    //! Returns the index of the active state in the compiled table, -1 if it isn't compiled.
+    int compiledState() const;
+
+    //! Fires the transition of index "in_transition" on the byte at position "in_position" of the buffer, returns the index of the reached state or -1.
+    int fireCompiled(std::int16_t in_transition, unsigned char in_byte, std::size_t in_position);
+
+    //! Transition of the compiled table.
+    typedef struct CompiledTransition
+    {
+      std::shared_ptr<Transition> _transition;
+      int _target; // Index of the reached state.
+    } CompiledTransition;
+
+    //! State of the compiled table.
+    typedef struct CompiledState
+    {
+      std::shared_ptr<SimpleState> _state;
+      int _stops; // Number of byte values that fire a transition, 0 to 4 for the vector search, 5 for more.
+      unsigned char _stopBytes[4];
+    } CompiledState;
+
+    //! Returns the position of the first byte, from "in_position", whose entry in the row of the table isn't -1.
+    static std::size_t scanScalar(const std::int16_t *in_row, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size);
+
+    //! Returns the position of the first byte, from "in_position", that is one of the stop bytes of the state.
+    static std::size_t scanVector(const CompiledState &in_state, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size);
+
+    //! Searches the four stop bytes 32 bytes at a time, returns the position where the whole blocks end or the first stop byte.
+    /** Only defined on x86, where it is compiled for AVX2 whatever the build flags. **/
+    static std::size_t scanAvx2(const unsigned char *in_stops, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size);
+
+    //! Searches the four stop bytes 16 bytes at a time, returns the position where the whole blocks end or the first stop byte.
+    /** Only defined on x86, where it is compiled for SSE2 whatever the build flags. **/
+    static std::size_t scanSse2(const unsigned char *in_stops, const unsigned char *in_bytes, std::size_t in_position, std::size_t in_size);
+
+    std::shared_ptr<ByteCursor> _cursor;
+    std::unordered_map<Symbol, Slicing> _slicings;
+    bool _isStarted;
+    ByteView _buffer; // Bytes being fed.
+    unsigned long long int _base; // Position of the first byte of the buffer in the stream.
+    unsigned long long int _position;
+    long long int _mark; // Position of the beginning of the slice, -1 if there is none.
+    std::vector<unsigned char> _carry; // Bytes of the slice fed by the previous calls of "feed".
+    std::vector<std::int16_t> _table; // Index of the transition fired for each state and byte value, -1 if there is none.
+    std::vector<CompiledState> _states;
+    std::vector<CompiledTransition> _transitions;
+    std::shared_ptr<Region> _region;
+    ByteScan _scan;
+  };
+
+  //#########################################################################################################
+  /*
+    StreamBatch
+  */
+  //! Compiled stream machines fed together, one buffer each.
+  /**
+   * A single compiled machine waits, for each byte, for the lookup of the table entry 
+   * of its active state. The batch feeds the machines by groups of four, a byte of each 
+   * machine of the group in turn, so that the lookups of the independent machines are 
+   * in flight at the same time. The machines 
+   * fire the same transitions, with the same effects and slices, as if each one were 
+   * fed its own buffer. The table is looked up for each byte, the search set with 
+   * StreamMachine's "setScan" isn't used.
+   **/
+
+  class StreamBatch
+  {
+  public:
+    //! Constructor.
+    StreamBatch();
+
+    //! Destructor.
+    virtual ~StreamBatch();
+
+    //! Adds the machine specified in argument, which is compiled if it isn't. Returns false if it can't be compiled.
+    bool add(std::shared_ptr<StreamMachine> in_machine);
+
+    //! Returns the number of machines.
+    std::size_t size() const {return this->_machines.size();}
+
+    //! Returns the machine of index specified in argument.
+    std::shared_ptr<StreamMachine> machine(std::size_t in_index) const {return this->_machines[in_index];}
+
+    //! Feeds each machine with the buffer of same index, there must be a buffer for each machine.
+    /**
+     * Returns false if a machine fails, the other machines are fed all their bytes.
+     **/
+    bool feed(const std::vector<ByteView> &in_buffers);
+
+  private:
+    //! Number of machines fed together, the lookups of a group are written out in "feedGroup".
+    static const std::size_t GROUP = 4;
+
+    //! Feeds the group of machines beginning at the lane specified in argument.
+    bool feedGroup(std::size_t in_lane);
+
+    //! Feeds the bytes left to the machine of the lane specified in argument.
+    bool feedLane(std::size_t in_lane);
+
+    //! Fires the transition of index "in_transition" on the current byte of the lane, false if the machine fails.
+    bool fire(std::size_t in_lane, std::int16_t in_transition);
+
+    std::vector<std::shared_ptr<StreamMachine>> _machines;
+    // State of each machine while it's fed, a vector for each field so that a turn reads contiguous values.
+    std::vector<int> _states; // Index of the active state.
+    std::vector<const std::int16_t*> _rows; // Row of the table for the active state, null when the machine has failed.
+    std::vector<const unsigned char*> _bytes;
+    std::vector<std::size_t> _positions;
+    std::vector<std::size_t> _sizes;
+  };
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "symbols.hpp"
+
+#include <iostream>
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  SymbolTable
+*/
+
+// -----------------------------------------------------------------------------------
+SymbolTable::SymbolTable() : _size(0)
+{
+  for (std::size_t i = 0; i < SymbolTable::CHUNKS; i++) this->_chunks[i] = nullptr;
+}
+
+// -----------------------------------------------------------------------------------
+SymbolTable::~SymbolTable()
+{
+  for (std::size_t i = 0; i < SymbolTable::CHUNKS; i++) delete [] this->_chunks[i];
+}
+
+// -----------------------------------------------------------------------------------
+SymbolTable &SymbolTable::instance()
+{
+  static SymbolTable table;
+  return table;
+}
+
+// -----------------------------------------------------------------------------------
+Symbol SymbolTable::intern(const char *in_name)
+{
+  return SymbolTable::intern(std::string(in_name));
+}
+
+// -----------------------------------------------------------------------------------
+Symbol SymbolTable::intern(const std::string &in_name)
+{
+  SymbolTable &table = SymbolTable::instance();
+  std::lock_guard<std::mutex> lock(table._mutex);
+  
+  auto it = table._symbols.find(in_name);
+  if (it != table._symbols.end()) return (*it).second;
+  
+  std::size_t size = table._size.load(std::memory_order_relaxed);
+  Symbol symbol = static_cast<Symbol>(size);
+  table.entry(symbol) = std::make_shared<std::string>(in_name);
+  table._symbols[in_name] = symbol;
+
+  // The name is written before it is made readable.
+  table._size.store(size + 1, std::memory_order_release);
+  return symbol;
+}
+
+// -----------------------------------------------------------------------------------
+bool SymbolTable::find(const char *in_name, Symbol &out_symbol)
+{
+  SymbolTable &table = SymbolTable::instance();
+  std::lock_guard<std::mutex> lock(table._mutex);
+  
+  auto it = table._symbols.find(in_name);
+  if (it == table._symbols.end()) return false;
+  out_symbol = (*it).second;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<std::string> SymbolTable::name(Symbol in_symbol)
+{
+  SymbolTable &table = SymbolTable::instance();
+  if (in_symbol >= table._size.load(std::memory_order_acquire))
+    {
+      std::cout << "ERROR: SymbolTable::name, symbol " << in_symbol << " not found." << std::endl;
+      return nullptr;
+    }
+  return table.entry(in_symbol);
+}
+
+// -----------------------------------------------------------------------------------
+std::size_t SymbolTable::size()
+{
+  return SymbolTable::instance()._size.load(std::memory_order_acquire);
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<std::string> &SymbolTable::entry(Symbol in_symbol)
+{
+  // Chunk k holds the symbols from FIRST_CHUNK * (2^k - 1).
+  std::size_t position = in_symbol / SymbolTable::FIRST_CHUNK + 1;
+  std::size_t chunk = 0;
+  while (position >> (chunk + 1)) chunk++;
+  std::size_t first = SymbolTable::FIRST_CHUNK * ((static_cast<std::size_t>(1) << chunk) - 1);
+  
+  // Chunks are only allocated by insertions, before the symbols they hold are readable.
+  if (!this->_chunks[chunk]) this->_chunks[chunk] = new std::shared_ptr<std::string>[SymbolTable::FIRST_CHUNK << chunk];
+  return this->_chunks[chunk][in_symbol - first];
+}
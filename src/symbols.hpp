@@ -0,0 +1,98 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef SYMBOLS_HPP
+#define SYMBOLS_HPP
+
+#include <atomic>
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+
+namespace fisa
+{
+  //! Identifier of an interned name. Two names are equal if and only if their symbols are equal.
+  typedef std::uint32_t Symbol;
+
+  //#########################################################################################################
+  /*
+    SymbolTable
+  */
+  //! Global table of interned names of states, regions, transitions and machines.
+  /**
+   * Each distinct name is stored once and identified by a Symbol, so that objects keep a 32-bit 
+   * identifier instead of their own copy of the name, and names are compared as integers.
+   * The names are stored in chunks that are never moved nor freed before the end of the process, 
+   * so that they are read without locking. Only the insertions and the searches by name lock 
+   * the table.
+   **/
+
+  class SymbolTable
+  {
+  public:
+    //! Returns the symbol of the name specified in argument, adding the name to the table if needed.
+    static Symbol intern(const char *in_name);
+
+    //! Returns the symbol of the name specified in argument, adding the name to the table if needed.
+    static Symbol intern(const std::string &in_name);
+
+    //! Retrieves the symbol of the name specified in argument, without adding it. Returns false if the name isn't in the table.
+    static bool find(const char *in_name, Symbol &out_symbol);
+
+    //! Returns the name of the symbol specified in argument.
+    static std::shared_ptr<std::string> name(Symbol in_symbol);
+
+    //! Returns the number of names in the table.
+    static std::size_t size();
+
+  private:
+    SymbolTable();
+    ~SymbolTable();
+
+    static SymbolTable &instance();
+
+    //! Returns the entry of the name of the symbol specified in argument, in the chunk that holds it.
+    std::shared_ptr<std::string> &entry(Symbol in_symbol);
+
+    //! Number of names in the first chunk, each next chunk holds twice as many names as the previous one.
+    static const std::size_t FIRST_CHUNK = 64;
+
+    //! Number of chunks, enough for all the symbols.
+    static const std::size_t CHUNKS = 27;
+
+    std::mutex _mutex; // Protects the insertions and the searches by name.
+    std::unordered_map<std::string, Symbol> _symbols;
+    std::shared_ptr<std::string> *_chunks[CHUNKS];
+    std::atomic<std::size_t> _size; // The names of the symbols below are readable.
+  };
+}
+
+#endif
@@ -39,6 +39,212 @@ using namespace fisa;
 // -----------------------------------------------------------------------------------
 Event::~Event() {}
 
+// -----------------------------------------------------------------------------------
+SignalId Event::signal() const
+{
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------------
+bool Event::consume(std::shared_ptr<const Signal> in_signal)
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------------
+bool Event::listen(std::shared_ptr<EventListener> in_listener)
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------------
+bool Event::isCompletion() const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------------
+bool Event::deadline(long long int &out_microseconds) const
+{
+  return false;
+}
+
+//#######################################################################################
+/*
+  EventForwarder
+*/
+
+// -----------------------------------------------------------------------------------
+EventForwarder::EventForwarder(std::weak_ptr<EventListener> in_listener, const Event *in_event) :
+  _listener(in_listener), _event(in_event)
+{
+}
+
+// -----------------------------------------------------------------------------------
+void EventForwarder::changed(const Event *in_event)
+{
+  auto listener = this->_listener.lock();
+  if (listener) listener->changed(this->_event);
+}
+
+//#######################################################################################
+/*
+  CompletionEvent
+*/
+
+// -----------------------------------------------------------------------------------
+CompletionEvent::CompletionEvent() {}
+
+// -----------------------------------------------------------------------------------
+CompletionEvent::~CompletionEvent() {}
+
+// -----------------------------------------------------------------------------------
+bool CompletionEvent::init()
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool CompletionEvent::happened() const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------------
+bool CompletionEvent::isCompletion() const
+{
+  return true;
+}
+
+//#######################################################################################
+/*
+  CompoundGuard
+*/
+
+// -----------------------------------------------------------------------------------
+CompoundGuard::CompoundGuard(const std::vector<std::shared_ptr<Event> > &in_required,
+			     const std::vector<std::shared_ptr<Event> > &in_excluded) :
+  _required(in_required), _excluded(in_excluded)
+{
+}
+
+// -----------------------------------------------------------------------------------
+CompoundGuard::~CompoundGuard() {}
+
+// -----------------------------------------------------------------------------------
+bool CompoundGuard::init()
+{
+  for (auto it = this->_required.begin(); it != this->_required.end(); it++)
+    if (!(*it)->init()) return false;
+  for (auto it = this->_excluded.begin(); it != this->_excluded.end(); it++)
+    if (!(*it)->init()) return false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool CompoundGuard::happened() const
+{
+  for (auto it = this->_required.begin(); it != this->_required.end(); it++)
+    if (!(*it)->happened()) return false;
+  for (auto it = this->_excluded.begin(); it != this->_excluded.end(); it++)
+    if ((*it)->happened()) return false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool CompoundGuard::listen(std::shared_ptr<EventListener> in_listener)
+{
+  bool notifying = true;
+  auto forwarder = std::make_shared<EventForwarder>(in_listener, this);
+  this->_forwarders.push_back(forwarder);
+  for (auto it = this->_required.begin(); it != this->_required.end(); it++)
+    if (!(*it)->listen(forwarder)) notifying = false;
+  for (auto it = this->_excluded.begin(); it != this->_excluded.end(); it++)
+    if (!(*it)->listen(forwarder)) notifying = false;
+  return notifying;
+}
+
+//#######################################################################################
+/*
+  MissComponent
+*/
+
+// -----------------------------------------------------------------------------------
+MissComponent::MissComponent() : _policy(MissPolicy::Skip), _missedWhen(-1)
+{
+}
+
+// -----------------------------------------------------------------------------------
+MissComponent::~MissComponent()
+{
+}
+
+// -----------------------------------------------------------------------------------
+void MissComponent::setMissPolicy(MissPolicy in_policy)
+{
+  this->_policy = in_policy;
+}
+
+// -----------------------------------------------------------------------------------
+MissPolicy MissComponent::missPolicy() const
+{
+  return this->_policy;
+}
+
+// -----------------------------------------------------------------------------------
+void MissComponent::setMetrics(std::shared_ptr<TimeMetrics> in_metrics)
+{
+  this->_metrics = in_metrics;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<TimeMetrics> MissComponent::metrics() const
+{
+  return this->_metrics;
+}
+
+// -----------------------------------------------------------------------------------
+void MissComponent::onLate(LateCallback in_callback)
+{
+  this->_lateCallback = std::move(in_callback);
+}
+
+// -----------------------------------------------------------------------------------
+bool MissComponent::miss(long long int in_when, long long int in_now) const
+{
+  bool is_fired = this->_policy != MissPolicy::Skip;
+  if (this->_missedWhen == in_when) return is_fired;
+  this->_missedWhen = in_when;
+
+  long long int lateness = in_now - in_when;
+#ifdef WARNING
+  std::cout << "WARNING: MissComponent::miss, deadline missed by " << lateness << " microseconds, " <<
+    (is_fired ? "fired late." : "skipped.") << std::endl;
+#endif
+  if (this->_metrics)
+    {
+      this->_metrics->_missed++;
+      if (is_fired) this->_metrics->_firedLate++;
+      else this->_metrics->_skipped++;
+      long long int max_lateness = this->_metrics->_maxLateness.load();
+      while (lateness > max_lateness && !this->_metrics->_maxLateness.compare_exchange_weak(max_lateness, lateness));
+    }
+  if (this->_policy == MissPolicy::FireAndReport && this->_lateCallback) this->_lateCallback(lateness);
+  return is_fired;
+}
+
+// -----------------------------------------------------------------------------------
+bool MissComponent::isSkipped(long long int in_when) const
+{
+  return this->_policy == MissPolicy::Skip && this->_missedWhen == in_when;
+}
+
+// -----------------------------------------------------------------------------------
+void MissComponent::rearm()
+{
+  this->_missedWhen = -1;
+}
+
 //#######################################################################################
 /*
   TimeEvent
@@ -78,6 +284,7 @@ void TimeEvent::at(std::shared_ptr<DateTime> in_date_time, std::shared_ptr<DateT
 // -----------------------------------------------------------------------------------
 bool TimeEvent::init()
 {
+  this->rearm();
 
 #if defined OPENSOURCE_PLATFORM_TIME || defined WINDOWS_PLATFORM_TIME
   if (this->_isAfter)
@@ -119,6 +326,7 @@ bool TimeEvent::happened() const
 #endif
       return true;
     }
+  else if (now > *this->_when + *this->_exceeding) return this->miss(this->_when->toMicroseconds(), now.toMicroseconds());
   else return false;
 #else 
   std::cout << "ERROR: TimeEvent::init, time not supported." << std::endl;
@@ -126,6 +334,317 @@ bool TimeEvent::happened() const
 #endif
 }
 
+// -----------------------------------------------------------------------------------
+bool TimeEvent::deadline(long long int &out_microseconds) const
+{
+  if (!this->_when) return false;
+  out_microseconds = this->_when->toMicroseconds();
+  return !this->isSkipped(out_microseconds);
+}
+
+
+//#######################################################################################
+/*
+  RecurringEvent
+*/
+
+// -----------------------------------------------------------------------------------
+RecurringEvent::RecurringEvent() : _when(-1), _exceeding(0)
+{
+}
+
+// -----------------------------------------------------------------------------------
+RecurringEvent::~RecurringEvent()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool RecurringEvent::init()
+{
+  long long int now = this->now();
+  if (now < 0) return false;
+  this->rearm();
+  this->_when = this->next(now);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+bool RecurringEvent::happened() const
+{
+  if (this->_when < 0) return false;
+  long long int now = this->now();
+  if ((this->_when <= now) && (now <= this->_when + this->_exceeding))
+    {
+#ifdef DEBUG
+      std::cout << "DEBUG: RecurringEvent::happened, now is " << now << " and when is " << this->_when << "." << std::endl;
+#endif
+      return true;
+    }
+  else if (now > this->_when + this->_exceeding)
+    {
+      if (this->miss(this->_when, now)) return true;
+      
+      // The missed time is skipped, the event waits for the next one.
+      this->_when = this->next(now);
+      return false;
+    }
+  else return false;
+}
+
+// -----------------------------------------------------------------------------------
+bool RecurringEvent::deadline(long long int &out_microseconds) const
+{
+  if (this->_when < 0) return false;
+  out_microseconds = this->_when;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void RecurringEvent::setClock(std::function<long long int()> in_clock)
+{
+  this->_clock = in_clock;
+}
+
+// -----------------------------------------------------------------------------------
+void RecurringEvent::setExceeding(std::shared_ptr<DateTime> in_exceeding)
+{
+  this->_exceeding = RecurringEvent::duration(*in_exceeding);
+}
+
+// -----------------------------------------------------------------------------------
+long long int RecurringEvent::duration(const DateTime &in_duration)
+{
+  // Durations are added to dates, as TimeEvent's "after" method does.
+  DateTime origin;
+  return (origin + in_duration).toMicroseconds() - origin.toMicroseconds();
+}
+
+// -----------------------------------------------------------------------------------
+long long int RecurringEvent::now() const
+{
+  if (this->_clock) return this->_clock();
+#if defined OPENSOURCE_PLATFORM_TIME
+  return OpenSourceTime::microseconds();
+#elif defined WINDOWS_PLATFORM_TIME
+  return WindowsTime::microseconds();
+#else
+  std::cout << "ERROR: RecurringEvent::now, time not supported." << std::endl;
+  return -1;
+#endif
+}
+
+//#######################################################################################
+/*
+  PeriodicEvent
+*/
+
+// -----------------------------------------------------------------------------------
+PeriodicEvent::PeriodicEvent() : _period(0), _origin(0), _hasOrigin(false)
+{
+}
+
+// -----------------------------------------------------------------------------------
+PeriodicEvent::~PeriodicEvent()
+{
+}
+
+// -----------------------------------------------------------------------------------
+void PeriodicEvent::every(std::shared_ptr<DateTime> in_period, std::shared_ptr<DateTime> in_exceeding)
+{
+  this->_period = RecurringEvent::duration(*in_period);
+  this->setExceeding(in_exceeding);
+}
+
+// -----------------------------------------------------------------------------------
+void PeriodicEvent::from(std::shared_ptr<DateTime> in_origin)
+{
+  this->_origin = in_origin->toMicroseconds();
+  this->_hasOrigin = true;
+}
+
+// -----------------------------------------------------------------------------------
+bool PeriodicEvent::init()
+{
+  if (!this->_hasOrigin)
+    {
+      this->_origin = this->now();
+      if (this->_origin < 0) return false;
+      this->_hasOrigin = true;
+    }
+  return this->RecurringEvent::init();
+}
+
+// -----------------------------------------------------------------------------------
+long long int PeriodicEvent::next(long long int in_microseconds) const
+{
+  if (this->_period <= 0 || !this->_hasOrigin) return -1;
+  if (in_microseconds < this->_origin) return this->_origin;
+  return this->_origin + ((in_microseconds - this->_origin) / this->_period + 1) * this->_period;
+}
+
+//#######################################################################################
+/*
+  CalendarEvent
+*/
+
+// -----------------------------------------------------------------------------------
+CalendarEvent::CalendarEvent() : _minutes(0), _hours(0), _daysOfMonth(0), _months(0), _daysOfWeek(0), _isEither(false)
+{
+}
+
+// -----------------------------------------------------------------------------------
+CalendarEvent::~CalendarEvent()
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool CalendarEvent::every(const char *in_expression, std::shared_ptr<DateTime> in_exceeding)
+{
+  this->setExceeding(in_exceeding);
+  this->_minutes = 0;
+  this->_hours = 0;
+  this->_daysOfMonth = 0;
+  this->_months = 0;
+  this->_daysOfWeek = 0;
+
+  std::vector<std::string> fields;
+  std::string expression(in_expression);
+  std::size_t position = 0;
+  while (position < expression.size())
+    {
+      std::size_t begin = expression.find_first_not_of(" \t", position);
+      if (begin == std::string::npos) break;
+      position = expression.find_first_of(" \t", begin);
+      if (position == std::string::npos) position = expression.size();
+      fields.push_back(expression.substr(begin, position - begin));
+    }
+
+  std::uint64_t minutes, hours, days_of_month, months, days_of_week;
+  if (fields.size() != 5 || !CalendarEvent::parse(fields[0], 0, 59, minutes) || !CalendarEvent::parse(fields[1], 0, 23, hours) ||
+      !CalendarEvent::parse(fields[2], 1, 31, days_of_month) || !CalendarEvent::parse(fields[3], 1, 12, months) ||
+      !CalendarEvent::parse(fields[4], 0, 7, days_of_week))
+    {
+      std::cout << "ERROR: CalendarEvent::every, expression \"" << in_expression << "\" is not valid." << std::endl;
+      return false;
+    }
+  
+  // Sunday is both 0 and 7.
+  if (days_of_week & (1ULL << 7)) days_of_week |= 1ULL;
+  this->_minutes = minutes;
+  this->_hours = hours;
+  this->_daysOfMonth = days_of_month;
+  this->_months = months;
+  this->_daysOfWeek = days_of_week;
+  this->_isEither = fields[2][0] != '*' && fields[4][0] != '*';
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+long long int CalendarEvent::next(long long int in_microseconds) const
+{
+  if (!this->_minutes || in_microseconds < 0) return -1;
+
+  // First whole minute after the time.
+  long long int minute = in_microseconds / 60000000 + 1;
+  long long int day = minute / 1440;
+  int minute_of_day = static_cast<int>(minute % 1440);
+
+  // The days are searched over 400 years, after which the calendar repeats itself.
+  long long int last_day = day + 146097;
+  while (day <= last_day)
+    {
+      int year, month, day_of_month;
+      CalendarEvent::date(day, year, month, day_of_month);
+      if (!(this->_months & (1ULL << month)))
+	{
+	  day = (month == 12) ? CalendarEvent::firstDay(year + 1, 1) : CalendarEvent::firstDay(year, month + 1);
+	  minute_of_day = 0;
+	  continue;
+	}
+
+      // 1970-01-01 was a thursday.
+      bool is_day_of_month = (this->_daysOfMonth & (1ULL << day_of_month)) != 0;
+      bool is_day_of_week = (this->_daysOfWeek & (1ULL << ((day + 4) % 7))) != 0;
+      if (this->_isEither ? (is_day_of_month || is_day_of_week) : (is_day_of_month && is_day_of_week))
+	{
+	  for (int hour = minute_of_day / 60; hour < 24; hour++)
+	    {
+	      if (!(this->_hours & (1ULL << hour))) continue;
+	      for (int minute_of_hour = (hour == minute_of_day / 60) ? minute_of_day % 60 : 0; minute_of_hour < 60; minute_of_hour++)
+		if (this->_minutes & (1ULL << minute_of_hour))
+		  return ((day * 24 + hour) * 60 + minute_of_hour) * 60000000;
+	    }
+	}
+      day++;
+      minute_of_day = 0;
+    }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------------
+bool CalendarEvent::parse(const std::string &in_field, int in_min, int in_max, std::uint64_t &out_mask)
+{
+  out_mask = 0;
+  std::size_t position = 0;
+  while (true)
+    {
+      std::size_t end = in_field.find(',', position);
+      if (end == std::string::npos) end = in_field.size();
+      std::string item = in_field.substr(position, end - position);
+
+      // Reads the numbers of the item: "*", "a" or "a-b", then "/n".
+      int first = in_min, last = in_max, step = 1;
+      std::size_t i = 0;
+      if (i < item.size() && item[i] == '*') i++;
+      else
+	{
+	  int *bound = &first;
+	  while (true)
+	    {
+	      if (i == item.size() || item[i] < '0' || item[i] > '9') return false;
+	      *bound = 0;
+	      while (i < item.size() && item[i] >= '0' && item[i] <= '9' && *bound <= in_max) *bound = *bound * 10 + (item[i++] - '0');
+	      if (bound == &last || i == item.size() || item[i] != '-') break;
+	      bound = &last;
+	      i++;
+	    }
+	  if (bound == &first) last = (i < item.size() && item[i] == '/') ? in_max : first;
+	}
+      if (i < item.size() && item[i] == '/')
+	{
+	  i++;
+	  if (i == item.size()) return false;
+	  step = 0;
+	  while (i < item.size() && item[i] >= '0' && item[i] <= '9' && step <= in_max) step = step * 10 + (item[i++] - '0');
+	}
+      if (i != item.size() || first < in_min || last > in_max || first > last || step < 1) return false;
+      for (int value = first; value <= last; value += step) out_mask |= 1ULL << value;
+
+      if (end == in_field.size()) return true;
+      position = end + 1;
+    }
+}
+
+// -----------------------------------------------------------------------------------
+void CalendarEvent::date(long long int in_day, int &out_year, int &out_month, int &out_day_of_month)
+{
+  // Civil calendar from the days counted in eras of 400 years beginning on march 1st.
+  long long int days = in_day + 719468;
+  long long int era = (days >= 0 ? days : days - 146096) / 146097;
+  long long int day_of_era = days - era * 146097;
+  long long int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  long long int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  long long int month = (5 * day_of_year + 2) / 153;
+  out_day_of_month = static_cast<int>(day_of_year - (153 * month + 2) / 5 + 1);
+  out_month = static_cast<int>(month < 10 ? month + 3 : month - 9);
+  out_year = static_cast<int>(year_of_era + era * 400 + (out_month <= 2 ? 1 : 0));
+}
+
+// -----------------------------------------------------------------------------------
+long long int CalendarEvent::firstDay(int in_year, int in_month)
+{
+  return DateTime(in_year, in_month, 1, 0, 0, 0, 0).toMicroseconds() / 86400000000LL;
+}
 
 //#######################################################################################
 /*
@@ -135,10 +654,14 @@ bool TimeEvent::happened() const
 // -----------------------------------------------------------------------------------
 Transition::Transition(const char *in_transition_name, const char *in_starting_state_name, const char *in_reachable_state_name)
 {
-  this->_transitionName = std::make_shared<std::string>(in_transition_name);
-  this->_startingStateName = std::make_shared<std::string>(in_starting_state_name);
-  this->_reachableStateName = std::make_shared<std::string>(in_reachable_state_name);
+  this->_transitionSymbol = SymbolTable::intern(in_transition_name);
+  this->_startingStateSymbol = SymbolTable::intern(in_starting_state_name);
+  this->_reachableStateSymbol = SymbolTable::intern(in_reachable_state_name);
   this->_trigger = nullptr;
+  this->_guard = nullptr;
+  this->_priority = 0;
+  this->_kind = TransitionKind::External;
+  this->_callbacksIndex = 0;
 }
 
 // -----------------------------------------------------------------------------------
@@ -147,7 +670,13 @@ Transition::~Transition() {}
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::string> Transition::name() const
 {
-  return this->_transitionName;
+  return SymbolTable::name(this->_transitionSymbol);
+}
+
+// -----------------------------------------------------------------------------------
+Symbol Transition::symbol() const
+{
+  return this->_transitionSymbol;
 }
 
 // -----------------------------------------------------------------------------------
@@ -156,14 +685,58 @@ void Transition::setTrigger(std::shared_ptr<Event> in_trigger)
   this->_trigger = in_trigger;
 }
 
+// -----------------------------------------------------------------------------------
+std::shared_ptr<Event> Transition::trigger() const
+{
+  return this->_trigger;
+}
+
+// -----------------------------------------------------------------------------------
+void Transition::setGuard(std::shared_ptr<Event> in_guard)
+{
+  this->_guard = in_guard;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<Event> Transition::guard() const
+{
+  return this->_guard;
+}
+
+// -----------------------------------------------------------------------------------
+void Transition::setPriority(int in_priority)
+{
+  this->_priority = in_priority;
+}
+
+// -----------------------------------------------------------------------------------
+int Transition::priority() const
+{
+  return this->_priority;
+}
+
+// -----------------------------------------------------------------------------------
+void Transition::setKind(TransitionKind in_kind)
+{
+  this->_kind = in_kind;
+}
+
+// -----------------------------------------------------------------------------------
+TransitionKind Transition::kind() const
+{
+  return this->_kind;
+}
+
 // -----------------------------------------------------------------------------------
 bool Transition::init()
 {
+  if (this->_guard && !this->_guard->init()) return false;
   if (!this->_trigger)
     {
 #ifdef WARNING
-      std::cout << "WARNING: Transition::init, transition \"" << *this->_transitionName << "\" doesn't have any trigger." <<
-	std::endl;
+      if (!this->_guard)
+	std::cout << "WARNING: Transition::init, transition \"" << *this->name() << "\" doesn't have any trigger." <<
+	  std::endl;
 #endif
       return true;
     }
@@ -179,7 +752,13 @@ int Transition::startingStates() const
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::string> Transition::startingState(int in_state_index) const
 {
-  return this->_startingStateName;
+  return SymbolTable::name(this->startingSymbol(in_state_index));
+}
+
+// -----------------------------------------------------------------------------------
+Symbol Transition::startingSymbol(int in_state_index) const
+{
+  return this->_startingStateSymbol;
 }
 
 // -----------------------------------------------------------------------------------
@@ -191,14 +770,30 @@ int Transition::reachableStates() const
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::string> Transition::reachableState(int in_state_index) const
 {
-  return this->_reachableStateName;
+  return SymbolTable::name(this->reachableSymbol(in_state_index));
+}
+
+// -----------------------------------------------------------------------------------
+Symbol Transition::reachableSymbol(int in_state_index) const
+{
+  return this->_reachableStateSymbol;
 }
 
 // -----------------------------------------------------------------------------------
 std::shared_ptr<std::vector<std::string> > Transition::reachableStatesNames() const
 {
 #ifdef WARNING
-  std::cout << "WARNING: Transition::reachableStatesNames, transition \"" << *this->_transitionName <<
+  std::cout << "WARNING: Transition::reachableStatesNames, transition \"" << *this->name() <<
+    "\", method is not defined." << std::endl;
+#endif
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------------
+std::shared_ptr<std::vector<Symbol> > Transition::reachableStatesSymbols() const
+{
+#ifdef WARNING
+  std::cout << "WARNING: Transition::reachableStatesSymbols, transition \"" << *this->name() <<
     "\", method is not defined." << std::endl;
 #endif
   return nullptr;
@@ -208,10 +803,37 @@ std::shared_ptr<std::vector<std::string> > Transition::reachableStatesNames() co
 void Transition::effect() const
 {
 #ifdef DEBUG
-  std::cout << "DEBUG: Transition::effect, transition \"" << *this->_transitionName << "\"." << std::endl;
+  std::cout << "DEBUG: Transition::effect, transition \"" << *this->name() << "\"." << std::endl;
 #endif
 }
 
+// -----------------------------------------------------------------------------------
+void Transition::fire() const
+{
+  this->effect();
+  if (this->_callbacks) this->_callbacks->effect(this->_callbacksIndex);
+}
+
+// -----------------------------------------------------------------------------------
+Frame *Transition::launch() const
+{
+  if (!this->_callbacks) return nullptr;
+  return this->_callbacks->launch(this->_callbacksIndex);
+}
+
+// -----------------------------------------------------------------------------------
+bool Transition::hasAsyncEffect() const
+{
+  return this->_callbacks && this->_callbacks->hasAsyncEffect(this->_callbacksIndex);
+}
+
+// -----------------------------------------------------------------------------------
+void Transition::setCallbacks(std::shared_ptr<const Callbacks> in_callbacks, std::size_t in_index)
+{
+  this->_callbacks = in_callbacks;
+  this->_callbacksIndex = in_index;
+}
+
 // -----------------------------------------------------------------------------------
 bool Transition::isTriggered() const
 {
@@ -224,13 +846,14 @@ bool Transition::isActivated() const
 {
   if (!this->_trigger)
     {
+      if (this->_guard) return this->_guard->happened();
 #ifdef WARNING
-      std::cout << "WARNING: Transition::isActivated, transition \"" << *this->_transitionName <<
+      std::cout << "WARNING: Transition::isActivated, transition \"" << *this->name() <<
 	"\" doesn't have any trigger." << std::endl;
 #endif
       return true;
     }
-  else if (this->_trigger->happened()) return true;
+  else if (this->_trigger->happened()) return !this->_guard || this->_guard->happened();
   else return false;
 }
 
@@ -241,7 +864,7 @@ bool Transition::isActivated() const
    
 JoinIncoming::JoinIncoming(const char *in_starting_state_name)
 {
-  this->_startingStateName = std::make_shared<std::string>(in_starting_state_name);
+  this->_startingStateSymbol = SymbolTable::intern(in_starting_state_name);
 }
     
 JoinIncoming::~JoinIncoming()
@@ -250,7 +873,12 @@ JoinIncoming::~JoinIncoming()
 
 std::shared_ptr<std::string> JoinIncoming::startingState()
 {
-  return this->_startingStateName;
+  return SymbolTable::name(this->_startingStateSymbol);
+}
+
+Symbol JoinIncoming::startingSymbol() const
+{
+  return this->_startingStateSymbol;
 }
     
 void JoinIncoming::effect()
@@ -291,16 +919,26 @@ std::shared_ptr<std::vector<std::string> > Join::startingStatesNames() const
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<std::string> Join::startingState(int in_state_index) const
+std::shared_ptr<std::vector<Symbol> > Join::startingStatesSymbols() const
+{
+  auto starting_states_symbols = std::make_shared<std::vector<Symbol> >();
+  for (auto it = this->_incomingTransitions.begin(); it != this->_incomingTransitions.end(); it++)
+    starting_states_symbols->push_back((*it)->startingSymbol());
+  
+  return starting_states_symbols;
+}
+
+// -----------------------------------------------------------------------------------
+Symbol Join::startingSymbol(int in_state_index) const
 {
-  return this->_incomingTransitions[in_state_index]->startingState();
+  return this->_incomingTransitions[in_state_index]->startingSymbol();
 }
 
 // -----------------------------------------------------------------------------------
 void Join::effect() const
 {
 #ifdef DEBUG
-  std::cout << "DEBUG: Join::effect, join transition \"" << *this->_transitionName << "\"." << std::endl;
+  std::cout << "DEBUG: Join::effect, join transition \"" << *this->name() << "\"." << std::endl;
 #endif
   
   for (auto it = this->_incomingTransitions.begin(); it != this->_incomingTransitions.end(); it++)
@@ -314,7 +952,7 @@ void Join::effect() const
    
 ForkOutgoing::ForkOutgoing(const char *in_reachable_state_name)
 {
-  this->_reachableStateName = std::make_shared<std::string>(in_reachable_state_name);
+  this->_reachableStateSymbol = SymbolTable::intern(in_reachable_state_name);
 }
     
 ForkOutgoing::~ForkOutgoing()
@@ -323,7 +961,12 @@ ForkOutgoing::~ForkOutgoing()
 
 std::shared_ptr<std::string> ForkOutgoing::reachableState()
 {
-  return this->_reachableStateName;
+  return SymbolTable::name(this->_reachableStateSymbol);
+}
+
+Symbol ForkOutgoing::reachableSymbol() const
+{
+  return this->_reachableStateSymbol;
 }
     
 void ForkOutgoing::effect()
@@ -364,20 +1007,56 @@ std::shared_ptr<std::vector<std::string> > Fork::reachableStatesNames() const
 }
 
 // -----------------------------------------------------------------------------------
-std::shared_ptr<std::string> Fork::reachableState(int in_state_index) const
+std::shared_ptr<std::vector<Symbol> > Fork::reachableStatesSymbols() const
 {
-  return this->_outgoingTransitions[in_state_index]->reachableState();
+  auto reachable_states_symbols = std::make_shared<std::vector<Symbol> >();
+  for (auto it = this->_outgoingTransitions.begin(); it != this->_outgoingTransitions.end(); it++)
+    reachable_states_symbols->push_back((*it)->reachableSymbol());
+  
+  return reachable_states_symbols;
+}
+
+// -----------------------------------------------------------------------------------
+Symbol Fork::reachableSymbol(int in_state_index) const
+{
+  return this->_outgoingTransitions[in_state_index]->reachableSymbol();
 }
 
 // -----------------------------------------------------------------------------------
 void Fork::effect() const
 {
 #ifdef DEBUG
-  std::cout << "DEBUG: Fork::effect, fork transition \"" << *this->_transitionName << "\"." << std::endl;
+  std::cout << "DEBUG: Fork::effect, fork transition \"" << *this->name() << "\"." << std::endl;
 #endif
   
   for (auto it = this->_outgoingTransitions.begin(); it != this->_outgoingTransitions.end(); it++)
     (*it)->effect();
 }
 
+//#########################################################################################################
+/*
+  CompoundTransition
+*/
+
+// -----------------------------------------------------------------------------------
+CompoundTransition::CompoundTransition(std::shared_ptr<Transition> in_first, std::shared_ptr<Transition> in_second,
+				       std::shared_ptr<Event> in_guard) :
+  Transition((*in_first->name() + "/" + *in_second->name()).c_str(), in_first->startingState(0)->c_str(),
+	     in_second->reachableState(0)->c_str()),
+  _first(in_first), _second(in_second)
+{
+  this->_trigger = in_first->trigger();
+  this->_guard = in_guard;
+  this->_priority = in_first->priority();
+}
 
+// -----------------------------------------------------------------------------------
+void CompoundTransition::effect() const
+{
+#ifdef DEBUG
+  std::cout << "DEBUG: CompoundTransition::effect, compound transition \"" << *this->name() << "\"." << std::endl;
+#endif
+  
+  this->_first->fire();
+  this->_second->fire();
+}
@@ -31,16 +31,72 @@
 #define TRANSITIONS_HPP
 
 #include "datetime.hpp"
+#include "symbols.hpp"
+#include "variables.hpp"
+#include "callbacks.hpp"
 
+#include <atomic>
+#include <cstdint> // uint64_t
+#include <functional>
 #include <vector>
 #include <map>
 #include <string>
+#include <type_traits>
 #include <memory>
 
 #include <iostream>
 
 namespace fisa
 { 
+  //! Identifier of a signal type.
+  typedef const void *SignalId;
+
+  //! Gives a unique SignalId to each payload type.
+  template<typename P>
+  struct SignalType : public TypeTag<P> {};
+
+  //#######################################################################################
+  /*  
+      Signal
+  */
+  //! Base class of the messages sent to a machine and dispatched to SignalEvent triggers.
+  
+  class Signal
+  {
+  public:
+    //! Construct a signal of the type specified in argument.
+    Signal(SignalId in_id) : _id(in_id) {}
+
+    //! \private
+    virtual ~Signal() {}
+
+    //! Returns the type of the signal.
+    SignalId id() const {return this->_id;}
+
+  private:
+    SignalId _id;
+  };
+
+  //#######################################################################################
+  /*  
+      PayloadSignal
+  */
+  //! A signal carrying a payload of type P.
+  
+  template<typename P>
+  class PayloadSignal : public Signal
+  {
+  public:
+    //! Construct a signal carrying the payload specified in argument.
+    PayloadSignal(const P &in_payload) : Signal(SignalType<P>::id()), _payload(in_payload) {}
+
+    //! Returns the payload.
+    const P &payload() const {return this->_payload;}
+
+  private:
+    P _payload;
+  };
+  
   //#######################################################################################
   /*  
       Event
@@ -65,6 +121,48 @@ namespace fisa
      * An event class that trigger a transition must implement this method.
      **/
     virtual bool happened() const = 0;
+
+    //! Returns the type of the signals the event listens for.
+    /** A null pointer is returned by events that are not triggered by signals. **/
+    virtual SignalId signal() const;
+
+    //! Offers a signal to the event, returns true if the event consumes it.
+    /** Only called with signals of the type returned by the "signal" method. **/
+    virtual bool consume(std::shared_ptr<const Signal> in_signal);
+
+    //! Registers a listener to notify when the triggering conditions of the event may have changed.
+    /** 
+     * Returns false if the event doesn't notify its changes, in which case the event is 
+     * polled each time the machine runs. 
+     **/
+    virtual bool listen(std::shared_ptr<EventListener> in_listener);
+
+    //! Returns true if the event is the completion of the state the transition starts from.
+    virtual bool isCompletion() const;
+
+    //! Retrieves the time at which the event triggers, in microseconds since 1970 (see DateTime's "toMicroseconds" method).
+    /** Returns false if the event isn't triggered at a time. **/
+    virtual bool deadline(long long int &out_microseconds) const;
+  };
+
+  //#######################################################################################
+  /*  
+      EventForwarder
+  */
+  //! Forwards the changes of a machine's variable to the listener of an event bound to the variable.
+  
+  class EventForwarder : public EventListener
+  {
+  public:
+    //! Construct a forwarder to the listener of the event specified in argument.
+    EventForwarder(std::weak_ptr<EventListener> in_listener, const Event *in_event);
+
+    //! Specializes EventListener's "changed" method.
+    void changed(const Event *in_event);
+
+  private:
+    std::weak_ptr<EventListener> _listener;
+    const Event *_event;
   };
   
   
@@ -75,6 +173,10 @@ namespace fisa
   //! Class to implement a transition triggering by changes of attribute values.
   /**
    * The class should be inherited and the "happened" method overloaded to implement the triggering conditions.
+   * The attributes are declared with "add", read with "value" and changed with "switching", or 
+   * with "change" by the subclasses, so that the states waiting for the event are notified. 
+   * An event whose conditions also depend on anything else (eg: globals, clocks, other objects) 
+   * must overload the "isPolled" method to be checked each time the machine runs.
    **/
 
   template<typename T>
@@ -91,10 +193,18 @@ namespace fisa
     bool switching(const char *in_attribute_name, const T in_attribute_value)
     {
       std::string attribute_name(in_attribute_name);
+      auto binding = this->_bindings.find(attribute_name);
+      if (binding != this->_bindings.end())
+	{
+	  // Listeners are notified by the variable.
+	  ChangeEvent::store(binding->second, in_attribute_value, IsBindable());
+	  return true;
+	}
       auto it = this->_attributes.find(attribute_name);
       if (it != this->_attributes.end())
 	{
 	  (*it).second = in_attribute_value;
+	  this->notify();
 	  return true;
 	}
       else
@@ -109,19 +219,92 @@ namespace fisa
     bool init() {return true;}
     
     //! Specializes Event's "happened" method.
+    /** 
+     * Unless the "isPolled" method returns true, the triggering conditions must only depend on 
+     * the event's attributes: the event is checked again only after one of them has been switched. 
+     **/
     virtual bool happened() const = 0;
 
+    //! Returns true if the event is checked each time the machine runs, false (the default) if only after a switching.
+    virtual bool isPolled() const {return false;}
+
+    //! Specializes Event's "listen" method.
+    /** Returns false, so that the event is polled, if the "isPolled" method returns true. **/
+    bool listen(std::shared_ptr<EventListener> in_listener)
+    {
+      if (this->isPolled()) return false;
+      this->_listeners.push_back(in_listener);
+      for (auto it = this->_bindings.begin(); it != this->_bindings.end(); it++)
+	this->forward(in_listener, it->second);
+      return true;
+    }
+
+    //! Binds the attribute with name specified in first argument to a machine's variable.
+    /**
+     * The attribute is then read from, and switched into, the variable, and the event is 
+     * checked again whenever the variable changes. Many events can be bound to the same variable.
+     * Only attributes of a trivially copyable type can be bound. See Machine's "declare" method.
+     **/
+    void bind(const char *in_attribute_name, const Variable<T> &in_variable)
+    {
+      static_assert(IsBindable::value, "Only trivially copyable attributes can be bound to variables.");
+      std::string attribute_name(in_attribute_name);
+      this->_attributes.erase(attribute_name);
+      this->_bindings[attribute_name] = in_variable;
+      for (auto it = this->_listeners.begin(); it != this->_listeners.end(); it++)
+	{
+	  auto listener = it->lock();
+	  if (listener) this->forward(listener, in_variable);
+	}
+    }
+
   protected:
+    //! Registers a forwarder from the variable specified in argument to the listener.
+    void forward(std::shared_ptr<EventListener> in_listener, const Variable<T> &in_variable)
+    {
+      auto forwarder = std::make_shared<EventForwarder>(in_listener, this);
+      in_variable.variables()->listen(in_variable.index(), forwarder);
+      this->_forwarders.push_back(forwarder);
+    }
+    
+    //! Notifies the listeners that an attribute has been switched.
+    void notify()
+    {
+      auto it = this->_listeners.begin();
+      while (it != this->_listeners.end())
+	{
+	  auto listener = it->lock();
+	  if (!listener) it = this->_listeners.erase(it);
+	  else
+	    {
+	      listener->changed(this);
+	      it++;
+	    }
+	}
+    }
+
     //! Adding an attribute with name specified in argument and his initial value.
     void add(const char *in_attribute_name, const T in_initial_value)
     {  
       this->_attributes[std::string(in_attribute_name)] = in_initial_value;
     }
     
+    //! Returns the attributes that aren't bound to a variable, {name, value}.
+    const std::map<std::string, T>& attributes() const {return this->_attributes;}
+
+    //! Calls the function specified in argument to change the attributes that aren't bound to a variable, then notifies the listeners.
+    void change(const std::function<void(std::map<std::string, T>&)> &in_change)
+    {
+      in_change(this->_attributes);
+      this->notify();
+    }
+
     //! Returns the attribute value.
     T value(const char *in_attribute_name) const
     {
       std::string attribute_name(in_attribute_name);
+      auto binding = this->_bindings.find(attribute_name);
+      if (binding != this->_bindings.end()) return ChangeEvent::load(binding->second, IsBindable());
       auto it = this->_attributes.find(attribute_name);
       if (it == this->_attributes.end())
 	{
@@ -133,7 +316,209 @@ namespace fisa
       return (*it).second;
     }
 
+  private:
+    // Attributes of other types are never bound, their variables are neither read nor switched.
+    typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> IsBindable;
+
+    static void store(const Variable<T> &in_variable, const T &in_value, std::true_type) {in_variable.set(in_value);}
+    static void store(const Variable<T> &in_variable, const T &in_value, std::false_type) {}
+    static T load(const Variable<T> &in_variable, std::true_type) {return in_variable.get();}
+    static T load(const Variable<T> &in_variable, std::false_type) {return T();}
+
+    // Kept private so that the attributes are only changed through "switching" or "change", which notify
+    // the listeners: a subclass cannot change them behind the states that wait for the event.
     std::map<std::string, T> _attributes; // {name, value}
+    std::vector<std::weak_ptr<EventListener> > _listeners;
+    std::map<std::string, Variable<T> > _bindings; // {name, variable}
+    std::vector<std::shared_ptr<EventForwarder> > _forwarders;
+  };
+
+  //#######################################################################################
+  /*
+    CompletionEvent
+  */
+  //! Class to implement a completion transition, triggered when the state it starts from is completed.
+  /**
+   * A CompositeState is completed when all its regions have reached a FinalState, and a 
+   * SimpleState as soon as it has been reached. Completion transitions are fired in the same 
+   * run as the completion, even if a transition has been fired inside the composite state, 
+   * and before the other transitions of the state. While the state stays completed, they 
+   * remain activated (eg: until their guard is true).
+   **/
+
+  class CompletionEvent : public Event
+  {
+  public:
+    //! Constructor.
+    CompletionEvent();
+
+    //! Destructor.
+    ~CompletionEvent();
+
+    //! Specializes Event's "init" method.
+    bool init();
+
+    //! Specializes Event's "happened" method. Completion events are checked by the state and never polled.
+    bool happened() const;
+
+    //! Specializes Event's "isCompletion" method.
+    bool isCompletion() const;
+  };
+
+  //#######################################################################################
+  /*
+    CompoundGuard
+  */
+  //! Guard of a compound transition, true when all its required events have happened and none of its excluded ones.
+  /**
+   * The events are checked in order and the checking stops at the first one that decides the result. 
+   * Compound guards are built by the machine when junction pseudostates are flattened, the excluded 
+   * events being the guards of the branches that precede an "else" branch.
+   **/
+
+  class CompoundGuard : public Event
+  {
+  public:
+    //! Constructor.
+    CompoundGuard(const std::vector<std::shared_ptr<Event> > &in_required, const std::vector<std::shared_ptr<Event> > &in_excluded);
+
+    //! Destructor.
+    ~CompoundGuard();
+
+    //! Specializes Event's "init" method.
+    bool init();
+
+    //! Specializes Event's "happened" method.
+    bool happened() const;
+
+    //! Specializes Event's "listen" method, the changes of each event are forwarded as changes of the guard.
+    bool listen(std::shared_ptr<EventListener> in_listener);
+
+  private:
+    std::vector<std::shared_ptr<Event> > _required;
+    std::vector<std::shared_ptr<Event> > _excluded;
+    std::vector<std::shared_ptr<EventForwarder> > _forwarders;
+  };
+
+  //#######################################################################################
+  /*
+    SignalEvent
+  */
+  //! Class to implement a transition triggering by the reception of a signal with a payload of type P.
+  /**
+   * Signals are sent to the machine with the Machine's "send" method. Each signal is dispatched,  
+   * in a run of the machine, to the transitions listening for its type from the active states, 
+   * and it is consumed by the first one whose "accept" method returns true. 
+   * The "accept" method can be overloaded to implement a guard on the payload.
+   **/
+
+  template<typename P>
+  class SignalEvent : public Event
+  {
+  public:
+    //! Constructor.
+    SignalEvent() {}
+
+    //! Destructor.
+    virtual ~SignalEvent() {}
+
+    //! Specializes Event's "init" method.
+    bool init() {return true;}
+
+    //! Specializes Event's "happened" method. Signal events are dispatched and never polled.
+    bool happened() const {return false;}
+
+    //! Specializes Event's "signal" method.
+    SignalId signal() const {return SignalType<P>::id();}
+
+    //! Specializes Event's "consume" method.
+    bool consume(std::shared_ptr<const Signal> in_signal)
+    {
+      auto signal = std::static_pointer_cast<const PayloadSignal<P> >(in_signal);
+      if (!this->accept(signal->payload())) return false;
+      this->_signal = signal;
+      return true;
+    }
+
+    //! Overloadable guard on the payload of the signal.
+    virtual bool accept(const P &in_payload) const {return true;}
+
+    //! Returns the payload of the last consumed signal.
+    /** Should be called from the "effect" method of the triggered transition. **/
+    const P &payload() const {return this->_signal->payload();}
+
+  private:
+    std::shared_ptr<const PayloadSignal<P> > _signal;
+  };
+
+  //! What a time event does when it is checked after its exceeding interval.
+  enum class MissPolicy
+  {
+    Skip,         // The event isn't triggered: a TimeEvent won't trigger anymore, a RecurringEvent waits for its next time.
+    FireLate,     // The event is triggered late.
+    FireAndReport // The event is triggered late, and its lateness is given to the callback set with "onLate".
+  };
+
+  //! Counters of the deadlines missed by the time events they are set to, which may belong to machines run from different threads.
+  typedef struct TimeMetrics
+  {
+    TimeMetrics() : _missed(0), _firedLate(0), _skipped(0), _maxLateness(0) {}
+    
+    std::atomic<unsigned long long int> _missed; // Deadlines whose exceeding interval had passed when their event was checked.
+    std::atomic<unsigned long long int> _firedLate;
+    std::atomic<unsigned long long int> _skipped;
+    std::atomic<long long int> _maxLateness; // Greatest delay in microseconds between a missed deadline and its check.
+  } TimeMetrics;
+
+  //! Callback given the lateness in microseconds, from its deadline, of a time event triggered after its exceeding interval.
+  typedef std::function<void(long long int)> LateCallback;
+
+  //#######################################################################################
+  /*
+    MissComponent
+  */
+  //! Handling of the deadlines missed by a time event, when the machine isn't run within the exceeding interval.
+
+  class MissComponent
+  {
+  public:
+    //! Constructor.
+    MissComponent();
+
+    //! Destructor.
+    virtual ~MissComponent();
+
+    //! Sets what the event does when it is checked after its exceeding interval. MissPolicy::Skip is the default.
+    void setMissPolicy(MissPolicy in_policy);
+
+    //! Returns what the event does when it is checked after its exceeding interval.
+    MissPolicy missPolicy() const;
+
+    //! Sets the counters the misses of the event are added to.
+    void setMetrics(std::shared_ptr<TimeMetrics> in_metrics);
+
+    //! Returns the counters the misses of the event are added to, a null pointer if none has been set.
+    std::shared_ptr<TimeMetrics> metrics() const;
+
+    //! Sets the callback given the lateness of the event with the MissPolicy::FireAndReport policy.
+    void onLate(LateCallback in_callback);
+
+  protected:
+    //! Applies the policy to the deadline "in_when" found missed at "in_now", returns true if the event is triggered.
+    /** A deadline is counted and reported once, however many times it is checked. **/
+    bool miss(long long int in_when, long long int in_now) const;
+
+    //! Returns true if the deadline specified in argument has been missed and skipped.
+    bool isSkipped(long long int in_when) const;
+
+    //! Forgets the missed deadline, to be called when the event is initialized.
+    void rearm();
+
+  private:
+    MissPolicy _policy;
+    std::shared_ptr<TimeMetrics> _metrics;
+    LateCallback _lateCallback;
+    mutable long long int _missedWhen; // Last deadline found missed, -1 if there is none.
   };
 
   //#######################################################################################
@@ -143,9 +528,11 @@ namespace fisa
   //! Class to implement a transition triggering by the passing of a time duration or the reaching of an absolute time.
   /**
    * Supported on Open-source and Windows platforms
+   * When the machine is run after the exceeding interval, the miss policy tells whether the 
+   * event is triggered (see MissComponent).
    **/
 
-  class TimeEvent : public Event
+  class TimeEvent : public Event, public MissComponent
   {
   public:
     //! Constructor.
@@ -173,6 +560,9 @@ namespace fisa
 
     //! Specializes Event's "happened" method.
     bool happened() const;
+
+    //! Specializes Event's "deadline" method, the time is known once the event has been initialized.
+    bool deadline(long long int &out_microseconds) const;
     
   private:
     std::shared_ptr<DateTime> _dateTime;
@@ -181,6 +571,158 @@ namespace fisa
     bool _isAfter;
   };
 
+  //#########################################################################################################
+  /*
+    RecurringEvent
+  */
+  //! Base class of the time events that trigger repeatedly, at the times given by the "next" method.
+  /**
+   * Each time the event is initialized, that is each time the starting state of its transition 
+   * is reached, the event waits for the first of its times after the current time. A transition 
+   * from a state to itself is thus fired at each of the times, which don't depend on the delay 
+   * taken to fire the previous one: they don't drift.
+   * The event is triggered within the "exceeding" interval following the time. After it, the 
+   * miss policy tells whether the event is triggered late or waits for its next time (see 
+   * MissComponent).
+   **/
+
+  class RecurringEvent : public Event, public MissComponent
+  {
+  public:
+    //! Constructor.
+    RecurringEvent();
+
+    //! Destructor.
+    virtual ~RecurringEvent();
+
+    //! Returns the first time strictly after the time specified in argument at which the event triggers, -1 if there is none.
+    /** Times are in microseconds since 1970 (see DateTime's "toMicroseconds" method). **/
+    virtual long long int next(long long int in_microseconds) const = 0;
+
+    //! Specializes Event's "init" method.
+    bool init();
+
+    //! Specializes Event's "happened" method.
+    bool happened() const;
+
+    //! Specializes Event's "deadline" method, the time is known once the event has been initialized.
+    bool deadline(long long int &out_microseconds) const;
+
+    //! Replaces the platform time by the clock specified in argument, which returns microseconds since 1970.
+    /** Lets the event be driven by a simulated time, eg: with the same clock as a Scheduler. **/
+    void setClock(std::function<long long int()> in_clock);
+
+  protected:
+    //! Sets the interval within which the event is considered as triggered.
+    void setExceeding(std::shared_ptr<DateTime> in_exceeding);
+
+    //! Returns the number of microseconds of a duration given as to TimeEvent's "after" method.
+    static long long int duration(const DateTime &in_duration);
+
+    //! Returns the current time in microseconds since 1970, -1 if the time isn't supported.
+    long long int now() const;
+
+  private:
+    mutable long long int _when; // -1 if the event hasn't been initialized or has no time left.
+    long long int _exceeding;
+    std::function<long long int()> _clock; // The platform time is used when empty.
+  };
+
+  //#########################################################################################################
+  /*
+    PeriodicEvent
+  */
+  //! Time event that triggers at regular intervals.
+  /**
+   * The event triggers at the times origin + k * period. The origin is the time set with 
+   * the "from" method, or the first time the event is initialized.
+   **/
+
+  class PeriodicEvent : public RecurringEvent
+  {
+  public:
+    //! Constructor.
+    PeriodicEvent();
+
+    //! Destructor.
+    ~PeriodicEvent();
+
+    //! Sets the period, given as to TimeEvent's "after" method, and the interval within which the event is considered as triggered.
+    void every(std::shared_ptr<DateTime> in_period, std::shared_ptr<DateTime> in_exceeding);
+
+    //! Sets the absolute time from which the periods are counted.
+    void from(std::shared_ptr<DateTime> in_origin);
+
+    //! Specializes RecurringEvent's "init" method, the origin is set on the first call if it hasn't been.
+    bool init();
+
+    //! Specializes RecurringEvent's "next" method.
+    long long int next(long long int in_microseconds) const;
+
+  private:
+    long long int _period;
+    long long int _origin;
+    bool _hasOrigin;
+  };
+
+  //#########################################################################################################
+  /*
+    CalendarEvent
+  */
+  //! Time event that triggers at the minutes matching a cron expression.
+  /**
+   * The expression has five fields separated by spaces: minute (0-59), hour (0-23), day of 
+   * month (1-31), month (1-12) and day of week (0-7, 0 and 7 being sunday). A field is a list 
+   * separated by commas of "*", values "a", or ranges "a-b", each one optionally followed by 
+   * a slash and a step "n" matching one value out of n (eg: "0,30 8-18 * * 1-5", every half 
+   * hour from 8:00 to 18:30 on week days).
+   * As with cron, when both days of month and days of week are restricted (they don't begin 
+   * with "*"), a day matching either of them is matched.
+   * Times are in UTC, as the times returned by OpenSourceTime's and WindowsTime's "now" methods.
+   **/
+
+  class CalendarEvent : public RecurringEvent
+  {
+  public:
+    //! Constructor.
+    CalendarEvent();
+
+    //! Destructor.
+    ~CalendarEvent();
+
+    //! Sets the cron expression and the interval within which the event is considered as triggered.
+    /** Returns false if the expression is not valid, the event then never triggers. **/
+    bool every(const char *in_expression, std::shared_ptr<DateTime> in_exceeding);
+
+    //! Specializes RecurringEvent's "next" method.
+    long long int next(long long int in_microseconds) const;
+
+  private:
+    //! Sets in "out_mask" the bits of the values matched by the field specified in argument.
+    static bool parse(const std::string &in_field, int in_min, int in_max, std::uint64_t &out_mask);
+
+    //! Retrieves the date of the day specified in argument, counted from 1970-01-01.
+    static void date(long long int in_day, int &out_year, int &out_month, int &out_day_of_month);
+
+    //! Returns the day, counted from 1970-01-01, of the first day of the month specified in argument.
+    static long long int firstDay(int in_year, int in_month);
+
+    std::uint64_t _minutes; // Bit i is set if minute i is matched.
+    std::uint64_t _hours;
+    std::uint64_t _daysOfMonth;
+    std::uint64_t _months;
+    std::uint64_t _daysOfWeek;
+    bool _isEither; // Both days of month and days of week are restricted.
+  };
+
+  //! Kinds of transitions, telling which states are left and reached when a transition is fired.
+  enum class TransitionKind
+  {
+    External, // The starting state is left and the reachable state is reached, even if they are the same.
+    Internal, // Only the effect is called, the starting state, which must be the reachable state, is not left.
+    Local     // From a composite state to a state of one of its regions, the composite state is not left.
+  };
+
   //#########################################################################################################
   /*
     Transition
@@ -213,10 +755,54 @@ namespace fisa
     //! Retrurns the name of the transition.
     std::shared_ptr<std::string> name() const;
 
+    //! Returns the interned name of the transition.
+    Symbol symbol() const;
+
     //! Sets the transition's triggering Event.
+    /** The trigger must be set before the transition is added to the machine. **/
     void setTrigger(const std::shared_ptr<Event> in_trigger);
 
-    //! Initializes the trigger.
+    //! Returns the transition's triggering Event.
+    std::shared_ptr<Event> trigger() const;
+
+    //! Sets the transition's guard, an Event whose "happened" method must be true for the transition to be activated.
+    /** 
+     * The guard is checked once the trigger has happened; a transition without trigger is only 
+     * activated by its guard. The guard must be set before the transition is added to the machine.
+     * See also GuardEvent.
+     **/
+    void setGuard(const std::shared_ptr<Event> in_guard);
+
+    //! Returns the transition's guard.
+    std::shared_ptr<Event> guard() const;
+
+    //! Sets the priority of the transition, 0 by default.
+    /**
+     * When several transitions starting from a state are activated at once, the one with the highest 
+     * priority is fired, and between transitions of equal priority the first added. Priorities are 
+     * ignored when the machine's conflict policy is ConflictPolicy::FirstWins. 
+     * The priority must be set before the machine's first run.
+     **/
+    void setPriority(int in_priority);
+
+    //! Returns the priority of the transition.
+    int priority() const;
+
+    //! Sets the kind of the transition, TransitionKind::External by default.
+    /**
+     * An internal transition only calls its "effect" method: the state is neither exited nor 
+     * entered, and only the trigger and guard of the transition are initialized again. 
+     * A local transition starts from a composite state and reaches a state of one of its 
+     * regions: only the active state of that region is exited. A local transition starting 
+     * from a SimpleState is fired as an external one.
+     * The kind must be set before the transition is added to the machine.
+     **/
+    void setKind(TransitionKind in_kind);
+
+    //! Returns the kind of the transition.
+    TransitionKind kind() const;
+
+    //! Initializes the trigger and the guard.
     bool init();
 
     //! Returns the number of states that start from the transition.
@@ -231,6 +817,12 @@ namespace fisa
      **/
     virtual std::shared_ptr<std::string> startingState(int in_state_index) const;
 
+    //! Returns the interned name of the starting state at the index specified in input argument.
+    /** 
+     * This method is specialized by composite transitions with multiple starting states.
+     **/
+    virtual Symbol startingSymbol(int in_state_index) const;
+
     //! Returns the number of states that are reachable by the transition.
     /**
      * The method is specialized by composite transitions with multiple reachable states.
@@ -243,25 +835,52 @@ namespace fisa
      **/
     virtual std::shared_ptr<std::string> reachableState(int in_state_index) const;
 
+    //! Returns the interned name of the reachable state at the index specified in input argument.
+    /**
+     * The method is specialized by composite transitions with multiple reachable states.
+     **/
+    virtual Symbol reachableSymbol(int in_state_index) const;
+
     //! Returns the names of the reachable states.
     virtual std::shared_ptr<std::vector<std::string> > reachableStatesNames() const;
 
+    //! Returns the interned names of the reachable states.
+    virtual std::shared_ptr<std::vector<Symbol> > reachableStatesSymbols() const;
+
     //! Overloadable method which is called when the transition is activated and the machine changes of state.
     virtual void effect() const;
+
+    //! Called when the transition is fired: calls the "effect" method, then the callback set by Machine's "onEffect" method.
+    void fire() const;
+
+    //! Launches the asynchronous effect set by Machine's "onAsyncEffect" method, after "fire".
+    /** Returns the frame on which the effect resumes, a null pointer if the transition doesn't have an asynchronous effect. **/
+    Frame *launch() const;
+
+    //! Returns true if an asynchronous effect has been set with Machine's "onAsyncEffect" method.
+    bool hasAsyncEffect() const;
+
+    //! Sets the callback tables of the machine the transition has been added to, and the index of the transition in them.
+    void setCallbacks(std::shared_ptr<const Callbacks> in_callbacks, std::size_t in_index);
     
     //! Asks if a triggering Event has been defined.
     bool isTriggered() const;
 
-    //! Asks if the transition's Event has been triggered.
+    //! Asks if the transition's Event has been triggered and its guard is true.
     bool isActivated() const;
 
   protected:
-    std::shared_ptr<std::string> _transitionName;
+    Symbol _transitionSymbol;
     std::shared_ptr<Event> _trigger;
+    std::shared_ptr<Event> _guard;
+    int _priority;
 
   private:    
-    std::shared_ptr<std::string> _startingStateName;
-    std::shared_ptr<std::string> _reachableStateName;
+    Symbol _startingStateSymbol;
+    Symbol _reachableStateSymbol;
+    TransitionKind _kind;
+    std::shared_ptr<const Callbacks> _callbacks;
+    std::size_t _callbacksIndex; // Index of the transition in the callback tables.
   };
 
   //#########################################################################################################
@@ -286,11 +905,14 @@ namespace fisa
     //! Returns the name of the state starting from the incoming path.
     std::shared_ptr<std::string> startingState();
 
+    //! Returns the interned name of the state starting from the incoming path.
+    Symbol startingSymbol() const;
+
     //! Overloadable method executed the the join composite transition that own the incoming is activated and the machine changes of state.
     virtual void effect();
     
   private:
-    std::shared_ptr<std::string> _startingStateName;
+    Symbol _startingStateSymbol;
   };
   
   
@@ -321,18 +943,20 @@ namespace fisa
     //! Specializes Transition's "startingStates" method.
      int startingStates() const;
 
-    //! Specializes Transition's "startingStatesNames" method.
+    //! Returns the names of the starting states.
     std::shared_ptr<std::vector<std::string> > startingStatesNames() const;
 
-    //! Specializes Transition's "startingState" method.
-    std::shared_ptr<std::string> startingState(int in_state_index) const;
+    //! Returns the interned names of the starting states.
+    std::shared_ptr<std::vector<Symbol> > startingStatesSymbols() const;
+
+    //! Specializes Transition's "startingSymbol" method.
+    Symbol startingSymbol(int in_state_index) const;
 
     //! Calls each "effect" method of incoming paths.
     void effect() const;
 
   private:
     std::vector<std::shared_ptr<JoinIncoming> > _incomingTransitions;
-    std::shared_ptr<std::string> _reachableStateName;
   };
 
   //#########################################################################################################
@@ -357,6 +981,9 @@ namespace fisa
     //! Returns the name of the reachable state by the outgoind path.
     std::shared_ptr<std::string> reachableState();
 
+    //! Returns the interned name of the reachable state by the outgoing path.
+    Symbol reachableSymbol() const;
+
     //! Executed when the fork transition is fired.
     /** This method should be overloaded. **/
 
@@ -364,7 +991,7 @@ namespace fisa
     virtual void effect();
     
   private:
-    std::shared_ptr<std::string> _reachableStateName;
+    Symbol _reachableStateSymbol;
   };
   
   //#########################################################################################################
@@ -396,17 +1023,50 @@ namespace fisa
 
     //! Specializes Transition's "reachableStatesNames" method.
     std::shared_ptr<std::vector<std::string> > reachableStatesNames() const;
+
+    //! Specializes Transition's "reachableStatesSymbols" method.
+    std::shared_ptr<std::vector<Symbol> > reachableStatesSymbols() const;
     
-    //! Specializes Transition's "reachableState" method.
-    std::shared_ptr<std::string> reachableState(int in_state_index) const;
+    //! Specializes Transition's "reachableSymbol" method.
+    Symbol reachableSymbol(int in_state_index) const;
 
     //! Calls each method "effect" of outgoing paths.
     void effect() const;
 
   private:
     std::vector<std::shared_ptr<ForkOutgoing> > _outgoingTransitions;
-    std::shared_ptr<std::string> _startingStateName;
-  };  
+  };
+
+  //#########################################################################################################
+  /*
+    CompoundTransition    
+  */
+  //! Transition resulting from the chaining of a transition with a branch of a junction pseudostate.
+  /**
+   * Compound transitions are built by the machine when it is initialized, a transition reaching a 
+   * JunctionState being replaced by a compound transition for each branch of the junction. The compound 
+   * transition keeps the trigger and the priority of the first transition, and its guard is checked 
+   * before the starting state is exited. When fired, the effects of the chained transitions are called in order.
+   **/
+
+  class CompoundTransition : public Transition
+  {
+  public:
+    //! Constructor.
+    /**
+     * First argument: the transition reaching the junction.
+     * Second argument: the branch of the junction.
+     * Third argument: the guard of the compound transition.
+     **/
+    CompoundTransition(std::shared_ptr<Transition> in_first, std::shared_ptr<Transition> in_second, std::shared_ptr<Event> in_guard);
+
+    //! Calls the "effect" method of the chained transitions.
+    void effect() const;
+
+  private:
+    std::shared_ptr<Transition> _first;
+    std::shared_ptr<Transition> _second;
+  };
 }
 
 #endif
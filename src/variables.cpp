@@ -0,0 +1,114 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include "variables.hpp"
+
+using namespace fisa;
+
+//#########################################################################################################
+/*
+  Variables
+*/
+
+// -----------------------------------------------------------------------------------
+Variables::Variables() : _size(0), _version(1)
+{
+}
+
+// -----------------------------------------------------------------------------------
+bool Variables::find(Symbol in_variable_symbol, std::size_t &out_index) const
+{
+  auto found = this->_indexes.find(in_variable_symbol);
+  if (found == this->_indexes.end()) return false;
+  out_index = found->second;
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void Variables::commit()
+{
+  for (auto it = this->_staged.begin(); it != this->_staged.end(); it++)
+    {
+      unsigned char *data = this->data(this->_slots[it->_index]._offset);
+      if (std::memcmp(data, &this->_stagedData[it->_offset], it->_size) == 0) continue;
+      std::memcpy(data, &this->_stagedData[it->_offset], it->_size);
+      this->changed(it->_index);
+    }
+  // The buffers keep their capacity for the next updates.
+  this->_staged.clear();
+  this->_stagedData.clear();
+}
+
+// -----------------------------------------------------------------------------------
+double Variables::value(std::size_t in_index) const
+{
+  const Slot &slot = this->_slots[in_index];
+  if (!slot._toDouble)
+    {
+      std::cout << "ERROR: Variables::value, variable at index " << in_index <<
+	" isn't arithmetic." << std::endl;
+      return 0.;
+    }
+  return slot._toDouble(this->data(slot._offset));
+}
+
+// -----------------------------------------------------------------------------------
+bool Variables::setValue(std::size_t in_index, double in_value)
+{
+  const Slot &slot = this->_slots[in_index];
+  if (!slot._fromDouble) return false;
+  if (slot._toDouble(this->data(slot._offset)) == in_value) return true;
+  slot._fromDouble(this->data(slot._offset), in_value);
+  this->changed(in_index);
+  return true;
+}
+
+// -----------------------------------------------------------------------------------
+void Variables::listen(std::size_t in_index, std::shared_ptr<EventListener> in_listener)
+{
+  this->_slots[in_index]._listeners.push_back(in_listener);
+}
+
+// -----------------------------------------------------------------------------------
+void Variables::changed(std::size_t in_index)
+{
+  this->_slots[in_index]._version = ++this->_version;
+
+  auto &listeners = this->_slots[in_index]._listeners;
+  auto it = listeners.begin();
+  while (it != listeners.end())
+    {
+      auto listener = it->lock();
+      if (!listener) it = listeners.erase(it);
+      else
+	{
+	  listener->changed(nullptr);
+	  it++;
+	}
+    }
+}
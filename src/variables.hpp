@@ -0,0 +1,282 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#ifndef VARIABLES_HPP
+#define VARIABLES_HPP
+
+#include "symbols.hpp"
+
+#include <cstddef> // size_t, max_align_t
+#include <cstring> // memcpy, memcmp
+#include <type_traits>
+#include <vector>
+#include <map>
+#include <memory>
+
+#include <iostream>
+
+namespace fisa
+{
+  class Event;
+
+  //! Gives a unique identifier to each type.
+  template<typename T>
+  struct TypeTag
+  {
+    static const void* id()
+    {
+      static const char tag = 0;
+      return &tag;
+    }
+  };
+
+  //#######################################################################################
+  /*  
+      EventListener
+  */
+  //! Interface of the objects notified when the triggering conditions of an event may have changed.
+  
+  class EventListener
+  {
+  public:
+    //! \private
+    virtual ~EventListener() {}
+
+    //! Called by the event specified in argument when its triggering conditions may have changed.
+    virtual void changed(const Event *in_event) = 0;
+  };
+
+  //#########################################################################################################
+  /*
+    Variables
+  */
+  //! Store of the variables of a machine (its extended state), read by events, guards and actions.
+  /**
+   * Each variable is a typed slot, and slots are laid out contiguously. A variable has a version, 
+   * which is the value of the store's version when the variable has last changed. Listeners 
+   * registered for a variable are notified when its value changes.
+   * Types of variables must be trivially copyable; arithmetic variables can be read by guards.
+   **/
+
+  class Variables
+  {
+  public:
+    //! Constructor.
+    Variables();
+
+    //! Declares a variable with the name and the initial value specified in argument, and retrieves its index.
+    /** 
+     * If the variable is already declared, its value is left unchanged. Returns false if the 
+     * variable has been declared with another type.
+     **/
+    template<typename T>
+    bool declare(Symbol in_variable_symbol, const T &in_initial_value, std::size_t &out_index)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Variables must be trivially copyable.");
+      if (this->find(in_variable_symbol, out_index)) return this->_slots[out_index]._type == TypeTag<T>::id();
+
+      Slot slot;
+      slot._offset = (this->_size + alignof(T) - 1) / alignof(T) * alignof(T);
+      slot._type = TypeTag<T>::id();
+      slot._toDouble = Conversion<T>::toDouble();
+      slot._fromDouble = Conversion<T>::fromDouble();
+      slot._version = this->_version;
+      this->_size = slot._offset + sizeof(T);
+      this->_data.resize((this->_size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+      std::memcpy(this->data(slot._offset), &in_initial_value, sizeof(T));
+      
+      out_index = this->_slots.size();
+      this->_slots.push_back(slot);
+      this->_indexes[in_variable_symbol] = out_index;
+      return true;
+    }
+
+    //! Retrieves the index of the variable with the name specified in argument. Returns false if not declared.
+    bool find(Symbol in_variable_symbol, std::size_t &out_index) const;
+
+    //! Returns true if the variable at the index specified in argument has the type T.
+    template<typename T>
+    bool isOf(std::size_t in_index) const {return this->_slots[in_index]._type == TypeTag<T>::id();}
+
+    //! Returns true if the variable at the index specified in argument has an arithmetic type.
+    bool isArithmetic(std::size_t in_index) const {return this->_slots[in_index]._toDouble != nullptr;}
+    
+    //! Returns the value of the variable of type T at the index specified in argument.
+    template<typename T>
+    T get(std::size_t in_index) const
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Variables must be trivially copyable.");
+      T value;
+      std::memcpy(&value, this->data(this->_slots[in_index]._offset), sizeof(T));
+      return value;
+    }
+
+    //! Changes the value of the variable of type T at the index specified in argument, and notifies its listeners.
+    template<typename T>
+    void set(std::size_t in_index, const T &in_value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Variables must be trivially copyable.");
+      unsigned char *data = this->data(this->_slots[in_index]._offset);
+      if (std::memcmp(data, &in_value, sizeof(T)) == 0) return;
+      std::memcpy(data, &in_value, sizeof(T));
+      this->changed(in_index);
+    }
+
+    //! Stages a value for the variable of type T at the index specified in argument, applied by "commit".
+    template<typename T>
+    void stage(std::size_t in_index, const T &in_value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Variables must be trivially copyable.");
+      Staged staged;
+      staged._index = in_index;
+      staged._offset = this->_stagedData.size();
+      staged._size = sizeof(T);
+      this->_stagedData.resize(staged._offset + sizeof(T));
+      std::memcpy(&this->_stagedData[staged._offset], &in_value, sizeof(T));
+      this->_staged.push_back(staged);
+    }
+
+    //! Applies the staged values, in the order they have been staged, and notifies the listeners.
+    void commit();
+
+    //! Returns the value, converted to double, of the arithmetic variable at the index specified in argument.
+    double value(std::size_t in_index) const;
+
+    //! Changes, from a double, the value of the arithmetic variable at the index specified in argument.
+    /** Returns false if the variable doesn't have an arithmetic type. **/
+    bool setValue(std::size_t in_index, double in_value);
+
+    //! Returns the version of the store, which is increased each time a variable changes.
+    unsigned long version() const {return this->_version;}
+
+    //! Returns the version of the store when the variable at the index specified in argument has last changed.
+    unsigned long version(std::size_t in_index) const {return this->_slots[in_index]._version;}
+
+    //! Registers a listener to notify when the variable at the index specified in argument changes.
+    void listen(std::size_t in_index, std::shared_ptr<EventListener> in_listener);
+    
+  private:
+    template<typename T, bool = std::is_arithmetic<T>::value>
+    struct Conversion
+    {
+      static double read(const unsigned char *in_data)
+      {
+	T value;
+	std::memcpy(&value, in_data, sizeof(T));
+	return static_cast<double>(value);
+      }
+      static void write(unsigned char *out_data, double in_value)
+      {
+	T value = static_cast<T>(in_value);
+	std::memcpy(out_data, &value, sizeof(T));
+      }
+      static double (*toDouble())(const unsigned char*) {return &Conversion::read;}
+      static void (*fromDouble())(unsigned char*, double) {return &Conversion::write;}
+    };
+
+    template<typename T>
+    struct Conversion<T, false>
+    {
+      static double (*toDouble())(const unsigned char*) {return nullptr;}
+      static void (*fromDouble())(unsigned char*, double) {return nullptr;}
+    };
+    
+    typedef struct
+    {
+      std::size_t _offset; // In bytes, from the beginning of the data.
+      const void *_type;
+      double (*_toDouble)(const unsigned char*);
+      void (*_fromDouble)(unsigned char*, double);
+      unsigned long _version;
+      std::vector<std::weak_ptr<EventListener> > _listeners;
+    } Slot;
+
+    typedef struct
+    {
+      std::size_t _index;
+      std::size_t _offset; // In bytes, from the beginning of the staged data.
+      std::size_t _size;
+    } Staged;
+    
+    unsigned char* data(std::size_t in_offset) {return reinterpret_cast<unsigned char*>(this->_data.data()) + in_offset;}
+    const unsigned char* data(std::size_t in_offset) const {return reinterpret_cast<const unsigned char*>(this->_data.data()) + in_offset;}
+
+    //! Updates the version of the variable at the index specified in argument and notifies its listeners.
+    void changed(std::size_t in_index);
+    
+    std::vector<std::max_align_t> _data;
+    std::size_t _size; // In bytes.
+    std::vector<Slot> _slots;
+    std::map<Symbol, std::size_t> _indexes; // {name, index}
+    unsigned long _version;
+    std::vector<Staged> _staged;
+    std::vector<unsigned char> _stagedData;
+  };
+
+  //#########################################################################################################
+  /*
+    Variable
+  */
+  //! Handle of a variable of type T in the Variables of a machine.
+  /**
+   * To create automata, handles are returned by the Machine's "declare" method. Events, guards and 
+   * actions keep handles to read and change the machine's variables.
+   **/
+
+  template<typename T>
+  class Variable
+  {
+  public:
+    //! Construct an invalid handle.
+    Variable() : _index(0) {}
+
+    //! Construct a handle of the variable at the index specified in argument.
+    Variable(std::shared_ptr<Variables> in_variables, std::size_t in_index) : _variables(in_variables), _index(in_index) {}
+
+    //! Returns true if the handle refers to a variable.
+    bool isValid() const {return this->_variables != nullptr;}
+
+    //! Returns the value of the variable.
+    T get() const {return this->_variables->template get<T>(this->_index);}
+
+    //! Changes the value of the variable, and notifies the triggers that depend on it.
+    void set(const T &in_value) const {this->_variables->template set<T>(this->_index, in_value);}
+
+    //! Returns the store of the variable.
+    std::shared_ptr<Variables> variables() const {return this->_variables;}
+
+    //! Returns the index of the variable in its store.
+    std::size_t index() const {return this->_index;}
+    
+  private:
+    std::shared_ptr<Variables> _variables;
+    std::size_t _index;
+  };
+}
+
+#endif
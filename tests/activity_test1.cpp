@@ -0,0 +1,245 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+#include <scheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class EventGo : public ChangeEvent<bool>
+{
+public:
+  EventGo() : ChangeEvent<bool>()
+  {
+    add("go", false);
+  }
+
+  bool happened() const
+  {
+    return value("go");
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name), _started(false), _released(false), _cancelled(false) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_go = std::make_shared<EventGo>();
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("working"));
+    this->addState("main", std::make_shared<SimpleState>("done"));
+    this->addState("main", std::make_shared<SimpleState>("aborted"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_working", "initial", "working"));
+    auto working_to_done = std::make_shared<Transition>("working_to_done", "working", "done");
+    working_to_done->setTrigger(std::make_shared<CompletionEvent>());
+    this->addTransition(working_to_done);
+    auto working_to_aborted = std::make_shared<Transition>("working_to_aborted", "working", "aborted");
+    working_to_aborted->setTrigger(this->_go);
+    this->addTransition(working_to_aborted);
+
+    // The do-activity works until it is released or cancelled.
+    std::atomic<bool> *started = &this->_started;
+    std::atomic<bool> *released = &this->_released;
+    std::atomic<bool> *cancelled = &this->_cancelled;
+    this->onDo("working", [started, released, cancelled](const Activity &in_activity)
+	       {
+		 *started = true;
+		 while (!*released && !in_activity.cancelled())
+		   std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		 if (in_activity.cancelled()) *cancelled = true;
+	       });
+    this->_rejected = !this->onDo("unknown", [](const Activity &) {});
+    
+    return true;
+  }
+
+  std::shared_ptr<EventGo> _go;
+  std::atomic<bool> _started;
+  std::atomic<bool> _released;
+  std::atomic<bool> _cancelled;
+  bool _rejected;
+};
+
+// Machine whose do-activity only returns once it is cancelled.
+class EndlessMachine : public Machine
+{
+public:
+  EndlessMachine(const char *in_machine_name, std::shared_ptr<std::atomic<bool> > io_returned) :
+    Machine(in_machine_name), _returned(io_returned) {}
+  virtual ~EndlessMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("working"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_working", "initial", "working"));
+
+    // The do-activity doesn't refer to the machine, which may be destroyed first.
+    auto returned = this->_returned;
+    this->onDo("working", [returned](const Activity &in_activity)
+	       {
+		 while (!in_activity.cancelled())
+		   std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		 *returned = true;
+	       });
+    return true;
+  }
+
+  std::shared_ptr<std::atomic<bool> > _returned;
+};
+
+// Runs the machine until the region "main" reaches the state specified in argument, or a timeout.
+bool waitState(MyMachine &io_machine, const char *in_state)
+{
+  for (int i = 0; i < 1000; i++)
+    {
+      io_machine.run();
+      if (io_machine.activeState("main") == in_state) return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  return false;
+}
+
+
+int main(int argv, char **args)
+{
+  // Test 1
+  // The run doesn't wait for the do-activity, the state isn't completed while it works.
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+  test1.run();
+  test1.run();
+  if (test1.activeState("main") != std::string("working") || !test1._rejected)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // The completion transition is fired once the do-activity has returned.
+  test1._released = true;
+  if (!waitState(test1, "done") || test1._cancelled)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Leaving the state cancels the do-activity, on the executor of the machine.
+  auto pool = std::make_shared<ThreadPool>(1);
+  MyMachine test2("machine2");
+  test2.setExecutor(pool);
+  test2.build();
+  test2.run();
+  for (int i = 0; i < 1000 && !test2._started; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  test2._go->switching("go", true);
+  test2.run();
+  for (int i = 0; i < 1000 && !test2._cancelled; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  if (test2.activeState("main") != std::string("aborted") || !test2._cancelled || pool->size() != 1)
+    {
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Test 4
+  // The return of the do-activity wakes the scheduler up, it doesn't wait for its timeout.
+  MyMachine test3("machine3");
+  test3.build();
+  Scheduler scheduler;
+  scheduler.add(test3);
+  std::thread releaser([&test3]()
+		       {
+			 while (!test3._started) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			 std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			 test3._released = true;
+		       });
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 3 && test3.activeState("main") != std::string("done"); i++)
+    scheduler.poll(5000);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  releaser.join();
+  if (test3.activeState("main") != std::string("done") || elapsed >= 5000)
+    {
+      std::cout << "*** main current state: " << test3.activeState("main") << ", elapsed: " << elapsed << "ms" << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Test 5
+  // Destroying the machine cancels the do-activity still running.
+  auto returned = std::make_shared<std::atomic<bool> >(false);
+  {
+    EndlessMachine test4("machine4", returned);
+    test4.build();
+    test4.run();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  for (int i = 0; i < 1000 && !*returned; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  if (!*returned)
+    {
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Activity\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class EventState1State2 : public ChangeEvent<bool>
+{
+public:
+  EventState1State2() : ChangeEvent<bool>()
+  {
+    add("a", false);
+  }
+
+  bool happened() const
+  {
+    return value("a");
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // All objects of the machine are allocated in small chunks of 1024 bytes:
+    this->useArena(1024);
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", this->create<InitialState>("initial"));
+    this->_state1 = this->create<CompositeState>("state1");
+    this->addState("main", this->_state1);
+    this->addState("main", this->create<SimpleState>("state2"));
+
+    // Transitions in region "main":
+    this->addTransition(this->create<Transition>("initial_to_state1", "initial", "state1"));
+    auto transition_state1_state2 = this->create<Transition>("state1_to_state2", "state1", "state2");
+    this->_trigger_state1_state2 = this->create<EventState1State2>();
+    transition_state1_state2->setTrigger(this->_trigger_state1_state2);
+    this->addTransition(transition_state1_state2);
+
+    // States and transitions in region "sub1" of state "state1":
+    this->_state1->newRegion("sub1");
+    this->addState("sub1", this->create<InitialState>("sub1_initial"));
+    this->addState("sub1", this->create<FinalState>("sub1_final"));
+    this->addTransition(this->create<Transition>("sub1initial_to_sub1final", "sub1_initial", "sub1_final"));
+    
+    return true;
+  }
+
+  std::shared_ptr<CompositeState> _state1;
+  std::shared_ptr<EventState1State2> _trigger_state1_state2;
+};
+
+
+int main(int argv, char **args)
+{
+  // Test 1
+  Arena arena(64);
+  void *block1 = arena.allocate(3, 1);
+  void *block2 = arena.allocate(sizeof(double), alignof(double));
+  if (reinterpret_cast<std::size_t>(block2) % alignof(double) != 0 ||
+      static_cast<char *>(block2) - static_cast<char *>(block1) > 8 ||
+      arena.chunks() != 1)
+    {
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  arena.allocate(100, 1);
+  arena.allocate(8, 8);
+  if (arena.chunks() != 3 || arena.used() != 3 + sizeof(double) + 100 + 8)
+    {
+      std::cout << "*** chunks: " << arena.chunks() << ", used: " << arena.used() << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  std::weak_ptr<EventState1State2> trigger;
+  {
+    MyMachine test("machine");
+    test.build();
+    trigger = test._trigger_state1_state2;
+    
+    // Test 3
+    if (!test.run() ||
+	test.activeState("main") != std::string("state1") ||
+	test.activeState("sub1") != std::string("sub1_final"))
+      {
+	std::cout << "*** main current state: " << test.activeState("main") << std::endl;
+	std::cout << "*** sub1 current state: " << test.activeState("sub1") << std::endl;
+	std::cout << ">>> TEST 3 FAILED" << std::endl;
+	return -1;
+      }
+
+    // Test 4
+    test._trigger_state1_state2->switching("a", true);
+    if (!test.run() ||
+	test.activeState("main") != std::string("state2"))
+      {
+	std::cout << "*** main current state: " << test.activeState("main") << std::endl;
+	std::cout << ">>> TEST 4 FAILED" << std::endl;
+	return -1;
+      }
+  }
+
+  // Test 5
+  if (!trigger.expired())
+    {
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Arena\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,285 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+#include <scheduler.hpp>
+
+#include <chrono>
+#include <string>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class EventSwitch : public ChangeEvent<bool>
+{
+public:
+  EventSwitch() : ChangeEvent<bool>()
+  {
+    add("on", false);
+  }
+
+  bool happened() const
+  {
+    return value("on");
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_go = std::make_shared<EventSwitch>();
+    this->_tick = std::make_shared<EventSwitch>();
+    
+    // Adding two regions named "main" and "other" in the machine:
+    this->newRegion("main");
+    this->newRegion("other");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<SimpleState>("sent"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_sent = std::make_shared<Transition>("idle_to_sent", "idle", "sent");
+    idle_to_sent->setTrigger(this->_go);
+    this->addTransition(idle_to_sent);
+    this->addTransition(std::make_shared<Transition>("sent_to_idle", "sent", "idle"));
+
+    // States in region "other":
+    this->addState("other", std::make_shared<InitialState>("other_initial"));
+    this->addState("other", std::make_shared<SimpleState>("other1"));
+    this->addState("other", std::make_shared<SimpleState>("other2"));
+
+    // Transitions in region "other":
+    this->addTransition(std::make_shared<Transition>("other_initial_to_other1", "other_initial", "other1"));
+    auto other1_to_other2 = std::make_shared<Transition>("other1_to_other2", "other1", "other2");
+    other1_to_other2->setTrigger(this->_tick);
+    this->addTransition(other1_to_other2);
+    auto other2_internal = std::make_shared<Transition>("other2_internal", "other2", "other2");
+    other2_internal->setKind(TransitionKind::Internal);
+    other2_internal->setTrigger(this->_tick);
+    this->addTransition(other2_internal);
+
+    // The write completes later, the acknowledgment at once.
+    std::string *trace = &this->_trace;
+    std::vector<Resume> *pending = &this->_pending;
+    this->onEffect("idle_to_sent", [trace]() {*trace += "effect idle_to_sent;";});
+    this->onAsyncEffect("idle_to_sent", [trace, pending](Resume in_resume)
+			{
+			  *trace += "write;";
+			  pending->push_back(in_resume);
+			});
+    this->onAsyncEffect("sent_to_idle", [trace](Resume in_resume)
+			{
+			  *trace += "acknowledge;";
+			  in_resume();
+			});
+    this->onEntry("sent", [trace]() {*trace += "entry sent;";});
+
+    // Transitions that don't leave their starting state can't suspend their region.
+    this->_rejected = !this->onAsyncEffect("initial_to_idle", [](Resume in_resume) {in_resume();}) &&
+      !this->onAsyncEffect("other2_internal", [](Resume in_resume) {in_resume();}) &&
+      !this->onAsyncEffect("unknown", [](Resume in_resume) {in_resume();});
+    
+    return true;
+  }
+
+  std::shared_ptr<EventSwitch> _go;
+  std::shared_ptr<EventSwitch> _tick;
+  std::string _trace;
+  std::vector<Resume> _pending;
+  bool _rejected;
+};
+
+
+int main(int argv, char **args)
+{
+  // Test 1
+  // The region is suspended while the asynchronous effect is pending.
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+  test1._go->switching("on", true);
+  test1.run();
+  test1.run();
+  if (test1.activeState("main") != std::string("") || test1._pending.size() != 1 ||
+      test1._trace != "effect idle_to_sent;write;" || !test1._rejected)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** trace: " << test1._trace << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // The other regions keep running.
+  test1._tick->switching("on", true);
+  test1.run();
+  if (test1.activeState("other") != std::string("other2") || test1.activeState("main") != std::string(""))
+    {
+      std::cout << "*** other current state: " << test1.activeState("other") << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // The effect resumes from another thread, the target is reached on the next run.
+  test1._go->switching("on", false);
+  std::thread writer(test1._pending.front());
+  writer.join();
+  test1._pending.clear();
+  test1.run();
+  if (test1.activeState("main") != std::string("sent") ||
+      test1._trace != "effect idle_to_sent;write;entry sent;")
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** trace: " << test1._trace << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // An effect that resumes at once doesn't suspend the region.
+  test1.run();
+  if (test1.activeState("main") != std::string("idle") ||
+      test1._trace != "effect idle_to_sent;write;entry sent;acknowledge;")
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** trace: " << test1._trace << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 5
+  // Frames are reused once resumed and released, a second call of Resume is ignored.
+  auto pool = std::make_shared<FramePool>();
+  auto wake_up = std::make_shared<WakeUp>();
+  int notified = 0;
+  wake_up->set([&notified]() {notified++;});
+  Frame *frame1 = pool->acquire();
+  Resume resume1(pool, frame1, wake_up);
+  resume1();
+  resume1();
+  Frame *frame2 = pool->acquire();
+  frame1->release();
+  Frame *frame3 = pool->acquire();
+  Resume resume3(pool, frame3, wake_up);
+  resume1();
+  if (frame2 == frame1 || frame3 != frame1 || frame3->isResumed() || pool->size() != 2 || notified != 1)
+    {
+      std::cout << "*** pool size: " << pool->size() << ", notified: " << notified << std::endl;
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Test 6
+  // A stale copy of a Resume doesn't resume the next suspension reusing its frame.
+  MyMachine test3("machine3");
+  test3.build();
+  test3.run();
+  test3._go->switching("on", true);
+  test3.run();
+  test3._go->switching("on", false);
+  std::vector<Resume> copies(test3._pending);
+  test3._pending.front()();
+  test3.run();
+  test3.run();
+  test3._go->switching("on", true);
+  test3.run();
+  test3._go->switching("on", false);
+  copies.front()();
+  test3.run();
+  if (test3.activeState("main") != std::string("") || test3._pending.size() != 2 ||
+      test3._trace != "effect idle_to_sent;write;entry sent;acknowledge;effect idle_to_sent;write;")
+    {
+      std::cout << "*** main current state: " << test3.activeState("main") << std::endl;
+      std::cout << "*** trace: " << test3._trace << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+  test3._pending.back()();
+  test3.run();
+  if (test3.activeState("main") != std::string("sent"))
+    {
+      std::cout << "*** main current state: " << test3.activeState("main") << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 7
+  // The effect resuming from another thread wakes the scheduler up, it doesn't wait for its timeout.
+  MyMachine test2("machine2");
+  test2.build();
+  Scheduler scheduler;
+  scheduler.add(test2);
+  test2._go->switching("on", true);
+  scheduler.reschedule(test2);
+  test2._go->switching("on", false);
+  if (test2._pending.size() != 1)
+    {
+      std::cout << "*** trace: " << test2._trace << std::endl;
+      std::cout << ">>> TEST 7 FAILED" << std::endl;
+      return -1;
+    }
+  Resume resume2 = test2._pending.front();
+  std::thread writer2([resume2]()
+		      {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			resume2();
+		      });
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 3 && test2._trace.find("acknowledge;") == std::string::npos; i++)
+    scheduler.poll(5000);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  writer2.join();
+  if (test2.activeState("main") != std::string("idle") || elapsed >= 5000 ||
+      test2._trace != "effect idle_to_sent;write;entry sent;acknowledge;")
+    {
+      std::cout << "*** main current state: " << test2.activeState("main") << ", elapsed: " << elapsed << "ms" << std::endl;
+      std::cout << "*** trace: " << test2._trace << std::endl;
+      std::cout << ">>> TEST 7 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"AsyncEffect\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,169 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class EventGo : public ChangeEvent<bool>
+{
+public:
+  EventGo() : ChangeEvent<bool>()
+  {
+    add("go", false);
+  }
+
+  bool happened() const
+  {
+    return value("go");
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_go = std::make_shared<EventGo>();
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("state1"));
+    this->addState("main", std::make_shared<SimpleState>("state2"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_state1", "initial", "state1"));
+    auto state1_to_state2 = std::make_shared<Transition>("state1_to_state2", "state1", "state2");
+    state1_to_state2->setTrigger(this->_go);
+    this->addTransition(state1_to_state2);
+
+    // Callbacks, the states and transitions are not subclassed.
+    std::string *trace = &this->_trace;
+    this->onEntry("state1", [trace]() {*trace += "entry state1;";});
+    this->onExit("state1", [trace]() {*trace += "exit state1;";});
+    this->onEffect("state1_to_state2", [trace]() {*trace += "effect state1_to_state2;";});
+    // A callable object larger than the buffer.
+    std::string text("entry state2;");
+    this->onEntry("state2", [trace, text]() {*trace += text;});
+    // Unknown states and transitions are rejected, a state isn't taken for a transition.
+    this->_rejected = !this->onEntry("state3", [trace]() {}) && !this->onEffect("state2_to_state1", [trace]() {}) &&
+      !this->onEffect("state1", [trace]() {}) && !this->onAsyncEffect("state2_to_state1", [](Resume in_resume) {in_resume();});
+    
+    return true;
+  }
+
+  std::shared_ptr<EventGo> _go;
+  std::string _trace;
+  bool _rejected;
+};
+
+
+int main(int argv, char **args)
+{
+  // Test 1
+  // Small callable objects are stored without allocation.
+  int calls = 0;
+  int *counter = &calls;
+  auto small = [counter]() {(*counter)++;};
+  double values[8] = {1., 2., 3., 4., 5., 6., 7., 8.};
+  auto large = [counter, values]() {*counter += static_cast<int>(values[7]);};
+  Callback empty;
+  Callback callback1(small);
+  Callback callback2(large);
+  Callback callback3(callback2);
+  Callback callback4(std::move(callback1));
+  callback2 = callback4;
+  callback3();
+  callback4();
+  callback2();
+  if (!Callback::isInline<decltype(small)>() || Callback::isInline<decltype(large)>() ||
+      empty || callback1 || !callback2 || calls != 10)
+    {
+      std::cout << "*** calls: " << calls << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Callbacks are moved without exception, so that growing a table doesn't copy them.
+  int copies = 0;
+  struct Counted
+  {
+    Counted(int *io_copies) : _copies(io_copies) {}
+    Counted(const Counted &in_counted) : _copies(in_counted._copies) {(*this->_copies)++;}
+    void operator () () const {}
+    int *_copies;
+    double _padding[8];
+  };
+  std::vector<Callback> table;
+  for (int i = 0; i < 100; i++)
+    table.push_back(Callback(Counted(&copies)));
+  int copied = copies;
+  Callback moved;
+  moved = std::move(table.back());
+  if (!std::is_nothrow_move_constructible<Callback>::value || !std::is_nothrow_move_assignable<Callback>::value ||
+      copied != 100 || copies != 100 || !moved || table.back())
+    {
+      std::cout << "*** copies: " << copies << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Callbacks are called after the overloadable methods, in the order of the transition firing.
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+  test1._go->switching("go", true);
+  test1.run();
+  if (test1._trace != "entry state1;exit state1;effect state1_to_state2;entry state2;" || !test1._rejected)
+    {
+      std::cout << "*** trace: " << test1._trace << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Callback\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,330 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+int level = 0;
+
+class LevelBelow : public Event
+{
+public:
+  LevelBelow(int in_limit) : _limit(in_limit), _evaluations(0) {}
+
+  bool init()
+  {
+    return true;
+  }
+
+  bool happened() const
+  {
+    this->_evaluations++;
+    return level < this->_limit;
+  }
+
+  int _limit;
+  mutable int _evaluations;
+};
+
+class EventGo : public ChangeEvent<bool>
+{
+public:
+  EventGo(const Variable<bool> &in_go, bool in_expected) : ChangeEvent<bool>(), _expected(in_expected)
+  {
+    bind("go", in_go);
+  }
+
+  bool happened() const
+  {
+    return value("go") == this->_expected;
+  }
+
+  bool _expected;
+};
+
+class RaiseLevel : public Transition
+{
+public:
+  RaiseLevel(const char *in_transition_name, const char *in_starting_state_name, const char *in_reachable_state_name) :
+    Transition(in_transition_name, in_starting_state_name, in_reachable_state_name) {}
+
+  void effect() const
+  {
+    level += 5;
+  }
+};
+
+class ChoiceMachine : public Machine
+{
+public:
+  ChoiceMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~ChoiceMachine() {}
+  
+  bool build()
+  {
+    this->_go = this->declare("go", false);
+    this->_below_20 = std::make_shared<LevelBelow>(20);
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<ChoiceState>("choice"));
+    this->addState("main", std::make_shared<SimpleState>("low"));
+    this->addState("main", std::make_shared<SimpleState>("mid"));
+    this->addState("main", std::make_shared<SimpleState>("high"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_choice = std::make_shared<RaiseLevel>("idle_to_choice", "idle", "choice");
+    idle_to_choice->setTrigger(std::make_shared<EventGo>(this->_go, true));
+    this->addTransition(idle_to_choice);
+    // The else branch is taken last, whatever the order it has been added in.
+    this->addTransition(std::make_shared<Transition>("choice_to_high", "choice", "high"));
+    auto choice_to_low = std::make_shared<Transition>("choice_to_low", "choice", "low");
+    choice_to_low->setGuard(std::make_shared<LevelBelow>(10));
+    this->addTransition(choice_to_low);
+    auto choice_to_mid = std::make_shared<Transition>("choice_to_mid", "choice", "mid");
+    choice_to_mid->setGuard(this->_below_20);
+    this->addTransition(choice_to_mid);
+    const char *states[] = {"low", "mid", "high"};
+    for (int i = 0; i < 3; i++)
+      {
+	auto to_idle = std::make_shared<Transition>((std::string(states[i]) + "_to_idle").c_str(), states[i], "idle");
+	to_idle->setTrigger(std::make_shared<EventGo>(this->_go, false));
+	this->addTransition(to_idle);
+      }
+
+    // A branch pseudostate can't have a triggered transition, nor two else branches.
+    auto triggered = std::make_shared<Transition>("triggered", "choice", "idle");
+    triggered->setTrigger(std::make_shared<EventGo>(this->_go, true));
+    this->_rejected = !this->addTransition(triggered) &&
+      !this->addTransition(std::make_shared<Transition>("choice_to_idle", "choice", "idle"));
+    
+    return true;
+  }
+
+  Variable<bool> _go;
+  std::shared_ptr<LevelBelow> _below_20;
+  bool _rejected;
+};
+
+class JunctionMachine : public Machine
+{
+public:
+  JunctionMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~JunctionMachine() {}
+  
+  bool build()
+  {
+    this->_go = this->declare("go", false);
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<JunctionState>("junction0"));
+    this->addState("main", std::make_shared<JunctionState>("junction1"));
+    this->addState("main", std::make_shared<JunctionState>("junction2"));
+    this->addState("main", std::make_shared<JunctionState>("junction3"));
+    this->addState("main", std::make_shared<SimpleState>("negative"));
+    this->addState("main", std::make_shared<SimpleState>("ready"));
+    this->addState("main", std::make_shared<SimpleState>("low"));
+    this->addState("main", std::make_shared<SimpleState>("mid"));
+    this->addState("main", std::make_shared<SimpleState>("high"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_junction0", "initial", "junction0"));
+    auto junction0_to_negative = std::make_shared<Transition>("junction0_to_negative", "junction0", "negative");
+    junction0_to_negative->setGuard(std::make_shared<LevelBelow>(0));
+    this->addTransition(junction0_to_negative);
+    this->addTransition(std::make_shared<Transition>("junction0_to_ready", "junction0", "ready"));
+
+    // The guards are evaluated before the effect of the transition reaching the junction.
+    auto ready_to_junction1 = std::make_shared<RaiseLevel>("ready_to_junction1", "ready", "junction1");
+    ready_to_junction1->setTrigger(std::make_shared<EventGo>(this->_go, true));
+    this->addTransition(ready_to_junction1);
+    auto junction1_to_low = std::make_shared<Transition>("junction1_to_low", "junction1", "low");
+    junction1_to_low->setGuard(std::make_shared<LevelBelow>(10));
+    this->addTransition(junction1_to_low);
+    this->addTransition(std::make_shared<Transition>("junction1_to_junction2", "junction1", "junction2"));
+    auto junction2_to_mid = std::make_shared<Transition>("junction2_to_mid", "junction2", "mid");
+    junction2_to_mid->setGuard(std::make_shared<LevelBelow>(20));
+    this->addTransition(junction2_to_mid);
+    this->addTransition(std::make_shared<Transition>("junction2_to_high", "junction2", "high"));
+
+    // A junction without any branch to take: the transition is not fired.
+    auto low_to_junction3 = std::make_shared<Transition>("low_to_junction3", "low", "junction3");
+    low_to_junction3->setTrigger(std::make_shared<EventGo>(this->_go, false));
+    this->addTransition(low_to_junction3);
+    auto junction3_to_negative = std::make_shared<Transition>("junction3_to_negative", "junction3", "negative");
+    junction3_to_negative->setGuard(std::make_shared<LevelBelow>(-100));
+    this->addTransition(junction3_to_negative);
+    const char *states[] = {"mid", "high"};
+    for (int i = 0; i < 2; i++)
+      {
+	auto to_ready = std::make_shared<Transition>((std::string(states[i]) + "_to_ready").c_str(), states[i], "ready");
+	to_ready->setTrigger(std::make_shared<EventGo>(this->_go, false));
+	this->addTransition(to_ready);
+      }
+    
+    return true;
+  }
+
+  Variable<bool> _go;
+};
+
+
+int main(int argv, char **args)
+{
+  ChoiceMachine test1("machine1");
+  test1.build();
+  test1.run();
+  
+  // Test 1
+  // The guards of a choice are evaluated after the effect of the reaching transition, and until one is true.
+  test1._go.set(true);
+  test1.run();
+  if (test1.activeState("main") != std::string("low") || level != 5 ||
+      test1._below_20->_evaluations != 0 || !test1._rejected)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** level: " << level << std::endl;
+      std::cout << "*** evaluations: " << test1._below_20->_evaluations << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  test1._go.set(false);
+  test1.run();
+  level = 8;
+  test1._go.set(true);
+  test1.run();
+  if (test1.activeState("main") != std::string("mid") || level != 13 || test1._below_20->_evaluations != 1)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** level: " << level << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // The else branch.
+  test1._go.set(false);
+  test1.run();
+  level = 20;
+  test1._go.set(true);
+  test1.run();
+  if (test1.activeState("main") != std::string("high") || level != 25)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** level: " << level << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // A junction reached from the initial pseudostate.
+  level = 0;
+  JunctionMachine test2("machine2");
+  test2.build();
+  test2.run();
+  if (test2.activeState("main") != std::string("ready"))
+    {
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 5
+  // The guards of a junction are evaluated before the effect of the reaching transition.
+  level = 8;
+  test2._go.set(true);
+  test2.run();
+  if (test2.activeState("main") != std::string("low") || level != 13)
+    {
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << "*** level: " << level << std::endl;
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 6
+  // No branch of the junction can be taken.
+  test2._go.set(false);
+  if (!test2.run() || test2.activeState("main") != std::string("low"))
+    {
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 7
+  // Chained junctions.
+  JunctionMachine test3("machine3");
+  test3.build();
+  test3.run();
+  level = 12;
+  test3._go.set(true);
+  test3.run();
+  if (test3.activeState("main") != std::string("mid") || level != 17)
+    {
+      std::cout << "*** main current state: " << test3.activeState("main") << std::endl;
+      std::cout << "*** level: " << level << std::endl;
+      std::cout << ">>> TEST 7 FAILED" << std::endl;
+      return -1;
+    }
+  test3._go.set(false);
+  test3.run();
+  level = 20;
+  test3._go.set(true);
+  test3.run();
+  if (test3.activeState("main") != std::string("high") || level != 25)
+    {
+      std::cout << "*** main current state: " << test3.activeState("main") << std::endl;
+      std::cout << "*** level: " << level << std::endl;
+      std::cout << ">>> TEST 7 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"ChoiceState and JunctionState\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,176 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_go = this->declare("go", false);
+    this->_ok = this->declare("ok", false);
+    auto go = this->variable(this->_go);
+    auto ok = this->variable(this->_ok);
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    auto work1 = std::make_shared<CompositeState>("work1");
+    this->addState("main", work1);
+    auto work2 = std::make_shared<CompositeState>("work2");
+    this->addState("main", work2);
+    this->addState("main", std::make_shared<SimpleState>("done"));
+    this->addState("main", std::make_shared<SimpleState>("other"));
+    this->addState("main", std::make_shared<FinalState>("final"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_work1", "initial", "work1"));
+    auto work1_to_work2 = std::make_shared<Transition>("work1_to_work2", "work1", "work2");
+    work1_to_work2->setTrigger(std::make_shared<CompletionEvent>());
+    this->addTransition(work1_to_work2);
+    auto work2_to_done = std::make_shared<Transition>("work2_to_done", "work2", "done");
+    work2_to_done->setTrigger(std::make_shared<CompletionEvent>());
+    work2_to_done->setGuard(this->guard(ok));
+    this->addTransition(work2_to_done);
+    auto work2_to_other = std::make_shared<Transition>("work2_to_other", "work2", "other");
+    work2_to_other->setTrigger(std::make_shared<SignalEvent<int> >());
+    this->addTransition(work2_to_other);
+    this->addTransition(std::make_shared<Transition>("done_to_other", "done", "other"));
+    auto done_to_final = std::make_shared<Transition>("done_to_final", "done", "final");
+    done_to_final->setTrigger(std::make_shared<CompletionEvent>());
+    this->addTransition(done_to_final);
+
+    // States and transitions in region "sub1" of state "work1":
+    work1->newRegion("sub1");
+    this->addState("sub1", std::make_shared<InitialState>("sub1_initial"));
+    this->addState("sub1", std::make_shared<SimpleState>("sub1_state1"));
+    this->addState("sub1", std::make_shared<FinalState>("sub1_final"));
+    this->addTransition(std::make_shared<Transition>("sub1initial_to_sub1state1", "sub1_initial", "sub1_state1"));
+    auto sub1state1_to_sub1final = std::make_shared<Transition>("sub1state1_to_sub1final", "sub1_state1", "sub1_final");
+    sub1state1_to_sub1final->setGuard(this->guard(go));
+    this->addTransition(sub1state1_to_sub1final);
+
+    // States and transitions in region "sub2" of state "work2":
+    work2->newRegion("sub2");
+    this->addState("sub2", std::make_shared<InitialState>("sub2_initial"));
+    this->addState("sub2", std::make_shared<SimpleState>("sub2_state1"));
+    this->addState("sub2", std::make_shared<FinalState>("sub2_final"));
+    this->addTransition(std::make_shared<Transition>("sub2initial_to_sub2state1", "sub2_initial", "sub2_state1"));
+    this->addTransition(std::make_shared<Transition>("sub2state1_to_sub2final", "sub2_state1", "sub2_final"));
+  
+    return true;
+  }
+
+  Variable<bool> _go;
+  Variable<bool> _ok;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+
+  // Test 1
+  // The composite state isn't completed.
+  test1.run();
+  if (test1.activeState("main") != std::string("work1"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // The completion transition is fired in the same run as the transition to the final pseudostate.
+  test1._go.set(true);
+  test1.run();
+  if (test1.activeState("main") != std::string("work2") ||
+      test1.activeState("sub2") != std::string("sub2_state1"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** sub2 current state: " << test1.activeState("sub2") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // The guard of the completion transition is false.
+  test1.run();
+  test1.run();
+  if (test1.activeState("main") != std::string("work2") ||
+      test1.activeState("sub2") != std::string("sub2_final"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** sub2 current state: " << test1.activeState("sub2") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // The completion transition remains activated while the state is completed, and has the priority over a signal.
+  test1._ok.set(true);
+  test1.send(1);
+  test1.run();
+  if (test1.activeState("main") != std::string("done"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 5
+  // A simple state is completed once reached, and completion transitions have the priority.
+  test1.run();
+  if (test1.activeState("main") != std::string("final"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"CompletionEvent\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,158 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_go = this->declare("go", false);
+    this->_end = this->declare("end", false);
+    auto go = this->variable(this->_go);
+    auto end = this->variable(this->_end);
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    auto work = std::make_shared<CompositeState>("work");
+    this->addState("main", work);
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto work_to_idle = std::make_shared<Transition>("work_to_idle", "work", "idle");
+    work_to_idle->setTrigger(std::make_shared<CompletionEvent>());
+    this->addTransition(work_to_idle);
+
+    // States and transitions in regions "sub1" and "sub2" of state "work":
+    work->newRegion("sub1");
+    this->addState("sub1", std::make_shared<SimpleState>("sub1_state1"));
+    this->addState("sub1", std::make_shared<FinalState>("sub1_final"));
+    auto sub1state1_to_sub1final = std::make_shared<Transition>("sub1state1_to_sub1final", "sub1_state1", "sub1_final");
+    sub1state1_to_sub1final->setGuard(this->guard(end));
+    this->addTransition(sub1state1_to_sub1final);
+    work->newRegion("sub2");
+    this->addState("sub2", std::make_shared<SimpleState>("sub2_state1"));
+    this->addState("sub2", std::make_shared<FinalState>("sub2_final"));
+    auto sub2state1_to_sub2final = std::make_shared<Transition>("sub2state1_to_sub2final", "sub2_state1", "sub2_final");
+    sub2state1_to_sub2final->setGuard(this->guard(end));
+    this->addTransition(sub2state1_to_sub2final);
+
+    // Fork from state "idle" to the regions of state "work":
+    auto fork = std::make_shared<Fork>("idle_to_work", "idle");
+    fork->addOutgoing(std::make_shared<ForkOutgoing>("sub1_state1"));
+    fork->addOutgoing(std::make_shared<ForkOutgoing>("sub2_state1"));
+    fork->setGuard(this->guard(go));
+    this->addFork("work", fork);
+  
+    return true;
+  }
+
+  Variable<bool> _go;
+  Variable<bool> _end;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+
+  // Test 1
+  // The composite state reached by the fork isn't completed.
+  test1._go.set(true);
+  test1.run();
+  test1._go.set(false);
+  test1.run();
+  if (test1.activeState("main") != std::string("work") || test1.activeState("sub1") != std::string("sub1_state1"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // The composite state is completed once its regions reach their final states.
+  test1._end.set(true);
+  test1.run();
+  test1.run();
+  if (test1.activeState("main") != std::string("idle"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Reached again by the fork, the composite state doesn't keep the count of its completed regions.
+  test1._end.set(false);
+  test1._go.set(true);
+  test1.run();
+  test1._go.set(false);
+  test1.run();
+  test1.run();
+  if (test1.activeState("main") != std::string("work") || test1.activeState("sub2") != std::string("sub2_state1"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // The composite state is completed again.
+  test1._end.set(true);
+  test1.run();
+  test1.run();
+  if (test1.activeState("main") != std::string("idle"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"CompletionEvent\" of fork SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,177 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <stream.hpp>
+
+#include <string>
+#include <memory>
+#include <vector>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+// Frames are "S<payload>E", "\" escapes the next byte of a payload, digits between frames are counted.
+class MyMachine : public StreamMachine
+{
+public:
+  MyMachine(const char *in_machine_name) : StreamMachine(in_machine_name), _digits(0), _entries(0) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<SimpleState>("payload"));
+    this->addState("main", std::make_shared<SimpleState>("escape"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_payload = std::make_shared<Transition>("idle_to_payload", "idle", "payload");
+    idle_to_payload->setTrigger(this->byteEvent(ByteClass::of('S')));
+    this->addTransition(idle_to_payload);
+    auto digit = std::make_shared<Transition>("digit", "idle", "idle");
+    digit->setKind(TransitionKind::Internal);
+    digit->setTrigger(this->byteEvent(ByteClass::range('0', '9')));
+    this->addTransition(digit);
+    auto payload_to_idle = std::make_shared<Transition>("payload_to_idle", "payload", "idle");
+    payload_to_idle->setTrigger(this->byteEvent(ByteClass::of('E')));
+    this->addTransition(payload_to_idle);
+    auto payload_to_escape = std::make_shared<Transition>("payload_to_escape", "payload", "escape");
+    payload_to_escape->setTrigger(this->byteEvent(ByteClass::of('\\')));
+    this->addTransition(payload_to_escape);
+    auto escape_to_payload = std::make_shared<Transition>("escape_to_payload", "escape", "payload");
+    escape_to_payload->setTrigger(this->byteEvent(ByteClass::any()));
+    this->addTransition(escape_to_payload);
+
+    // Slices of the payloads, digits and entries counts.
+    this->markOn("idle_to_payload");
+    std::vector<std::string> *frames = &this->_frames;
+    this->onSlice("payload_to_idle", [frames](ByteView in_slice) {frames->push_back(in_slice.toString());});
+    int *digits = &this->_digits;
+    this->onEffect("digit", [digits]() {(*digits)++;});
+    int *entries = &this->_entries;
+    this->onEntry("payload", [entries]() {(*entries)++;});
+    
+    return true;
+  }
+
+  std::vector<std::string> _frames;
+  int _digits;
+  int _entries;
+};
+
+// A machine with a transition that isn't triggered by a byte event.
+class OtherMachine : public StreamMachine
+{
+public:
+  OtherMachine(const char *in_machine_name) : StreamMachine(in_machine_name) {}
+  virtual ~OtherMachine() {}
+  
+  bool build()
+  {
+    this->newRegion("main");
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("state1"));
+    this->addState("main", std::make_shared<SimpleState>("state2"));
+    this->addTransition(std::make_shared<Transition>("initial_to_state1", "initial", "state1"));
+    this->addTransition(std::make_shared<Transition>("state1_to_state2", "state1", "state2"));
+    return true;
+  }
+};
+
+
+int main(int argv, char **args)
+{
+  // Input with long runs of bytes that fire no transition.
+  std::string input;
+  unsigned int seed = 12345;
+  const char alphabet[] = "xyzSE\\0123456789";
+  while (input.size() < 200000)
+    {
+      seed = seed * 1103515245 + 12345;
+      unsigned int value = (seed >> 16) & 0x7fff;
+      if (value % 4 == 0) input.append(value % 100, 'x');
+      else if (value % 4 == 1) input.push_back(static_cast<char>(value & 0xff));
+      else input.push_back(alphabet[value % (sizeof(alphabet) - 1)]);
+    }
+
+  MyMachine interpreted("machine1");
+  interpreted.build();
+  MyMachine scalar("machine2");
+  scalar.build();
+  MyMachine vector("machine3");
+  vector.build();
+  
+  // Test 1
+  // Only machines whose transitions are triggered by byte events are compiled.
+  OtherMachine other("machine4");
+  other.build();
+  if (!scalar.compile() || !vector.compile() || interpreted.isCompiled() || other.compile())
+    {
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+  scalar.setScan(ByteScan::Scalar);
+
+  // Test 2
+  // The compiled machines fire the same transitions as the machine run once per byte, across buffers.
+  std::size_t position = 0;
+  std::size_t chunk = 1;
+  while (position < input.size())
+    {
+      ByteView bytes = ByteView(input).slice(position, chunk);
+      interpreted.feed(bytes);
+      scalar.feed(bytes);
+      vector.feed(bytes);
+      position += bytes.size();
+      chunk = (chunk * 7 + 3) % 4096 + 1;
+    }
+  if (interpreted._frames.empty() || interpreted._digits == 0 || scalar._frames != interpreted._frames ||
+      vector._frames != interpreted._frames || scalar._digits != interpreted._digits || vector._digits != interpreted._digits ||
+      scalar._entries != interpreted._entries || vector._entries != interpreted._entries ||
+      scalar.activeState("main") != interpreted.activeState("main") || vector.activeState("main") != interpreted.activeState("main") ||
+      vector.position() != input.size())
+    {
+      std::cout << "*** frames: " << interpreted._frames.size() << ", " << scalar._frames.size() << ", " << vector._frames.size() << std::endl;
+      std::cout << "*** digits: " << interpreted._digits << ", " << scalar._digits << ", " << vector._digits << std::endl;
+      std::cout << "*** entries: " << interpreted._entries << ", " << scalar._entries << ", " << vector._entries << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Compiled StreamMachine\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
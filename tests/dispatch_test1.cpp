@@ -0,0 +1,237 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+#include <vector>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+// Counts the checks of the triggering conditions.
+class EventCounted : public ChangeEvent<bool>
+{
+public:
+  EventCounted(int &io_checks) : ChangeEvent<bool>(), _checks(io_checks)
+  {
+    add("a", false);
+  }
+
+  bool happened() const
+  {
+    this->_checks++;
+    return value("a");
+  }
+
+private:
+  int &_checks;
+};
+
+// Depends on a flag outside of the event, so it is polled.
+class EventExternal : public ChangeEvent<bool>
+{
+public:
+  EventExternal(const bool &in_flag) : ChangeEvent<bool>(), _flag(in_flag) {}
+
+  bool happened() const
+  {
+    return this->_flag;
+  }
+
+  bool isPolled() const
+  {
+    return true;
+  }
+
+private:
+  const bool &_flag;
+};
+
+// Changes all its attributes at once.
+class EventBoth : public ChangeEvent<bool>
+{
+public:
+  EventBoth() : ChangeEvent<bool>()
+  {
+    add("x", false);
+    add("y", false);
+  }
+
+  bool happened() const
+  {
+    bool is_set = true;
+    for (auto it = attributes().begin(); it != attributes().end(); it++)
+      is_set = is_set && it->second;
+    return is_set;
+  }
+
+  void setAll()
+  {
+    change([](std::map<std::string, bool> &io_attributes)
+	   {
+	     for (auto it = io_attributes.begin(); it != io_attributes.end(); it++)
+	       it->second = true;
+	   });
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name), _checks(0), _flag(false) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("state1"));
+    this->addState("main", std::make_shared<SimpleState>("state2"));
+    this->addState("main", std::make_shared<SimpleState>("state3"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_state1", "initial", "state1"));
+    for (int i = 0; i < 50; i++)
+      {
+	this->_triggers.push_back(std::make_shared<EventCounted>(this->_checks));
+	std::string name = "state1_to_state_" + std::to_string(i);
+	auto transition = std::make_shared<Transition>(name.c_str(), "state1", i < 40 ? "state2" : "state3");
+	transition->setTrigger(this->_triggers.back());
+	this->addTransition(transition);
+      }
+    auto state2_to_state1 = std::make_shared<Transition>("state2_to_state1", "state2", "state1");
+    state2_to_state1->setTrigger(this->_triggers[0]);
+    this->addTransition(state2_to_state1);
+    auto state2_to_state3 = std::make_shared<Transition>("state2_to_state3", "state2", "state3");
+    state2_to_state3->setTrigger(std::make_shared<EventExternal>(this->_flag));
+    this->addTransition(state2_to_state3);
+    this->_both = std::make_shared<EventBoth>();
+    auto state3_to_state1 = std::make_shared<Transition>("state3_to_state1", "state3", "state1");
+    state3_to_state1->setTrigger(this->_both);
+    this->addTransition(state3_to_state1);
+  
+    return true;
+  }
+
+  int _checks;
+  std::vector<std::shared_ptr<EventCounted> > _triggers;
+  bool _flag;
+  std::shared_ptr<EventBoth> _both;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+
+  // Test 1
+  // All the transitions are checked once the state has been reached.
+  test1.run();
+  if (test1._checks != 50 ||
+      test1.activeState("main") != std::string("state1"))
+    {
+      std::cout << "*** checks: " << test1._checks << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Without any change, no transition is checked.
+  test1.run();
+  test1.run();
+  if (test1._checks != 50)
+    {
+      std::cout << "*** checks: " << test1._checks << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Only the transition whose event has changed is checked.
+  test1._triggers[30]->switching("a", false);
+  test1.run();
+  if (test1._checks != 51 ||
+      test1.activeState("main") != std::string("state1"))
+    {
+      std::cout << "*** checks: " << test1._checks << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // The first activated transition, in the order they have been added, is fired.
+  test1._triggers[40]->switching("a", true);
+  test1._triggers[20]->switching("a", true);
+  test1.run();
+  if (test1.activeState("main") != std::string("state2"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Test 5
+  // A polled event is checked on each run, without any switching.
+  test1.run();
+  test1._flag = true;
+  test1.run();
+  if (test1.activeState("main") != std::string("state3"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 6
+  // Attributes changed by the subclass notify the state.
+  test1.run();
+  test1._both->setAll();
+  test1.run();
+  if (test1.activeState("main") != std::string("state1"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"SimpleState::fireTransition\" dispatch index SUCCESSED" << std::endl;
+  
+  return 0;
+}
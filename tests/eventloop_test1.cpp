@@ -0,0 +1,259 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <eventloop.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <iostream>
+
+#ifdef EPOLL_EVENT_LOOP
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+
+using namespace fisa;
+
+#ifdef EPOLL_EVENT_LOOP
+
+class EventReadable : public SignalEvent<Readiness>
+{
+public:
+  EventReadable(int in_fd) : SignalEvent<Readiness>(), _fd(in_fd) {}
+
+  bool accept(const Readiness &in_readiness) const
+  {
+    return in_readiness._fd == this->_fd && (in_readiness._events & EPOLLIN);
+  }
+
+private:
+  int _fd;
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name, int in_fd) : Machine(in_machine_name), _fd(in_fd) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<SimpleState>("reading"));
+    this->addState("main", std::make_shared<SimpleState>("timeout"));
+    this->addState("main", std::make_shared<SimpleState>("done"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_reading = std::make_shared<Transition>("idle_to_reading", "idle", "reading");
+    idle_to_reading->setTrigger(std::make_shared<EventReadable>(this->_fd));
+    this->addTransition(idle_to_reading);
+    // The delay is long enough not to elapse while the machine is run, even on a loaded host.
+    auto delay = std::make_shared<TimeEvent>();
+    delay->after(std::make_shared<DateTime>(0, 0, 0, 0, 0, 500000), std::make_shared<DateTime>(0, 0, 0, 0, 1, 0));
+    auto reading_to_timeout = std::make_shared<Transition>("reading_to_timeout", "reading", "timeout");
+    reading_to_timeout->setTrigger(delay);
+    this->addTransition(reading_to_timeout);
+    auto timeout_to_done = std::make_shared<Transition>("timeout_to_done", "timeout", "done");
+    timeout_to_done->setTrigger(std::make_shared<SignalEvent<int> >());
+    this->addTransition(timeout_to_done);
+
+    // The byte written in the pipe is read, so that the pipe isn't ready anymore.
+    int fd = this->_fd;
+    this->onEntry("reading", [fd]() {char byte; if (read(fd, &byte, 1) != 1) return;});
+    
+    return true;
+  }
+
+  int _fd;
+};
+
+class PingMachine : public Machine
+{
+public:
+  PingMachine(const char *in_machine_name) : Machine(in_machine_name), _pongs(0) {}
+  virtual ~PingMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("ping"));
+    this->addState("main", std::make_shared<SimpleState>("pong"));
+
+    // Transitions in region "main", each signal fires one transition:
+    this->addTransition(std::make_shared<Transition>("initial_to_ping", "initial", "ping"));
+    auto ping_to_pong = std::make_shared<Transition>("ping_to_pong", "ping", "pong");
+    ping_to_pong->setTrigger(std::make_shared<SignalEvent<int> >());
+    this->addTransition(ping_to_pong);
+    auto pong_to_ping = std::make_shared<Transition>("pong_to_ping", "pong", "ping");
+    pong_to_ping->setTrigger(std::make_shared<SignalEvent<int> >());
+    this->addTransition(pong_to_ping);
+
+    int *pongs = &this->_pongs;
+    this->onEntry("pong", [pongs]() {(*pongs)++;});
+    
+    return true;
+  }
+
+  int _pongs;
+};
+
+#endif
+
+
+int main(int argv, char **args)
+{
+#ifdef EPOLL_EVENT_LOOP
+  int fds[2];
+  if (pipe(fds) != 0)
+    {
+      std::cout << ">>> TEST 0 FAILED" << std::endl;
+      return -1;
+    }
+  MyMachine test1("machine1", fds[0]);
+  test1.build();
+  MyMachine test2("machine2", -1);
+  test2.build();
+  EventLoop loop;
+  loop.add(test1);
+  loop.add(test2);
+  loop.watch(fds[0], EPOLLIN, test1);
+
+  // Test 1
+  // Added machines are run once, then the loop waits.
+  int first = loop.poll(0);
+  int second = loop.poll(0);
+  if (!loop.isValid() || first != 2 || second != 0 || test1.activeState("main") != std::string("idle"))
+    {
+      std::cout << "*** polls: " << first << ", " << second << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // A ready file descriptor is sent as a signal, only the machine watching it is run.
+  char byte = 'x';
+  if (write(fds[1], &byte, 1) != 1) return -1;
+  int stepped = loop.poll(1000);
+  long long int deadline = 0;
+  long long int none = 0;
+  if (stepped != 1 || test1.activeState("main") != std::string("reading") ||
+      test2.activeState("main") != std::string("idle") || !test1.nextDeadline(deadline) || test2.nextDeadline(none))
+    {
+      std::cout << "*** stepped: " << stepped << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // The loop sleeps until the deadline of the TimeEvent.
+  stepped = loop.poll(-1);
+  long long int early = deadline - OpenSourceTime::microseconds();
+  if (stepped != 1 || test1.activeState("main") != std::string("timeout") || early > 0)
+    {
+      std::cout << "*** stepped: " << stepped << ", woken up " << early << "us before the deadline" << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // A signal posted from another thread wakes the loop up.
+  std::thread poster([&loop, &test1]()
+		     {
+		       std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		       loop.post(test1, 7);
+		     });
+  stepped = loop.poll(-1);
+  poster.join();
+  if (stepped != 1 || test1.activeState("main") != std::string("done"))
+    {
+      std::cout << "*** stepped: " << stepped << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 5
+  // The loop runs until it is stopped from another thread.
+  std::thread stopper([&loop]()
+		      {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			loop.stop();
+		      });
+  bool is_ok = loop.run();
+  stopper.join();
+  loop.remove(test1);
+  if (!is_ok || loop.unwatch(fds[0]))
+    {
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+  close(fds[0]);
+  close(fds[1]);
+
+  // Test 6
+  // A machine stopped by the step cap with signals left is run again by the next iterations.
+  PingMachine test3("machine3");
+  test3.build();
+  EventLoop capped_loop(8);
+  capped_loop.add(test3);
+  capped_loop.poll(0);
+  for (int i = 0; i < 20; i++)
+    capped_loop.post(test3, i);
+  for (int i = 0; i < 10 && (test3._pongs < 10 || test3.pendingSignals() > 0); i++)
+    capped_loop.poll(200);
+  if (test3._pongs != 10 || test3.pendingSignals() != 0 || test3.activeState("main") != std::string("ping"))
+    {
+      std::cout << "*** pongs: " << test3._pongs << ", pending signals: " << test3.pendingSignals() << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"EventLoop\" SUCCESSED" << std::endl;
+#else
+  std::cout << ">>> TESTING \"EventLoop\" SUCCESSED (not supported on this platform)" << std::endl;
+#endif
+  
+  return 0;
+}
@@ -0,0 +1,176 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class EventGo : public ChangeEvent<bool>
+{
+public:
+  EventGo() : ChangeEvent<bool>()
+  {
+    add("go", false);
+  }
+
+  bool happened() const
+  {
+    return value("go");
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    auto a = this->variable("a");
+    auto b = this->variable("b");
+    auto c = this->variable("c");
+    auto speed = this->variable("speed", 10.);
+    this->_trigger_go = std::make_shared<EventGo>();
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("state1"));
+    this->addState("main", std::make_shared<SimpleState>("state2"));
+    this->addState("main", std::make_shared<SimpleState>("state3"));
+    this->addState("main", std::make_shared<FinalState>("final"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_state1", "initial", "state1"));
+    auto state1_to_state2 = std::make_shared<Transition>("state1_to_state2", "state1", "state2");
+    state1_to_state2->setGuard(this->guard(!a && b && !c));
+    this->addTransition(state1_to_state2);
+    auto state2_to_state3 = std::make_shared<Transition>("state2_to_state3", "state2", "state3");
+    state2_to_state3->setTrigger(this->_trigger_go);
+    state2_to_state3->setGuard(this->guard(speed * 2. > b + 20.));
+    this->addTransition(state2_to_state3);
+    auto state3_to_final = std::make_shared<Transition>("state3_to_final", "state3", "final");
+    state3_to_final->setTrigger(this->guard(a && b && !c));
+    this->addTransition(state3_to_final);
+
+    this->_shared = (b && !c).node() == (b && !c).node() && (!a).node() == (!a).node();
+    return true;
+  }
+
+  std::shared_ptr<EventGo> _trigger_go;
+  bool _shared;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+  
+  // Test 1
+  // Identical sub-expressions are compiled into the same nodes.
+  if (!test1._shared)
+    {
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // The guard is false.
+  test1.run();
+  test1.run();
+  if (test1.activeState("main") != std::string("state1"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // The guard is checked again after a variable it reads has changed.
+  test1.setVariable("b", 1.);
+  test1.run();
+  if (test1.activeState("main") != std::string("state2"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // The trigger has happened but the guard is false.
+  test1._trigger_go->switching("go", true);
+  test1.setVariable("speed", 10.5);
+  test1.run();
+  if (test1.activeState("main") != std::string("state2"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 5
+  test1.setVariable("speed", 11.);
+  test1.run();
+  double speed = 0.;
+  if (test1.activeState("main") != std::string("state3") ||
+      !test1.variableValue("speed", speed) || speed != 11.)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** speed: " << speed << std::endl;
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 6
+  // A guard as trigger.
+  test1.setVariable("a", 1.);
+  test1.run();
+  if (test1.activeState("main") != std::string("final") ||
+      test1.setVariable("d", 1.))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"GuardEvent\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,217 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+// Counts the entries in the state.
+class CountedState : public SimpleState
+{
+public:
+  CountedState(const char *in_state_name, int &io_entries) : SimpleState(in_state_name), _entries(io_entries) {}
+
+  void entry() const
+  {
+    this->_entries++;
+  }
+
+private:
+  int &_entries;
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name, bool in_is_deep) :
+    Machine(in_machine_name), _isDeep(in_is_deep), _entriesSub1(0), _entriesInner1(0) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_step = this->declare("step", 0);
+    auto step = this->variable(this->_step);
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States and transitions in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    auto connected = std::make_shared<CompositeState>("connected");
+    this->addState("main", connected);
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_connected = std::make_shared<Transition>("idle_to_connected", "idle", "connected");
+    idle_to_connected->setGuard(this->guard(step == 1. || step == 7.));
+    this->addTransition(idle_to_connected);
+    auto connected_to_idle = std::make_shared<Transition>("connected_to_idle", "connected", "idle");
+    connected_to_idle->setGuard(this->guard(step == 4. || step == 6.));
+    this->addTransition(connected_to_idle);
+
+    // States and transitions in region "sub" of state "connected":
+    connected->newRegion("sub");
+    this->addState("sub", std::make_shared<InitialState>("sub_initial"));
+    if (this->_isDeep) this->addState("sub", std::make_shared<DeepHistoryState>("sub_history"));
+    else this->addState("sub", std::make_shared<ShallowHistoryState>("sub_history"));
+    this->addState("sub", std::make_shared<CountedState>("sub_state1", this->_entriesSub1));
+    auto sub_state2 = std::make_shared<CompositeState>("sub_state2");
+    this->addState("sub", sub_state2);
+    this->addTransition(std::make_shared<Transition>("subinitial_to_substate1", "sub_initial", "sub_state1"));
+    auto substate1_to_substate2 = std::make_shared<Transition>("substate1_to_substate2", "sub_state1", "sub_state2");
+    substate1_to_substate2->setGuard(this->guard(step == 2.));
+    this->addTransition(substate1_to_substate2);
+
+    // States and transitions in region "inner" of state "sub_state2":
+    sub_state2->newRegion("inner");
+    this->addState("inner", std::make_shared<InitialState>("inner_initial"));
+    this->addState("inner", std::make_shared<CountedState>("inner_state1", this->_entriesInner1));
+    this->addState("inner", std::make_shared<SimpleState>("inner_state2"));
+    this->addTransition(std::make_shared<Transition>("innerinitial_to_innerstate1", "inner_initial", "inner_state1"));
+    auto innerstate1_to_innerstate2 = std::make_shared<Transition>("innerstate1_to_innerstate2", "inner_state1", "inner_state2");
+    innerstate1_to_innerstate2->setGuard(this->guard(step == 3.));
+    this->addTransition(innerstate1_to_innerstate2);
+
+    // States in region "side" of state "connected":
+    connected->newRegion("side");
+    this->addState("side", std::make_shared<InitialState>("side_initial"));
+    this->addState("side", std::make_shared<SimpleState>("side_state1"));
+    this->addTransition(std::make_shared<Transition>("sideinitial_to_sidestate1", "side_initial", "side_state1"));
+
+    // Fork from state "idle" to the history pseudostate of region "sub":
+    auto fork = std::make_shared<Fork>("idle_to_history", "idle");
+    fork->addOutgoing(std::make_shared<ForkOutgoing>("sub_history"));
+    fork->addOutgoing(std::make_shared<ForkOutgoing>("side_state1"));
+    fork->setGuard(this->guard(step == 5.));
+    this->addFork("connected", fork);
+  
+    return true;
+  }
+
+  bool _isDeep;
+  int _entriesSub1;
+  int _entriesInner1;
+  Variable<int> _step;
+};
+
+// Enters "connected", goes to "inner_state2", leaves "connected" and enters it again by its history pseudostate.
+bool bounce(MyMachine &io_machine)
+{
+  io_machine.run();
+  for (int i = 1; i <= 5; i++)
+    {
+      io_machine._step.set(i);
+      io_machine.run();
+    }
+  return io_machine.activeState("main") == std::string("connected");
+}
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1", false);
+  test1.build();
+
+  // Test 1
+  // Shallow history restores "sub_state2", whose region is entered from its initial pseudostate.
+  if (!bounce(test1) ||
+      test1.activeState("sub") != std::string("sub_state2") ||
+      test1.activeState("inner") != std::string("inner_state1") ||
+      test1._entriesSub1 != 1 || test1._entriesInner1 != 2)
+    {
+      std::cout << "*** sub current state: " << test1.activeState("sub") << std::endl;
+      std::cout << "*** inner current state: " << test1.activeState("inner") << std::endl;
+      std::cout << "*** sub_state1 entries: " << test1._entriesSub1 << std::endl;
+      std::cout << "*** inner_state1 entries: " << test1._entriesInner1 << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  MyMachine test2("machine2", true);
+  test2.build();
+  
+  // Test 2
+  // Deep history restores "sub_state2" and "inner_state2".
+  if (!bounce(test2) ||
+      test2.activeState("sub") != std::string("sub_state2") ||
+      test2.activeState("inner") != std::string("inner_state2") ||
+      test2._entriesSub1 != 1 || test2._entriesInner1 != 1)
+    {
+      std::cout << "*** sub current state: " << test2.activeState("sub") << std::endl;
+      std::cout << "*** inner current state: " << test2.activeState("inner") << std::endl;
+      std::cout << "*** sub_state1 entries: " << test2._entriesSub1 << std::endl;
+      std::cout << "*** inner_state1 entries: " << test2._entriesInner1 << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Test 3
+  // Entered without targeting the history pseudostate, region "sub" starts from its initial pseudostate.
+  for (int i = 6; i <= 7; i++)
+    {
+      test2._step.set(i);
+      test2.run();
+    }
+  if (test2.activeState("main") != std::string("connected") ||
+      test2.activeState("sub") != std::string("sub_state1") ||
+      test2._entriesSub1 != 2 || test2._entriesInner1 != 1)
+    {
+      std::cout << "*** sub current state: " << test2.activeState("sub") << std::endl;
+      std::cout << "*** sub_state1 entries: " << test2._entriesSub1 << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  MyMachine test3("machine3", false);
+  test3.build();
+
+  // Test 4
+  // Targeted before region "sub" has ever been left, the history pseudostate enters it from its initial pseudostate.
+  test3.run();
+  test3._step.set(5);
+  test3.run();
+  if (test3.activeState("main") != std::string("connected") ||
+      test3.activeState("sub") != std::string("sub_state1") ||
+      test3.activeState("side") != std::string("side_state1") || test3._entriesSub1 != 1)
+    {
+      std::cout << "*** sub current state: " << test3.activeState("sub") << std::endl;
+      std::cout << "*** side current state: " << test3.activeState("side") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"ShallowHistoryState\" and \"DeepHistoryState\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
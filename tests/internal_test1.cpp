@@ -0,0 +1,200 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+int active_entries = 0;
+int active_exits = 0;
+int a_exits = 0;
+int b_entries = 0;
+int messages = 0;
+
+struct Message {};
+struct Reset {};
+struct Jump {};
+
+class ActiveState : public CompositeState
+{
+public:
+  ActiveState() : CompositeState("active") {}
+
+  void entry() const
+  {
+    active_entries++;
+  }
+
+  void exit() const
+  {
+    active_exits++;
+  }
+};
+
+class StateA : public SimpleState
+{
+public:
+  StateA() : SimpleState("a") {}
+
+  void exit() const
+  {
+    a_exits++;
+  }
+};
+
+class StateB : public SimpleState
+{
+public:
+  StateB() : SimpleState("b") {}
+
+  void entry() const
+  {
+    b_entries++;
+  }
+};
+
+class HandleMessage : public Transition
+{
+public:
+  HandleMessage() : Transition("handle_message", "active", "active") {}
+
+  void effect() const
+  {
+    messages++;
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    auto active = std::make_shared<ActiveState>();
+    this->addState("main", active);
+    active->newRegion("inner");
+
+    // States in region "inner":
+    this->addState("inner", std::make_shared<InitialState>("inner_initial"));
+    this->addState("inner", std::make_shared<StateA>());
+    this->addState("inner", std::make_shared<StateB>());
+
+    // Transitions:
+    this->addTransition(std::make_shared<Transition>("initial_to_active", "initial", "active"));
+    this->addTransition(std::make_shared<Transition>("inner_initial_to_a", "inner_initial", "a"));
+    auto handle_message = std::make_shared<HandleMessage>();
+    handle_message->setTrigger(std::make_shared<SignalEvent<Message> >());
+    handle_message->setKind(TransitionKind::Internal);
+    this->addTransition(handle_message);
+    auto reset = std::make_shared<Transition>("reset", "active", "active");
+    reset->setTrigger(std::make_shared<SignalEvent<Reset> >());
+    this->addTransition(reset);
+    auto jump = std::make_shared<Transition>("jump", "active", "b");
+    jump->setTrigger(std::make_shared<SignalEvent<Jump> >());
+    jump->setKind(TransitionKind::Local);
+    this->addTransition(jump);
+
+    // An internal transition must reach the state it starts from.
+    auto internal = std::make_shared<Transition>("internal", "a", "b");
+    internal->setKind(TransitionKind::Internal);
+    this->_rejected = !this->addTransition(internal);
+    
+    return true;
+  }
+
+  bool _rejected;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+  
+  // Test 1
+  // Internal transitions don't leave the state.
+  for (int i = 0; i < 3; i++)
+    {
+      test1.send(Message());
+      test1.run();
+    }
+  if (messages != 3 || active_entries != 1 || active_exits != 0 || a_exits != 0 || !test1._rejected ||
+      test1.activeState("main") != std::string("active") || test1.activeState("inner") != std::string("a"))
+    {
+      std::cout << "*** messages: " << messages << std::endl;
+      std::cout << "*** active entries: " << active_entries << ", exits: " << active_exits << std::endl;
+      std::cout << "*** inner current state: " << test1.activeState("inner") << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Local transitions don't leave the composite state.
+  test1.send(Jump());
+  test1.run();
+  if (active_entries != 1 || active_exits != 0 || a_exits != 1 || b_entries != 1 ||
+      test1.activeState("inner") != std::string("b"))
+    {
+      std::cout << "*** active entries: " << active_entries << ", exits: " << active_exits << std::endl;
+      std::cout << "*** a exits: " << a_exits << ", b entries: " << b_entries << std::endl;
+      std::cout << "*** inner current state: " << test1.activeState("inner") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // External self-transitions leave and reach again the state.
+  test1.send(Reset());
+  test1.run();
+  if (active_entries != 2 || active_exits != 1 || test1.activeState("inner") != std::string("a"))
+    {
+      std::cout << "*** active entries: " << active_entries << ", exits: " << active_exits << std::endl;
+      std::cout << "*** inner current state: " << test1.activeState("inner") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"TransitionKind\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class EventGo : public ChangeEvent<bool>
+{
+public:
+  EventGo() : ChangeEvent<bool>()
+  {
+    add("go", false);
+  }
+
+  bool happened() const
+  {
+    return value("go");
+  }
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_trigger_go = std::make_shared<EventGo>();
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    auto state1 = std::make_shared<CompositeState>("state1");
+    this->addState("main", state1);
+    this->addState("main", std::make_shared<SimpleState>("state2"));
+    this->addState("main", std::make_shared<SimpleState>("state3"));
+    this->addState("main", std::make_shared<FinalState>("final"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_state1", "initial", "state1"));
+    auto state1_to_state2 = std::make_shared<Transition>("state1_to_state2", "state1", "state2");
+    state1_to_state2->setTrigger(this->_trigger_go);
+    this->addTransition(state1_to_state2);
+    this->addTransition(std::make_shared<Transition>("state2_to_state3", "state2", "state3"));
+    this->addTransition(std::make_shared<Transition>("state3_to_final", "state3", "final"));
+
+    // States in region "sub1" of state "state1" in region "main":
+    state1->newRegion("sub1");
+    this->addState("sub1", std::make_shared<InitialState>("sub1_initial"));
+    this->addState("sub1", std::make_shared<SimpleState>("sub1_state1"));
+    this->addState("sub1", std::make_shared<SimpleState>("sub1_state2"));
+    this->addState("sub1", std::make_shared<FinalState>("sub1_final"));
+
+    // Transitions in region "sub1" of state "state1" in region "main":
+    this->addTransition(std::make_shared<Transition>("sub1initial_to_sub1state1", "sub1_initial", "sub1_state1"));
+    auto sub1state1_to_sub1state2 = std::make_shared<Transition>("sub1state1_to_sub1state2", "sub1_state1", "sub1_state2");
+    sub1state1_to_sub1state2->setTrigger(this->_trigger_go);
+    this->addTransition(sub1state1_to_sub1state2);
+    this->addTransition(std::make_shared<Transition>("sub1state2_to_sub1final", "sub1_state2", "sub1_final"));
+  
+    return true;
+  }
+
+  std::shared_ptr<EventGo> _trigger_go;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+
+  // Test 1
+  // Initialization, then no transition can be fired.
+  int steps = test1.runUntilStable(10);
+  if (steps != 1 ||
+      test1.activeState("main") != std::string("state1") ||
+      test1.activeState("sub1") != std::string("sub1_state1"))
+    {
+      std::cout << "*** microsteps: " << steps << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** sub1 current state: " << test1.activeState("sub1") << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Two microsteps inside "state1", where firing of "state1_to_state2" is not allowed, then three in region "main".
+  test1._trigger_go->switching("go", true);
+  steps = test1.runUntilStable(10);
+  if (steps != 5 ||
+      test1.activeState("main") != std::string("final"))
+    {
+      std::cout << "*** microsteps: " << steps << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  MyMachine test2("machine2");
+  test2.build();
+
+  // Test 3
+  // Limitation of the number of microsteps.
+  test2._trigger_go->switching("go", true);
+  steps = test2.runUntilStable(3);
+  if (steps != 3 ||
+      test2.activeState("main") != std::string("state1") ||
+      test2.activeState("sub1") != std::string("sub1_final"))
+    {
+      std::cout << "*** microsteps: " << steps << std::endl;
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << "*** sub1 current state: " << test2.activeState("sub1") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  steps = test2.runUntilStable(10);
+  if (steps != 3 ||
+      test2.activeState("main") != std::string("final"))
+    {
+      std::cout << "*** microsteps: " << steps << std::endl;
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Machine::runUntilStable\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+// Machine going from "idle" to "done" on the time event specified in argument.
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name, std::shared_ptr<Event> in_trigger) : Machine(in_machine_name), _trigger(in_trigger) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<SimpleState>("done"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_done = std::make_shared<Transition>("idle_to_done", "idle", "done");
+    idle_to_done->setTrigger(this->_trigger);
+    this->addTransition(idle_to_done);
+    return true;
+  }
+
+  std::shared_ptr<Event> _trigger;
+};
+
+
+int main(int argv, char **args)
+{
+  auto metrics = std::make_shared<TimeMetrics>();
+  auto delay = std::make_shared<DateTime>(0, 0, 0, 0, 0, 10000);
+  auto exceeding = std::make_shared<DateTime>(0, 0, 0, 0, 0, 1000);
+  
+  // Test 1
+  // By default, a deadline missed is skipped, counted once, and not waited for anymore.
+  auto skipped = std::make_shared<TimeEvent>();
+  skipped->after(delay, exceeding);
+  skipped->setMetrics(metrics);
+  MyMachine test1("machine1", skipped);
+  test1.build();
+  test1.run();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  test1.run();
+  test1.run();
+  long long int deadline;
+  if (skipped->missPolicy() != MissPolicy::Skip || test1.activeState("main") != std::string("idle") || metrics->_missed != 1 ||
+      metrics->_skipped != 1 || metrics->_firedLate != 0 || metrics->_maxLateness < 20000 || test1.nextDeadline(deadline))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** missed: " << metrics->_missed << ", skipped: " << metrics->_skipped << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // A deadline missed is fired late.
+  auto late = std::make_shared<TimeEvent>();
+  late->after(delay, exceeding);
+  late->setMetrics(metrics);
+  late->setMissPolicy(MissPolicy::FireLate);
+  MyMachine test2("machine2", late);
+  test2.build();
+  test2.run();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  test2.run();
+  if (test2.activeState("main") != std::string("done") || metrics->_missed != 2 || metrics->_firedLate != 1)
+    {
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // A deadline missed is fired late and its lateness reported.
+  auto reported = std::make_shared<TimeEvent>();
+  reported->after(delay, exceeding);
+  reported->setMissPolicy(MissPolicy::FireAndReport);
+  long long int lateness = 0;
+  reported->onLate([&lateness](long long int in_lateness) {lateness = in_lateness;});
+  MyMachine test3("machine3", reported);
+  test3.build();
+  test3.run();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  test3.run();
+  if (test3.activeState("main") != std::string("done") || lateness < 20000 || reported->metrics())
+    {
+      std::cout << "*** lateness: " << lateness << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // A periodic time missed is skipped, the event waits for the next one.
+  auto periodic = std::make_shared<PeriodicEvent>();
+  periodic->every(std::make_shared<DateTime>(0, 0, 0, 0, 0, 20000), std::make_shared<DateTime>(0, 0, 0, 0, 0, 5000));
+  periodic->setMetrics(metrics);
+  MyMachine test4("machine4", periodic);
+  test4.build();
+  test4.run();
+  long long int first;
+  test4.nextDeadline(first);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  test4.run();
+  if (test4.activeState("main") != std::string("idle") || metrics->_skipped != 2 || !test4.nextDeadline(deadline) ||
+      deadline <= OpenSourceTime::microseconds() - 5000 || (deadline - first) % 20000 != 0)
+    {
+      std::cout << "*** main current state: " << test4.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  for (int i = 0; i < 100 && test4.activeState("main") != std::string("done"); i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      test4.run();
+    }
+  if (test4.activeState("main") != std::string("done"))
+    {
+      std::cout << "*** main current state: " << test4.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Missed deadlines\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,223 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+struct Command
+{
+  int _speed;
+};
+
+class EventGo : public ChangeEvent<bool>
+{
+public:
+  EventGo() : ChangeEvent<bool>()
+  {
+    add("go", false);
+  }
+
+  bool happened() const
+  {
+    return value("go");
+  }
+};
+
+// Counts the checks of the guard, which is always true.
+class GuardCounted : public Event
+{
+public:
+  GuardCounted() : _checks(0) {}
+
+  bool init()
+  {
+    return true;
+  }
+
+  bool happened() const
+  {
+    this->_checks++;
+    return true;
+  }
+
+  mutable int _checks;
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name, int in_priority) : Machine(in_machine_name), _priority(in_priority) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_go = std::make_shared<EventGo>();
+    this->_guard = std::make_shared<GuardCounted>();
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("state1"));
+    this->addState("main", std::make_shared<SimpleState>("low"));
+    this->addState("main", std::make_shared<SimpleState>("high"));
+    this->addState("main", std::make_shared<SimpleState>("signal1"));
+    this->addState("main", std::make_shared<SimpleState>("signal2"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_state1", "initial", "state1"));
+    // Both transitions are triggered by the same event.
+    auto state1_to_low = std::make_shared<Transition>("state1_to_low", "state1", "low");
+    state1_to_low->setTrigger(this->_go);
+    state1_to_low->setGuard(this->_guard);
+    this->addTransition(state1_to_low);
+    auto state1_to_high = std::make_shared<Transition>("state1_to_high", "state1", "high");
+    state1_to_high->setTrigger(this->_go);
+    state1_to_high->setPriority(this->_priority);
+    this->addTransition(state1_to_high);
+    // Both transitions listen for the same type of signal.
+    auto high_to_signal1 = std::make_shared<Transition>("high_to_signal1", "high", "signal1");
+    high_to_signal1->setTrigger(std::make_shared<SignalEvent<Command> >());
+    this->addTransition(high_to_signal1);
+    auto high_to_signal2 = std::make_shared<Transition>("high_to_signal2", "high", "signal2");
+    high_to_signal2->setTrigger(std::make_shared<SignalEvent<Command> >());
+    high_to_signal2->setPriority(this->_priority);
+    this->addTransition(high_to_signal2);
+  
+    return true;
+  }
+
+  int _priority;
+  std::shared_ptr<EventGo> _go;
+  std::shared_ptr<GuardCounted> _guard;
+};
+
+
+int main(int argv, char **args)
+{
+  // Test 1
+  // The transition with the highest priority is fired, and the other one is not checked.
+  MyMachine test1("machine1", 5);
+  test1.build();
+  test1.run();
+  test1._go->switching("go", true);
+  test1.run();
+  if (test1.conflictPolicy() != ConflictPolicy::PriorityWins ||
+      test1.activeState("main") != std::string("high") || test1._guard->_checks != 0)
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** checks: " << test1._guard->_checks << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // The same for signals.
+  test1.send(Command{10});
+  test1.run();
+  if (test1.activeState("main") != std::string("signal2"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Priorities are ignored by the first-wins policy.
+  MyMachine test2("machine2", 5);
+  test2.build();
+  test2.setConflictPolicy(ConflictPolicy::FirstWins);
+  test2.run();
+  test2._go->switching("go", true);
+  test2.run();
+  test2.run();
+  if (test2.activeState("main") != std::string("low") || test2._guard->_checks != 1)
+    {
+      std::cout << "*** main current state: " << test2.activeState("main") << std::endl;
+      std::cout << "*** checks: " << test2._guard->_checks << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // No conflict between transitions of different priorities.
+  MyMachine test3("machine3", 5);
+  test3.build();
+  test3.setConflictPolicy(ConflictPolicy::ErrorOnConflict);
+  if (!test3.run())
+    {
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  test3._go->switching("go", true);
+  test3.run();
+  if (test3.activeState("main") != std::string("high"))
+    {
+      std::cout << "*** main current state: " << test3.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 5
+  // Transitions of equal priorities that may be activated at once are an error.
+  MyMachine test4("machine4", 0);
+  test4.build();
+  test4.setConflictPolicy(ConflictPolicy::ErrorOnConflict);
+  if (test4.run())
+    {
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 6
+  // Between equal priorities, the first added transition is fired.
+  MyMachine test5("machine5", 0);
+  test5.build();
+  test5.run();
+  test5._go->switching("go", true);
+  test5.run();
+  if (test5.activeState("main") != std::string("low"))
+    {
+      std::cout << "*** main current state: " << test5.activeState("main") << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Transition priorities and ConflictPolicy\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,260 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <scheduler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+// Machine whose transition from "tick" to itself is fired at each period.
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name, std::shared_ptr<PeriodicEvent> in_tick, std::vector<long long int> *io_ticks) :
+    Machine(in_machine_name), _tick(in_tick), _ticks(io_ticks), _count(0) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("tick"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_tick", "initial", "tick"));
+    auto tick_to_tick = std::make_shared<Transition>("tick_to_tick", "tick", "tick");
+    tick_to_tick->setTrigger(this->_tick);
+    this->addTransition(tick_to_tick);
+
+    // The time of the tick being fired is recorded.
+    this->onEffect("tick_to_tick", [this]()
+		   {
+		     long long int deadline;
+		     if (this->_tick->deadline(deadline)) this->_ticks->push_back(deadline);
+		     this->_count++;
+		   });
+    return true;
+  }
+
+  std::shared_ptr<PeriodicEvent> _tick;
+  std::vector<long long int> *_ticks;
+  int _count;
+};
+
+// Machine going from "ping" to "pong" and back on each signal, without deadline.
+class PingMachine : public Machine
+{
+public:
+  PingMachine(const char *in_machine_name) : Machine(in_machine_name), _pongs(0) {}
+  virtual ~PingMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("ping"));
+    this->addState("main", std::make_shared<SimpleState>("pong"));
+
+    // Transitions in region "main", each signal fires one transition:
+    this->addTransition(std::make_shared<Transition>("initial_to_ping", "initial", "ping"));
+    auto ping_to_pong = std::make_shared<Transition>("ping_to_pong", "ping", "pong");
+    ping_to_pong->setTrigger(std::make_shared<SignalEvent<int> >());
+    this->addTransition(ping_to_pong);
+    auto pong_to_ping = std::make_shared<Transition>("pong_to_ping", "pong", "ping");
+    pong_to_ping->setTrigger(std::make_shared<SignalEvent<int> >());
+    this->addTransition(pong_to_ping);
+
+    int *pongs = &this->_pongs;
+    this->onEntry("pong", [pongs]() {(*pongs)++;});
+    return true;
+  }
+
+  int _pongs;
+};
+
+
+int main(int argv, char **args)
+{
+  // Test 1
+  // Times of cron expressions.
+  CalendarEvent calendar;
+  auto exceeding = std::make_shared<DateTime>(0, 0, 0, 0, 1, 0);
+  long long int monday = DateTime(2026, 10, 19, 10, 0, 0, 0).toMicroseconds();
+  bool is_ok = calendar.every("30 14 * * *", exceeding) &&
+    calendar.next(monday) == DateTime(2026, 10, 19, 14, 30, 0, 0).toMicroseconds() &&
+    calendar.next(DateTime(2026, 10, 19, 14, 30, 0, 0).toMicroseconds()) == DateTime(2026, 10, 20, 14, 30, 0, 0).toMicroseconds();
+  is_ok = is_ok && calendar.every("0 0 29 2 *", exceeding) &&
+    calendar.next(monday) == DateTime(2028, 2, 29, 0, 0, 0, 0).toMicroseconds();
+  is_ok = is_ok && calendar.every("*/15 9-17 * * 1-5", exceeding) &&
+    calendar.next(DateTime(2026, 10, 17, 12, 0, 0, 0).toMicroseconds()) == DateTime(2026, 10, 19, 9, 0, 0, 0).toMicroseconds() &&
+    calendar.next(DateTime(2026, 10, 19, 9, 7, 30, 0).toMicroseconds()) == DateTime(2026, 10, 19, 9, 15, 0, 0).toMicroseconds();
+  // Days of month or days of week.
+  is_ok = is_ok && calendar.every("0 12 1 * 0,7", exceeding) &&
+    calendar.next(monday) == DateTime(2026, 10, 25, 12, 0, 0, 0).toMicroseconds() &&
+    calendar.next(DateTime(2026, 10, 31, 12, 0, 0, 0).toMicroseconds()) == DateTime(2026, 11, 1, 12, 0, 0, 0).toMicroseconds();
+  if (!is_ok || calendar.every("61 * * * *", exceeding) || calendar.every("* * *", exceeding) || calendar.every("1- * * * *", exceeding) ||
+      calendar.next(monday) != -1)
+    {
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Times of a periodic event counted from an origin.
+  PeriodicEvent periodic;
+  periodic.every(std::make_shared<DateTime>(0, 0, 0, 0, 0, 250000), exceeding);
+  periodic.from(std::make_shared<DateTime>(2026, 10, 19, 10, 0, 0, 0));
+  if (periodic.next(monday - 1) != monday || periodic.next(monday) != monday + 250000 || periodic.next(monday + 625000) != monday + 750000)
+    {
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Machines are queued at the first tick of their periodic event, counted from an origin.
+  // The scheduler and the events share a simulated clock, which the test moves to the deadlines.
+  const int count = 1000;
+  std::atomic<long long int> clock(DateTime(2026, 10, 19, 10, 0, 0, 0).toMicroseconds());
+  auto simulated = [&clock]() {return clock.load();};
+  long long int origin = clock + 20000;
+  std::vector<long long int> ticks;
+  std::vector<std::shared_ptr<MyMachine> > machines;
+  Scheduler scheduler;
+  scheduler.setClock(simulated);
+  for (int i = 0; i < count; i++)
+    {
+      auto tick = std::make_shared<PeriodicEvent>();
+      tick->setClock(simulated);
+      tick->every(std::make_shared<DateTime>(0, 0, 0, 0, 0, 20000 + (i % 5) * 10000), exceeding);
+      tick->from(std::make_shared<DateTime>(2026, 10, 19, 10, 0, 0, 20000));
+      machines.push_back(std::make_shared<MyMachine>("machine1", tick, &ticks));
+      machines.back()->build();
+      scheduler.add(*machines.back());
+    }
+  long long int deadline;
+  if (!scheduler.nextDeadline(deadline) || deadline != origin || !ticks.empty())
+    {
+      std::cout << "*** deadline: " << deadline << ", origin: " << origin << ", ticks: " << ticks.size() << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // Machines with different periods are run in the order of their ticks, which don't drift.
+  long long int end = origin + 200000;
+  while (scheduler.nextDeadline(deadline) && deadline <= end)
+    {
+      clock = deadline;
+      if (scheduler.dispatch() <= 0)
+	{
+	  std::cout << "*** no machine run at " << deadline - origin << std::endl;
+	  std::cout << ">>> TEST 4 FAILED" << std::endl;
+	  return -1;
+	}
+    }
+  is_ok = std::is_sorted(ticks.begin(), ticks.end());
+  for (int i = 0; i < count && is_ok; i++)
+    {
+      long long int period = 20000 + (i % 5) * 10000;
+      is_ok = machines[i]->_count == static_cast<int>(200000 / period) + 1;
+    }
+  for (auto it = ticks.begin(); it != ticks.end() && is_ok; it++)
+    is_ok = (*it - origin) % 10000 == 0;
+  if (!is_ok)
+    {
+      std::cout << "*** ticks: " << ticks.size() << ", machine 0: " << machines[0]->_count << ", machine 4: " << machines[4]->_count << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 5
+  // Removed machines are not run anymore, the scheduler runs until it is stopped from another thread.
+  for (int i = 1; i < count; i++) scheduler.remove(*machines[i]);
+  std::size_t fired = ticks.size();
+  std::atomic<bool> is_returned(false);
+  std::thread stopper([&scheduler, &clock, &is_returned]()
+		      {
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			// Several periods are late, the event is fired once then waits for its next time.
+			clock += 100000;
+			// Stopped again in case "run" was not started yet.
+			while (!is_returned)
+			  {
+			    scheduler.stop();
+			    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			  }
+		      });
+  is_ok = scheduler.run();
+  is_returned = true;
+  stopper.join();
+  scheduler.remove(*machines[0]);
+  if (!is_ok || scheduler.size() != 0 || scheduler.nextDeadline(deadline) || ticks.size() - fired != 1)
+    {
+      std::cout << "*** ticks: " << ticks.size() - fired << std::endl;
+      std::cout << ">>> TEST 5 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Test 6
+  // A machine stopped by the step cap with signals left is run again by the next dispatch.
+  PingMachine ping("ping");
+  ping.build();
+  Scheduler capped(8);
+  capped.add(ping);
+  for (int i = 0; i < 20; i++)
+    ping.send(i);
+  capped.reschedule(ping);
+  for (int i = 0; i < 10 && ping.pendingSignals() > 0; i++)
+    capped.poll(200);
+  if (ping._pongs != 10 || ping.pendingSignals() != 0 || ping.activeState("main") != std::string("ping"))
+    {
+      std::cout << "*** pongs: " << ping._pongs << ", pending signals: " << ping.pendingSignals() << std::endl;
+      std::cout << ">>> TEST 6 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Scheduler\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,185 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+struct Command
+{
+  int _speed;
+};
+
+struct Stop {};
+
+class EventCommand : public SignalEvent<Command>
+{
+public:
+  bool accept(const Command &in_command) const
+  {
+    return in_command._speed > 0;
+  }
+};
+
+class TransitionStart : public Transition
+{
+public:
+  TransitionStart(int &io_speed) : Transition("idle_to_running", "idle", "running"), _speed(io_speed) {}
+
+  void effect() const
+  {
+    this->_speed = std::static_pointer_cast<EventCommand>(this->trigger())->payload()._speed;
+  }
+
+private:
+  int &_speed;
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name), _speed(0) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding two orthogonal regions named "main" and "counter" in the machine:
+    this->newRegion("main");
+    this->newRegion("counter");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<SimpleState>("running"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_running = std::make_shared<TransitionStart>(this->_speed);
+    idle_to_running->setTrigger(std::make_shared<EventCommand>());
+    this->addTransition(idle_to_running);
+    auto running_to_idle = std::make_shared<Transition>("running_to_idle", "running", "idle");
+    running_to_idle->setTrigger(std::make_shared<SignalEvent<Stop> >());
+    this->addTransition(running_to_idle);
+
+    // States in region "counter":
+    this->addState("counter", std::make_shared<InitialState>("counter_initial"));
+    this->addState("counter", std::make_shared<SimpleState>("counter_state1"));
+    this->addState("counter", std::make_shared<SimpleState>("counter_state2"));
+
+    // Transitions in region "counter":
+    this->addTransition(std::make_shared<Transition>("counterinitial_to_counterstate1", "counter_initial", "counter_state1"));
+    auto counterstate1_to_counterstate2 = std::make_shared<Transition>("counterstate1_to_counterstate2", "counter_state1", "counter_state2");
+    counterstate1_to_counterstate2->setTrigger(std::make_shared<SignalEvent<Command> >());
+    this->addTransition(counterstate1_to_counterstate2);
+  
+    return true;
+  }
+
+  int _speed;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+
+  // Test 1
+  // Signals are queued until the initialization, "Stop" is discarded and "Command" is dispatched to both regions.
+  test1.send(Stop());
+  test1.send(Command{5});
+  int steps = test1.runUntilStable(10);
+  if (steps != 2 ||
+      test1.pendingSignals() != 0 ||
+      test1.activeState("main") != std::string("running") ||
+      test1.activeState("counter") != std::string("counter_state2") ||
+      test1._speed != 5)
+    {
+      std::cout << "*** microsteps: " << steps << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** counter current state: " << test1.activeState("counter") << std::endl;
+      std::cout << "*** speed: " << test1._speed << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Signals are dispatched one per run, in the order they have been sent.
+  test1.send(Stop());
+  test1.send(Command{7});
+  test1.run();
+  if (test1.pendingSignals() != 1 ||
+      test1.activeState("main") != std::string("idle"))
+    {
+      std::cout << "*** pending signals: " << test1.pendingSignals() << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  test1.run();
+  if (test1.pendingSignals() != 0 ||
+      test1.activeState("main") != std::string("running") ||
+      test1._speed != 7)
+    {
+      std::cout << "*** pending signals: " << test1.pendingSignals() << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** speed: " << test1._speed << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // The guard on the payload rejects the signal, which is discarded.
+  test1.send(Stop());
+  test1.send(Command{-1});
+  steps = test1.runUntilStable(10);
+  if (steps != 1 ||
+      test1.pendingSignals() != 0 ||
+      test1.activeState("main") != std::string("idle") ||
+      test1._speed != 7)
+    {
+      std::cout << "*** microsteps: " << steps << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << "*** speed: " << test1._speed << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Machine::send\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+struct Connected {};
+struct Closed {};
+
+struct Data
+{
+  int _sequence;
+};
+
+class TransitionReceive : public Transition
+{
+public:
+  TransitionReceive(std::vector<int> &io_received) : Transition("open_to_open", "open", "open"), _received(io_received) {}
+
+  void effect() const
+  {
+    this->_received.push_back(std::static_pointer_cast<SignalEvent<Data> >(this->trigger())->payload()._sequence);
+  }
+
+private:
+  std::vector<int> &_received;
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "session" in the machine:
+    this->newRegion("session");
+
+    // States in region "session", "connecting" defers the data:
+    this->addState("session", std::make_shared<InitialState>("initial"));
+    auto connecting = std::make_shared<SimpleState>("connecting");
+    connecting->defer<Data>();
+    this->addState("session", connecting);
+    this->addState("session", std::make_shared<SimpleState>("open"));
+    this->addState("session", std::make_shared<SimpleState>("closed"));
+
+    // Transitions in region "session":
+    this->addTransition(std::make_shared<Transition>("initial_to_connecting", "initial", "connecting"));
+    auto connecting_to_open = std::make_shared<Transition>("connecting_to_open", "connecting", "open");
+    connecting_to_open->setTrigger(std::make_shared<SignalEvent<Connected> >());
+    this->addTransition(connecting_to_open);
+    auto open_to_open = std::make_shared<TransitionReceive>(this->_received);
+    open_to_open->setTrigger(std::make_shared<SignalEvent<Data> >());
+    this->addTransition(open_to_open);
+    auto open_to_closed = std::make_shared<Transition>("open_to_closed", "open", "closed");
+    open_to_closed->setTrigger(std::make_shared<SignalEvent<Closed> >());
+    this->addTransition(open_to_closed);
+  
+    return true;
+  }
+
+  std::vector<int> _received;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+
+  // Test 1
+  // Data received while connecting are deferred.
+  for (int i = 0; i < 100; i++) test1.send(Data{i});
+  test1.runUntilStable(1000);
+  if (test1.activeState("session") != std::string("connecting") ||
+      test1.pendingSignals() != 0 ||
+      test1.deferredSignals() != 100 ||
+      test1._received.size() != 0)
+    {
+      std::cout << "*** session current state: " << test1.activeState("session") << std::endl;
+      std::cout << "*** deferred signals: " << test1.deferredSignals() << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Deferred data are offered again, in order and before the other signals, once connected.
+  test1.send(Connected());
+  test1.send(Closed());
+  test1.runUntilStable(1000);
+  bool is_ordered = test1._received.size() == 100;
+  for (int i = 0; i < 100 && is_ordered; i++)
+    if (test1._received[i] != i) is_ordered = false;
+  if (test1.activeState("session") != std::string("closed") ||
+      test1.pendingSignals() != 0 ||
+      test1.deferredSignals() != 0 ||
+      !is_ordered)
+    {
+      std::cout << "*** session current state: " << test1.activeState("session") << std::endl;
+      std::cout << "*** received: " << test1._received.size() << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Data received when closed are neither consumed nor deferred.
+  test1.send(Data{100});
+  test1.run();
+  if (test1.pendingSignals() != 0 ||
+      test1.deferredSignals() != 0 ||
+      test1._received.size() != 100)
+    {
+      std::cout << "*** deferred signals: " << test1.deferredSignals() << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"SimpleState::defer\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <stream.hpp>
+
+#include <string>
+#include <memory>
+#include <vector>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+// Frames are "S<payload>E", the bytes between frames are skipped.
+class MyMachine : public StreamMachine
+{
+public:
+  MyMachine(const char *in_machine_name) : StreamMachine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<SimpleState>("payload"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_payload = std::make_shared<Transition>("idle_to_payload", "idle", "payload");
+    idle_to_payload->setTrigger(this->byteEvent(ByteClass::of('S')));
+    this->addTransition(idle_to_payload);
+    auto payload_to_idle = std::make_shared<Transition>("payload_to_idle", "payload", "idle");
+    payload_to_idle->setTrigger(this->byteEvent(ByteClass::of('E')));
+    this->addTransition(payload_to_idle);
+
+    // Slices of the payloads.
+    this->markOn("idle_to_payload");
+    std::vector<std::string> *frames = &this->_frames;
+    std::vector<const unsigned char*> *addresses = &this->_addresses;
+    this->onSlice("payload_to_idle", [frames, addresses](ByteView in_slice)
+		  {
+		    frames->push_back(in_slice.toString());
+		    addresses->push_back(in_slice.data());
+		  });
+    
+    return true;
+  }
+
+  std::vector<std::string> _frames;
+  std::vector<const unsigned char*> _addresses;
+};
+
+
+int main(int argv, char **args)
+{
+  // Test 1
+  // Byte classes.
+  auto digits = ByteClass::range('0', '9');
+  auto separators = ByteClass::oneOf(",;");
+  auto others = ~(digits | separators);
+  if (!digits.contains('5') || digits.contains('a') || !separators.contains(';') || !others.contains('a') ||
+      others.contains('0') || !(digits & separators).empty() || !ByteClass::any().contains(255) ||
+      (digits | ByteClass::of('a')) == digits)
+    {
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Slices within a buffer are views over the buffer.
+  MyMachine test1("machine1");
+  test1.build();
+  std::string buffer("xxSabcEyySdE");
+  if (!test1.feed(ByteView(buffer)) || test1._frames.size() != 2 || test1._frames[0] != "abc" || test1._frames[1] != "d" ||
+      test1._addresses[0] != reinterpret_cast<const unsigned char*>(buffer.data()) + 3 ||
+      test1.activeState("main") != std::string("idle") || test1.position() != 12)
+    {
+      std::cout << "*** frames: " << test1._frames.size() << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // A slice spanning several buffers.
+  std::string *part1 = new std::string("zS12");
+  test1.feed(ByteView(*part1));
+  delete part1;
+  test1.feed(ByteView(std::string("34")));
+  test1.feed(ByteView(std::string("5E")));
+  if (test1._frames.size() != 3 || test1._frames[2] != "12345" || test1.currentByte() != -1)
+    {
+      std::cout << "*** frames: " << test1._frames.size() << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // Bytes stored in a ring buffer that wraps around.
+  RingBuffer<unsigned char> ring(8);
+  std::string text("......SringE");
+  for (std::size_t i = 0; i < 6; i++) ring.pushBack(text[i]);
+  for (std::size_t i = 0; i < 6; i++) ring.popFront();
+  for (std::size_t i = 6; i < text.size(); i++) ring.pushBack(text[i]);
+  std::size_t count;
+  ring.contiguous(0, count);
+  if (!test1.feed(ring) || count != 2 || test1._frames.size() != 4 || test1._frames[3] != "ring")
+    {
+      std::cout << "*** contiguous: " << count << ", frames: " << test1._frames.size() << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"StreamMachine\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
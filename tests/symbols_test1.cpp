@@ -0,0 +1,121 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <atomic>
+#include <string>
+#include <memory>
+#include <thread>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("state1"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_state1", "initial", "state1"));
+    return true;
+  }
+
+  // Setting the entry callback of a state that doesn't exist.
+  bool onEntryUnknown()
+  {
+    return this->onEntry("symbols_test1_unknown", []() {});
+  }
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+
+  // Test 1
+  // Searching names doesn't add them to the table.
+  std::size_t size = SymbolTable::size();
+  Symbol symbol;
+  bool is_found = SymbolTable::find("state1", symbol);
+  if (!is_found || *SymbolTable::name(symbol) != "state1" || SymbolTable::find("symbols_test1_unknown", symbol) ||
+      test1.activeState("symbols_test1_unknown") != std::string("") || test1.onEntryUnknown() ||
+      SymbolTable::size() != size)
+    {
+      std::cout << "*** size: " << size << ", " << SymbolTable::size() << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // Names are read while other names are added, across the chunks of the table.
+  std::atomic<bool> is_done(false);
+  std::atomic<bool> is_ok(true);
+  std::thread reader([&is_done, &is_ok, size]()
+		     {
+		       while (!is_done)
+			 {
+			   std::size_t count = SymbolTable::size();
+			   for (std::size_t i = size; i < count; i++)
+			     {
+			       auto name = SymbolTable::name(static_cast<Symbol>(i));
+			       if (!name || name->compare(0, 13, "symbols_test1") != 0) is_ok = false;
+			     }
+			 }
+		     });
+  for (int i = 0; i < 20000; i++) SymbolTable::intern("symbols_test1_" + std::to_string(i));
+  is_done = true;
+  reader.join();
+  for (int i = 0; i < 20000 && is_ok; i++)
+    is_ok = SymbolTable::find(("symbols_test1_" + std::to_string(i)).c_str(), symbol) &&
+      *SymbolTable::name(symbol) == "symbols_test1_" + std::to_string(i) && symbol == size + i;
+  if (!is_ok || SymbolTable::size() != size + 20000)
+    {
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"SymbolTable\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
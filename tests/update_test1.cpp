@@ -0,0 +1,146 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+struct Stop {};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_x = this->declare("x", 0);
+    this->_y = this->declare("y", 0);
+    auto x = this->variable(this->_x);
+    auto y = this->variable(this->_y);
+    
+    // Adding a region named "main" in the machine:
+    this->newRegion("main");
+
+    // States in region "main":
+    this->addState("main", std::make_shared<InitialState>("initial"));
+    this->addState("main", std::make_shared<SimpleState>("idle"));
+    this->addState("main", std::make_shared<SimpleState>("half"));
+    this->addState("main", std::make_shared<SimpleState>("full"));
+
+    // Transitions in region "main":
+    this->addTransition(std::make_shared<Transition>("initial_to_idle", "initial", "idle"));
+    auto idle_to_half = std::make_shared<Transition>("idle_to_half", "idle", "half");
+    idle_to_half->setGuard(this->guard(x == 1. && y == 0.));
+    this->addTransition(idle_to_half);
+    auto idle_to_full = std::make_shared<Transition>("idle_to_full", "idle", "full");
+    idle_to_full->setGuard(this->guard(x == 1. && y == 1.));
+    this->addTransition(idle_to_full);
+    auto full_to_idle = std::make_shared<Transition>("full_to_idle", "full", "idle");
+    full_to_idle->setTrigger(std::make_shared<SignalEvent<Stop> >());
+    full_to_idle->setGuard(this->guard(x == 0. && y == 0.));
+    this->addTransition(full_to_idle);
+  
+    return true;
+  }
+
+  Variable<int> _x;
+  Variable<int> _y;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+
+  // Test 1
+  // Values are staged until the update is committed.
+  test1.beginUpdate();
+  test1.set(test1._x, 1);
+  test1.set(test1._y, 1);
+  if (test1._x.get() != 0 || test1._y.get() != 0)
+    {
+      std::cout << "*** x: " << test1._x.get() << std::endl;
+      std::cout << "*** y: " << test1._y.get() << std::endl;
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // All values are applied before the transitions are checked.
+  if (!test1.commitUpdate() ||
+      test1._x.get() != 1 || test1._y.get() != 1 ||
+      test1.activeState("main") != std::string("full"))
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  // Signals and values of the same update, the last staged value wins.
+  test1.beginUpdate();
+  test1.set(test1._x, 0);
+  test1.set(test1._y, 5);
+  test1.send(Stop());
+  test1.set(test1._y, 0);
+  if (!test1.commitUpdate() ||
+      test1._y.get() != 0 ||
+      test1.activeState("main") != std::string("idle"))
+    {
+      std::cout << "*** y: " << test1._y.get() << std::endl;
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // Outside an update, values are applied at once.
+  test1.set(test1._x, 1);
+  test1.run();
+  if (test1.activeState("main") != std::string("half") || test1.commitUpdate())
+    {
+      std::cout << "*** main current state: " << test1.activeState("main") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Machine::commitUpdate\" SUCCESSED" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,214 @@
+/*                                                                                    
+*  FInite State Automata library                                                     
+*                                                                                    
+*  Copyright (c) 2015, Jean Ahmad (https://www.linkedin.com/in/jeanahmad)                 
+*  All rights reserved.                                                              
+*                                                                                    
+*  Redistribution and use in source and binary forms, with or without modification,  
+*  are permitted provided that the following conditions are met:                     
+*                                                                                    
+*  - Redistributions of source code must retain the above copyright notice, this     
+*  list of conditions and the following disclaimer.                                  
+*                                                                                    
+*  - Redistributions in binary form must reproduce the above copyright notice, this  
+*  list of conditions and the following disclaimer in the documentation and/or       
+*  other materials provided with the distribution.                                   
+*                                                                                    
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND   
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED     
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE            
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR  
+*  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    
+*  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;      
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON    
+*  ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT           
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS     
+*  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                      
+*/                                                                                  
+
+#include <machine.hpp>
+
+#include <string>
+#include <memory>
+
+#include <iostream>
+
+
+using namespace fisa;
+
+struct Position
+{
+  int _x;
+  int _y;
+};
+
+class EventOpened : public ChangeEvent<bool>
+{
+public:
+  EventOpened(const Variable<bool> &in_opened) : ChangeEvent<bool>()
+  {
+    bind("opened", in_opened);
+  }
+
+  bool happened() const
+  {
+    return value("opened");
+  }
+};
+
+class EventClosed : public ChangeEvent<bool>
+{
+public:
+  EventClosed(const Variable<bool> &in_opened) : ChangeEvent<bool>()
+  {
+    bind("opened", in_opened);
+  }
+
+  bool happened() const
+  {
+    return !value("opened");
+  }
+};
+
+class TransitionMove : public Transition
+{
+public:
+  TransitionMove(const Variable<Position> &in_position, const Variable<int> &in_count) :
+    Transition("door_closed_to_door_opened", "door_closed", "door_opened"), _position(in_position), _count(in_count) {}
+
+  void effect() const
+  {
+    Position position = this->_position.get();
+    position._x++;
+    this->_position.set(position);
+    this->_count.set(this->_count.get() + 1);
+  }
+
+private:
+  Variable<Position> _position;
+  Variable<int> _count;
+};
+
+class MyMachine : public Machine
+{
+public:
+  MyMachine(const char *in_machine_name) : Machine(in_machine_name) {}
+  virtual ~MyMachine() {}
+  
+  bool build()
+  {
+    this->_opened = this->declare("opened", false);
+    this->_count = this->declare("count", 0);
+    this->_position = this->declare("position", Position{0, 0});
+    this->_ratio = this->declare("ratio", 0.5);
+    this->_mismatch = this->declare("count", 0.);
+    
+    // Adding two orthogonal regions named "door" and "lamp" in the machine:
+    this->newRegion("door");
+    this->newRegion("lamp");
+
+    // States and transitions in region "door":
+    this->addState("door", std::make_shared<InitialState>("door_initial"));
+    this->addState("door", std::make_shared<SimpleState>("door_closed"));
+    this->addState("door", std::make_shared<SimpleState>("door_opened"));
+    this->addState("door", std::make_shared<FinalState>("door_final"));
+    this->addTransition(std::make_shared<Transition>("doorinitial_to_doorclosed", "door_initial", "door_closed"));
+    auto door_closed_to_door_opened = std::make_shared<TransitionMove>(this->_position, this->_count);
+    door_closed_to_door_opened->setTrigger(std::make_shared<EventOpened>(this->_opened));
+    this->addTransition(door_closed_to_door_opened);
+    auto door_opened_to_door_closed = std::make_shared<Transition>("door_opened_to_door_closed", "door_opened", "door_closed");
+    door_opened_to_door_closed->setTrigger(std::make_shared<EventClosed>(this->_opened));
+    this->addTransition(door_opened_to_door_closed);
+    auto door_closed_to_door_final = std::make_shared<Transition>("door_closed_to_door_final", "door_closed", "door_final");
+    door_closed_to_door_final->setGuard(this->guard(this->variable(this->_count) >= 2.));
+    this->addTransition(door_closed_to_door_final);
+
+    // States and transitions in region "lamp":
+    this->addState("lamp", std::make_shared<InitialState>("lamp_initial"));
+    this->addState("lamp", std::make_shared<SimpleState>("lamp_off"));
+    this->addState("lamp", std::make_shared<SimpleState>("lamp_on"));
+    this->addTransition(std::make_shared<Transition>("lampinitial_to_lampoff", "lamp_initial", "lamp_off"));
+    auto lamp_off_to_lamp_on = std::make_shared<Transition>("lamp_off_to_lamp_on", "lamp_off", "lamp_on");
+    lamp_off_to_lamp_on->setTrigger(std::make_shared<EventOpened>(this->_opened));
+    this->addTransition(lamp_off_to_lamp_on);
+    auto lamp_on_to_lamp_off = std::make_shared<Transition>("lamp_on_to_lamp_off", "lamp_on", "lamp_off");
+    lamp_on_to_lamp_off->setTrigger(std::make_shared<EventClosed>(this->_opened));
+    this->addTransition(lamp_on_to_lamp_off);
+  
+    return true;
+  }
+
+  Variable<bool> _opened;
+  Variable<int> _count;
+  Variable<Position> _position;
+  Variable<double> _ratio;
+  Variable<double> _mismatch;
+};
+
+
+int main(int argv, char **args)
+{
+  MyMachine test1("machine1");
+  test1.build();
+  test1.run();
+
+  // Test 1
+  // Typed variables and handles.
+  if (!test1._opened.isValid() || test1._mismatch.isValid() ||
+      test1._count.get() != 0 || test1._ratio.get() != 0.5 ||
+      test1._position.get()._x != 0 || test1._position.get()._y != 0)
+    {
+      std::cout << ">>> TEST 1 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 2
+  // One variable update triggers the events bound to it in both regions.
+  test1._opened.set(true);
+  test1.run();
+  if (test1.activeState("door") != std::string("door_opened") ||
+      test1.activeState("lamp") != std::string("lamp_on") ||
+      test1._count.get() != 1 || test1._position.get()._x != 1)
+    {
+      std::cout << "*** door current state: " << test1.activeState("door") << std::endl;
+      std::cout << "*** lamp current state: " << test1.activeState("lamp") << std::endl;
+      std::cout << "*** count: " << test1._count.get() << std::endl;
+      std::cout << ">>> TEST 2 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 3
+  test1._opened.set(false);
+  test1.run();
+  test1._opened.set(true);
+  test1.run();
+  test1._opened.set(false);
+  test1.run();
+  if (test1.activeState("door") != std::string("door_closed") ||
+      test1.activeState("lamp") != std::string("lamp_off") ||
+      test1._count.get() != 2 || test1._position.get()._x != 2)
+    {
+      std::cout << "*** door current state: " << test1.activeState("door") << std::endl;
+      std::cout << "*** lamp current state: " << test1.activeState("lamp") << std::endl;
+      std::cout << "*** count: " << test1._count.get() << std::endl;
+      std::cout << ">>> TEST 3 FAILED" << std::endl;
+      return -1;
+    }
+
+  // Test 4
+  // A guard reading a variable changed by an action.
+  test1.run();
+  double count = 0.;
+  if (test1.activeState("door") != std::string("door_final") ||
+      !test1.variableValue("count", count) || count != 2.)
+    {
+      std::cout << "*** door current state: " << test1.activeState("door") << std::endl;
+      std::cout << ">>> TEST 4 FAILED" << std::endl;
+      return -1;
+    }
+  
+  // Result
+  std::cout << ">>> TESTING \"Variables\" SUCCESSED" << std::endl;
+  
+  return 0;
+}